@@ -0,0 +1,334 @@
+// CPU-side benchmarks. GL calls go to the stubs in GLMock, so the rendering cases measure
+// only what the CPU spends building and submitting a frame. Run from the build directory
+// (like the game), so that ../res resolves.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/framework/allocCounter.h"
+#include "../src/framework/glMock.h"
+#include "../src/framework/renderer.h"
+#include "../src/framework/fontRenderer.h"
+#include "../src/framework/shaderManager.h"
+#include "../src/framework/skylinePacker.h"
+#include "../src/framework/spriteRenderer.h"
+#include "../src/game/board.h"
+#include "../src/game/game.h"
+#include "../src/game/modBoard.h"
+#include "../src/game/symmetry.h"
+#include "../src/shapes/collision.h"
+#include "../src/shapes/rect.h"
+
+using namespace std;
+
+namespace {
+const char *RECT_VERT = "../res/shaders/rect.vert", *RECT_FRAG = "../res/shaders/rect.frag";
+const char *TEXT_VERT = "../res/shaders/text.vert", *TEXT_FRAG = "../res/shaders/text.frag";
+const char *SPRITE_VERT = "../res/shaders/sprite.vert", *SPRITE_FRAG = "../res/shaders/sprite.frag";
+const char *FONT = "../res/fonts/MxPlus_IBM_BIOS.ttf";
+
+/// @brief Installs the GL stubs once, before the first case that needs them
+void useMock() {
+    static bool installed = false;
+    if (!installed) {
+        GLMock::install();
+        installed = true;
+    }
+}
+
+/// @brief Reports the GL work of the timed loop per iteration
+void reportGL(benchmark::State &state) {
+    const GLMock::Counts &counts = GLMock::getCounts();
+    auto perIteration = benchmark::Counter::kAvgIterations;
+    state.counters["glCalls"] = benchmark::Counter(static_cast<double>(counts.calls), perIteration);
+    state.counters["draws"] = benchmark::Counter(static_cast<double>(counts.draws), perIteration);
+    state.counters["uploadBytes"] = benchmark::Counter(static_cast<double>(counts.uploadedBytes), perIteration);
+}
+
+/// @brief Moves a new game on to the play screen
+void startPlaying(Game &game) {
+    InputState input;
+    input.keyStart = true;
+    game.processInput(input);
+    game.update(1.0f / 120.0f);
+}
+}
+
+// -----------------------------------
+// Game logic
+// -----------------------------------
+
+static void BM_BoardPress(benchmark::State &state) {
+    const int size = static_cast<int>(state.range(0));
+    Board board(size, size);
+    mt19937 rng(1);
+    vector<int> presses(4096);
+    for (int &press : presses) { press = static_cast<int>(rng() % board.getCellCount()); }
+
+    size_t ii = 0;
+    for (auto _ : state) {
+        int cell = presses[ii++ & 4095];
+        board.press(cell % size, cell / size);
+    }
+    benchmark::DoNotOptimize(board.litCount());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardPress)->Arg(5)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_BoardWinCheck(benchmark::State &state) {
+    // Worst case: only the last cell is lit, so every word has to be looked at
+    const int size = static_cast<int>(state.range(0));
+    Board board(size, size);
+    board.fill(false);
+    board.setLit(size - 1, size - 1, true);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(board.allOff());
+    }
+    state.SetItemsProcessed(state.iterations() * board.getCellCount());
+}
+BENCHMARK(BM_BoardWinCheck)->Arg(5)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_BoardApplyPresses(benchmark::State &state) {
+    // A random half of the lights pressed at once (what scramble() does)
+    const int size = static_cast<int>(state.range(0));
+    Board board(size, size), presses(size, size);
+    presses.fill(false);
+    presses.scramble(1);
+
+    for (auto _ : state) {
+        board.applyPresses(presses);
+    }
+    benchmark::DoNotOptimize(board.allOff());
+    state.SetItemsProcessed(state.iterations() * board.getCellCount());
+    state.SetLabel(boardKernelName());
+}
+BENCHMARK(BM_BoardApplyPresses)->Arg(64)->Arg(1024)->Arg(4096);
+
+static void BM_ModBoardApplyPresses(benchmark::State &state) {
+    // A whole board of presses (every light pressed 0 to 2 times) on a 3-state board
+    const int size = static_cast<int>(state.range(0));
+    ModBoard board(size, size, 3), presses(size, size, 3);
+    presses.scramble(1);
+
+    for (auto _ : state) {
+        board.applyPresses(presses);
+    }
+    benchmark::DoNotOptimize(board.allOff());
+    state.SetItemsProcessed(state.iterations() * board.getCellCount());
+    state.SetLabel(modBoardKernelName());
+}
+BENCHMARK(BM_ModBoardApplyPresses)->Arg(5)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_CanonicalHash(benchmark::State &state) {
+    // Up to 8x8 is one word; bigger boards build their 8 images
+    const int size = static_cast<int>(state.range(0));
+    Board board(size, size);
+    board.fill(false);
+    board.scramble(1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(canonicalHash(board));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CanonicalHash)->Arg(7)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_WriteSnapshot(benchmark::State &state) {
+    // The simulation writes into the three snapshots of the triple buffer in turn; once each holds the
+    // board, a step without presses copies no rows at all
+    const int size = static_cast<int>(state.range(0));
+    Game game(vec2(1300, 960), size, size, static_cast<int>(state.range(1)));
+    startPlaying(game);
+    GameSnapshot snapshots[3];
+    for (GameSnapshot &snapshot : snapshots) { game.writeSnapshot(snapshot); }
+
+    size_t ii = 0;
+    for (auto _ : state) {
+        game.writeSnapshot(snapshots[ii++ % 3]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteSnapshot)->Args({1024, 2})->Args({8192, 2})->Args({8192, 3});
+
+// -----------------------------------
+// Collision
+// -----------------------------------
+
+static void BM_OverlapAABBs(benchmark::State &state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    mt19937 rng(1);
+    uniform_real_distribution<float> position(0.0f, 10000.0f), extent(1.0f, 20.0f);
+    vector<float> posX(count), posY(count), sizeX(count), sizeY(count);
+    for (size_t ii = 0; ii < count; ii++) {
+        posX[ii] = position(rng);
+        posY[ii] = position(rng);
+        sizeX[ii] = extent(rng);
+        sizeY[ii] = extent(rng);
+    }
+    AABBArrays boxes{posX.data(), posY.data(), sizeX.data(), sizeY.data(), count};
+    vector<uint8_t> hits(count);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(overlapAABBs(vec2(5000, 5000), vec2(500, 500), boxes, hits.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(collisionKernelName());
+}
+BENCHMARK(BM_OverlapAABBs)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_OverlapCircles(benchmark::State &state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    mt19937 rng(1);
+    uniform_real_distribution<float> position(0.0f, 10000.0f), radius(1.0f, 10.0f);
+    vector<float> posX(count), posY(count), radii(count);
+    for (size_t ii = 0; ii < count; ii++) {
+        posX[ii] = position(rng);
+        posY[ii] = position(rng);
+        radii[ii] = radius(rng);
+    }
+    CircleArrays circles{posX.data(), posY.data(), radii.data(), count};
+    vector<uint8_t> hits(count);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(overlapCircles(vec2(5000, 5000), 250.0f, circles, hits.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(collisionKernelName());
+}
+BENCHMARK(BM_OverlapCircles)->Arg(1 << 10)->Arg(1 << 20);
+
+// -----------------------------------
+// Rendering (CPU side, mock GL)
+// -----------------------------------
+
+static void BM_TextLayout(benchmark::State &state) {
+    useMock();
+    ShaderManager shaders;
+    shaders.loadShader(TEXT_VERT, TEXT_FRAG, nullptr, "text");
+    StreamBuffer stream;
+    FontRenderer fontRenderer(shaders.getShader("text"), stream, FONT, 24);
+    const string line(static_cast<size_t>(state.range(0)), 'W');
+
+    GLMock::reset();
+    for (auto _ : state) {
+        stream.beginFrame();
+        fontRenderer.renderText(line, 10, 10, 1, vec3(1, 1, 1));
+        stream.endFrame();
+    }
+    reportGL(state);
+    state.SetItemsProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_TextLayout)->Arg(8)->Arg(40)->Arg(200);
+
+static void BM_ShapeSetUniforms(benchmark::State &state) {
+    useMock();
+    ShaderManager shaders;
+    // The rect shader without INSTANCED draws one shape at a time
+    shaders.loadShader(RECT_VERT, RECT_FRAG, nullptr, "shape");
+    Rect rect(shaders.getShader("shape"), vec2(100, 100), vec2(50, 50), YELLOW);
+
+    GLMock::reset();
+    for (auto _ : state) {
+        rect.setUniforms();
+    }
+    reportGL(state);
+}
+BENCHMARK(BM_ShapeSetUniforms);
+
+static void BM_ShaderManagerLoad(benchmark::State &state) {
+    // File reads and preprocessing plus the (stubbed) compile and link
+    useMock();
+    ShaderManager shaders;
+
+    GLMock::reset();
+    for (auto _ : state) {
+        shaders.loadShader(RECT_VERT, RECT_FRAG, nullptr, "rect", {"INSTANCED"});
+    }
+    reportGL(state);
+}
+BENCHMARK(BM_ShaderManagerLoad);
+
+static void BM_SpriteBatch(benchmark::State &state) {
+    // A skinned grid: every light is a sprite from the same atlas page
+    useMock();
+    ShaderManager shaders;
+    shaders.loadShader(SPRITE_VERT, SPRITE_FRAG, nullptr, "sprite", {"INSTANCED"});
+    StreamBuffer stream;
+    SpriteRenderer sprites(shaders.getShader("sprite"), stream);
+    const int size = static_cast<int>(state.range(0));
+    Sprite lit{1, glm::vec4(0, 0, 0.5f, 0.5f), 128, 128}, off{1, glm::vec4(0.5f, 0, 1, 0.5f), 128, 128};
+
+    GLMock::reset();
+    for (auto _ : state) {
+        stream.beginFrame();
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                sprites.add((x + y) & 1 ? lit : off, vec2(x * 150, y * 150), vec2(140, 140), 0xffffffffu);
+            }
+        }
+        sprites.flush();
+        stream.endFrame();
+    }
+    reportGL(state);
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_SpriteBatch)->Arg(5)->Arg(64);
+
+static void BM_SkylinePack(benchmark::State &state) {
+    // Random sprite sizes into 2048x2048 pages, starting a new page whenever one is full
+    mt19937 rng(7);
+    vector<pair<int, int>> sizes(static_cast<size_t>(state.range(0)));
+    for (auto &[width, height] : sizes) {
+        width = 8 + static_cast<int>(rng() % 120);
+        height = 8 + static_cast<int>(rng() % 120);
+    }
+    size_t pages = 0;
+    for (auto _ : state) {
+        vector<SkylinePacker> packers;
+        for (const auto &[width, height] : sizes) {
+            int x, y;
+            size_t page = 0;
+            while (page < packers.size() && !packers[page].pack(width, height, x, y)) { page++; }
+            if (page == packers.size()) {
+                packers.emplace_back(2048, 2048);
+                packers.back().pack(width, height, x, y);
+            }
+        }
+        pages = packers.size();
+        benchmark::DoNotOptimize(packers.data());
+    }
+    state.counters["pages"] = static_cast<double>(pages);
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_SkylinePack)->Arg(256)->Arg(4096);
+
+static void BM_FrameSubmission(benchmark::State &state) {
+    // Renderer::render is Engine::render minus the buffer swap
+    useMock();
+    const int size = static_cast<int>(state.range(0));
+    Game game(vec2(1300, 960), size, size);
+    startPlaying(game);
+    GameSnapshot snapshot;
+    game.writeSnapshot(snapshot);
+    Renderer renderer(1300, 960, game.getLayout(), snapshot.board);
+
+    // Warm up first: steady-state frames shouldn't touch the heap at all
+    renderer.render(snapshot);
+    GLMock::reset();
+    size_t allocations = AllocCounter::thisThread().allocations;
+    for (auto _ : state) {
+        renderer.render(snapshot);
+    }
+    allocations = AllocCounter::thisThread().allocations - allocations;
+    reportGL(state);
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * snapshot.board.getCellCount());
+}
+BENCHMARK(BM_FrameSubmission)->Arg(5)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+BENCHMARK_MAIN();
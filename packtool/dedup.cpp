@@ -0,0 +1,220 @@
+#include "dedup.h"
+#include "../src/game/symmetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace {
+/// @brief A puzzle in a shard: its canonical word (boards up to 8x8) or canonical hash, and where it is in the pack
+struct Entry {
+    uint64_t key;
+    uint64_t index;
+};
+
+const uint64_t EMPTY = ~uint64_t(0);
+/// @brief Puzzles per task of the hashing pass, and the most hashed per batch
+const size_t PUZZLES_PER_TASK = 1 << 14;
+const size_t MAX_BATCH = 1 << 20;
+/// @brief Entries collected per shard before they are written to its file: at most MAX, fewer to stay in
+/// the memory budget, but no fewer than MIN (fewer shards are open at once instead)
+const size_t MAX_SHARD_BUFFER = 4096;
+const size_t MIN_SHARD_BUFFER = 64;
+/// @brief Upper bound on the shard files open at once, and the descriptors left for everything else
+const size_t MAX_OPEN_SHARDS = 256;
+const size_t RESERVED_FILES = 16;
+/// @brief Memory per entry in the second pass: a hash set at most half full is 2 to 4 slots per entry, and
+/// while one doubles the old table is still there (the worst case, just past half full: 2 + 4 slots)
+const size_t BYTES_PER_ENTRY = 6 * sizeof(Entry);
+
+/// @brief Spreads a key over the word: canonical words have most of their bits in the same places
+uint64_t spread(uint64_t key, bool small) {
+    return small ? mixHash(key) : key;
+}
+
+/// @brief Compares the canonical images of two puzzles (only needed when their hashes match)
+bool sameClass(const PuzzlePack &pack, uint64_t a, uint64_t b) {
+    Board canonicalA, canonicalB;
+    canonicalizeBoard(pack.get(a), canonicalA);
+    canonicalizeBoard(pack.get(b), canonicalB);
+    return canonicalA == canonicalB;
+}
+
+/// @brief The first slot to probe for a key (the low bits of its hash: the shard took the top ones)
+size_t findSlot(const vector<Entry> &table, uint64_t key, bool small) {
+    return static_cast<size_t>(spread(key, small)) & (table.size() - 1);
+}
+
+/// @brief Doubles a hash set (its size is a power of two)
+void grow(vector<Entry> &table, bool small) {
+    vector<Entry> bigger(2 * table.size(), Entry{0, EMPTY});
+    for (const Entry &entry : table) {
+        if (entry.index == EMPTY) { continue; }
+        size_t slot = findSlot(bigger, entry.key, small);
+        while (bigger[slot].index != EMPTY) { slot = (slot + 1) & (bigger.size() - 1); }
+        bigger[slot] = entry;
+    }
+    table.swap(bigger);
+}
+
+/// @brief Number of shard files that may be open at once
+size_t fileBudget() {
+#ifdef _WIN32
+    size_t limit = static_cast<size_t>(_getmaxstdio());
+#else
+    rlimit limits{};
+    size_t limit = getrlimit(RLIMIT_NOFILE, &limits) == 0 && limits.rlim_cur != RLIM_INFINITY
+                   ? static_cast<size_t>(limits.rlim_cur) : MAX_OPEN_SHARDS + RESERVED_FILES;
+#endif
+    return clamp<size_t>(limit > RESERVED_FILES ? limit - RESERVED_FILES : 1, 1, MAX_OPEN_SHARDS);
+}
+
+/// @brief Frees a vector's storage (clear() keeps it)
+void release(vector<Entry> &entries) {
+    vector<Entry>().swap(entries);
+}
+}
+
+bool dedupPack(const PuzzlePack &pack, const string &path, size_t memoryBytes, ThreadPool &pool, DedupStats &stats) {
+    auto start = chrono::steady_clock::now();
+    const int width = pack.getWidth(), height = pack.getHeight();
+    const bool small = isSmallBoard(width, height);
+    const uint64_t count = pack.getCount();
+    memoryBytes = max<size_t>(memoryBytes, 1);
+    stats = DedupStats{};
+    stats.input = count;
+    stats.shards = static_cast<size_t>(max<uint64_t>(1, (count * BYTES_PER_ENTRY + memoryBytes - 1) / memoryBytes));
+    const size_t shards = stats.shards;
+
+    // Hashing gets half the budget and the open shards' buffers the other half. Only so many shards are open
+    // at once (the file limit, and at least MIN_SHARD_BUFFER entries each), so the shards are done in groups:
+    // each group hashes the whole pack again, keeps its own shards' entries, then deduplicates them.
+    const size_t half = memoryBytes / 2;
+    const size_t batchSize = clamp<size_t>(half / sizeof(Entry), 1, MAX_BATCH);
+    const size_t openShards = clamp<size_t>(half / (MIN_SHARD_BUFFER * sizeof(Entry)), 1,
+                                            min(shards, fileBudget()));
+    const size_t shardBuffer = clamp<size_t>(half / (openShards * sizeof(Entry)), 1, MAX_SHARD_BUFFER);
+    stats.passes = (shards + openShards - 1) / openShards;
+
+    PuzzlePackStreamWriter out;
+    if (!out.open(path, width, height, pack.getFlags())) { return false; }
+
+    vector<FILE *> files;
+    auto closeFiles = [&files]() {
+        for (FILE *file : files) {
+            if (file) { fclose(file); }
+        }
+        files.clear();
+    };
+    vector<vector<Entry>> buffers;
+    vector<uint64_t> shardCounts;
+    vector<Entry> batch, entries, table;
+    Board board(width, height);
+    bool ok = true;
+    for (size_t first = 0; first < shards && ok; first += openShards) {
+        const size_t group = min(openShards, shards - first);
+
+        // Pass 1: hash every puzzle's canonical image and spill the ones of this group's shards (picked by
+        // the top bits of the hash) to their files
+        files.assign(group, nullptr);
+        for (FILE *&file : files) {
+            // The shard buffers already batch the writes, so stdio doesn't need a buffer of its own
+            ok = ok && (file = tmpfile()) != nullptr && setvbuf(file, nullptr, _IONBF, 0) == 0;
+        }
+        if (!ok) {
+            cout << "ERROR::DEDUP: Could not create a temporary file" << endl;
+            break;
+        }
+        buffers.assign(group, {});
+        for (vector<Entry> &buffer : buffers) { buffer.reserve(shardBuffer); }
+        shardCounts.assign(group, 0);
+        auto spill = [&](size_t shard) {
+            vector<Entry> &buffer = buffers[shard];
+            ok = ok && fwrite(buffer.data(), sizeof(Entry), buffer.size(), files[shard]) == buffer.size();
+            shardCounts[shard] += buffer.size();
+            buffer.clear();
+        };
+        batch.reserve(batchSize);
+        for (uint64_t puzzle = 0; puzzle < count && ok; puzzle += batchSize) {
+            batch.resize(static_cast<size_t>(min<uint64_t>(batchSize, count - puzzle)));
+            pool.parallelFor((batch.size() + PUZZLES_PER_TASK - 1) / PUZZLES_PER_TASK, [&](size_t task) {
+                Board puzzleBoard(width, height);
+                size_t end = min(batch.size(), (task + 1) * PUZZLES_PER_TASK);
+                for (size_t ii = task * PUZZLES_PER_TASK; ii < end; ii++) {
+                    pack.get(puzzle + ii, puzzleBoard);
+                    uint64_t key = small ? canonicalizeSmallBoard(packSmallBoard(puzzleBoard), width, height)
+                                         : canonicalHash(puzzleBoard);
+                    batch[ii] = {key, puzzle + ii};
+                }
+            });
+            for (const Entry &entry : batch) {
+                size_t shard = static_cast<size_t>(((spread(entry.key, small) >> 32) * shards) >> 32);
+                if (shard < first || shard >= first + group) { continue; }
+                buffers[shard - first].push_back(entry);
+                if (buffers[shard - first].size() == shardBuffer) { spill(shard - first); }
+            }
+        }
+        for (size_t shard = 0; shard < group; shard++) {
+            spill(shard);
+            ok = ok && fflush(files[shard]) == 0 && !ferror(files[shard]);
+        }
+        if (!ok) {
+            cout << "ERROR::DEDUP: Could not write a temporary file" << endl;
+            break;
+        }
+        // The second pass gets the whole budget
+        release(batch);
+        buffers.clear();
+        buffers.shrink_to_fit();
+
+        // Pass 2: one shard at a time, keep the first puzzle of each class. The shard is read back in chunks
+        // and the hash set only grows with the classes, so a shard full of duplicates stays small.
+        for (size_t shard = 0; shard < group && ok; shard++) {
+            // Sized for the whole shard up to the budget, so it only grows for a shard with more classes than
+            // expected (a shard mostly made of duplicates needs much less, but is bounded by the budget anyway)
+            size_t capacity = 16;
+            while (capacity < 2 * min<uint64_t>(shardCounts[shard], memoryBytes / BYTES_PER_ENTRY)) { capacity *= 2; }
+            table.assign(capacity, Entry{0, EMPTY});
+            rewind(files[shard]);
+            size_t stored = 0;
+            for (uint64_t left = shardCounts[shard]; left > 0 && ok; left -= entries.size()) {
+                entries.resize(static_cast<size_t>(min<uint64_t>(left, shardBuffer)));
+                ok = fread(entries.data(), sizeof(Entry), entries.size(), files[shard]) == entries.size();
+                for (size_t ii = 0; ii < entries.size() && ok; ii++) {
+                    const Entry &entry = entries[ii];
+                    size_t slot = findSlot(table, entry.key, small);
+                    bool duplicate = false;
+                    for (; table[slot].index != EMPTY; slot = (slot + 1) & (table.size() - 1)) {
+                        if (table[slot].key == entry.key && (small || sameClass(pack, table[slot].index, entry.index))) {
+                            duplicate = true;
+                            break;
+                        }
+                    }
+                    if (duplicate) { continue; }
+                    table[slot] = entry;
+                    if (++stored * 2 > table.size()) { grow(table, small); }
+                    pack.get(entry.index, board);
+                    out.add(board, pack.getPar(entry.index));
+                    stats.unique++;
+                }
+            }
+            if (!ok) { cout << "ERROR::DEDUP: Could not read a temporary file" << endl; }
+        }
+        release(entries);
+        release(table);
+        closeFiles();
+    }
+    closeFiles();
+    // An unfinished pack has no header, so a failed run can't leave a pack that opens but is missing puzzles
+    ok = ok && out.finish();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ok;
+}
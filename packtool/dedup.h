@@ -0,0 +1,43 @@
+#ifndef GRAPHICS_DEDUP_H
+#define GRAPHICS_DEDUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../src/framework/threadPool.h"
+#include "../src/game/puzzlePack.h"
+
+/// @brief What dedupPack() did
+struct DedupStats {
+    uint64_t input = 0, unique = 0;
+    size_t shards = 0, passes = 0;
+    double seconds = 0;
+};
+
+/**
+ * @brief Copies the puzzles of a pack to a new one, keeping one of each set of rotations and reflections
+ * @details Streams the pack in two passes so memory stays bounded however big it is. The first hashes the
+ * canonical image of every puzzle (across the pool) and spills (hash, index) pairs to temporary shard files,
+ * split by the top bits of the hash into as many shards as it takes for one shard's hash set to fit in
+ * memoryBytes. The second loads one shard at a time into an open-addressing hash set and writes the
+ * first puzzle of each class. Boards up to 8x8 are keyed by their canonical word, so they never collide;
+ * bigger boards are compared in full when their hashes match.
+ *
+ * The batch of hashes and the shards' write buffers are sized from memoryBytes too, and only as many shard
+ * files are open at once as the descriptor limit (and the buffers' minimum size) allows. When there are more
+ * shards than that, they are done in groups, each hashing the whole pack again: more passes, not more files.
+ * The pack's own pages are mapped from the file and not counted.
+ *
+ * Unique puzzles come out shard by shard, in their original order within each shard.
+ *
+ * @param pack The puzzles to deduplicate
+ * @param path Where to write the new pack (same size and flags)
+ * @param memoryBytes Rough bound on the memory used for the hashes and hash sets
+ * @param pool Workers for the hashing pass
+ * @param stats Receives the counts
+ * @return false if a file can't be written (a short write to any of them fails the run)
+ */
+bool dedupPack(const PuzzlePack &pack, const std::string &path, size_t memoryBytes, ThreadPool &pool,
+               DedupStats &stats);
+
+#endif //GRAPHICS_DEDUP_H
@@ -0,0 +1,144 @@
+// Builds and inspects puzzle packs (see src/game/puzzlePack.h), which the game opens with --pack.
+//
+//   packtool generate --out levels.lop [--size 7x7] [--count 1000] [--seed 1] [--threads 0] [--no-par]
+//   packtool info levels.lop
+//   packtool show levels.lop n
+//   packtool dedup levels.lop unique.lop [--memory 1024] [--threads 0]
+//
+// Generated puzzles are random presses from all off, so each one can be won; par is the fewest presses
+// that solve it.
+// dedup keeps one puzzle of each set of rotations and reflections, using about --memory MB (see dedup.h).
+
+#include "dedup.h"
+#include "../src/framework/threadPool.h"
+#include "../src/game/board.h"
+#include "../src/game/puzzlePack.h"
+#include "../src/game/solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace {
+/// @brief Puzzles generated by one task: a multiple of 8, so tasks never share a byte of the pack
+const size_t PUZZLES_PER_TASK = 4096;
+
+int usage() {
+    cout << "Usage:\n"
+            "  packtool generate --out file [--size WxH] [--count n] [--seed s] [--threads t] [--no-par]\n"
+            "  packtool info file\n"
+            "  packtool show file n\n"
+            "  packtool dedup file out [--memory MB] [--threads t]" << endl;
+    return 1;
+}
+
+int generate(int argc, char *argv[]) {
+    int width = 7, height = 7;
+    size_t count = 1000;
+    uint32_t seed = 1, flags = PACK_PAR;
+    unsigned int threads = 0;
+    string out;
+    for (int ii = 2; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--out") && ii + 1 < argc)          { out = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--count") && ii + 1 < argc)   { count = strtoull(argv[++ii], nullptr, 10); }
+        else if (!strcmp(argv[ii], "--seed") && ii + 1 < argc)    { seed = static_cast<uint32_t>(strtoul(argv[++ii], nullptr, 10)); }
+        else if (!strcmp(argv[ii], "--threads") && ii + 1 < argc) { threads = static_cast<unsigned int>(atoi(argv[++ii])); }
+        else if (!strcmp(argv[ii], "--no-par"))                   { flags &= ~PACK_PAR; }
+        else if (!strcmp(argv[ii], "--size") && ii + 1 < argc)    {
+            if (sscanf(argv[++ii], "%dx%d", &width, &height) != 2 || width < 1 || height < 1) {
+                cout << "Expected --size WxH, e.g. --size 7x7" << endl;
+                return 1;
+            }
+        }
+    }
+    if (out.empty()) { return usage(); }
+
+    Solver solver(width, height);
+    PuzzlePackWriter writer(width, height, count, flags);
+    ThreadPool pool(threads);
+    auto start = chrono::steady_clock::now();
+    pool.parallelFor((count + PUZZLES_PER_TASK - 1) / PUZZLES_PER_TASK, [&](size_t task) {
+        Board puzzle(width, height), presses(width, height);
+        size_t end = min(count, (task + 1) * PUZZLES_PER_TASK);
+        for (size_t index = task * PUZZLES_PER_TASK; index < end; index++) {
+            puzzle.fill(false);
+            puzzle.scramble(seed * 2654435761u + static_cast<uint32_t>(index));
+            int par = 0;
+            if ((flags & PACK_PAR) && solver.solve(puzzle, presses)) { par = static_cast<int>(presses.litCount()); }
+            writer.set(index, puzzle, par);
+        }
+    });
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (!writer.save(out)) { return 1; }
+    printf("%zu puzzles of %dx%d in %.2fs on %u threads: %s, %.1f MB (%.1f bits per puzzle)\n", count, width, height,
+           wall, pool.size() + 1, out.c_str(), writer.getFileSize() / 1e6,
+           count ? 8.0 * writer.getFileSize() / count : 0.0);
+    return 0;
+}
+
+int info(const PuzzlePack &pack) {
+    printf("%zu puzzles of %dx%d%s\n", pack.getCount(), pack.getWidth(), pack.getHeight(),
+           pack.getFlags() & PACK_PAR ? ", with par" : "");
+    if (!(pack.getFlags() & PACK_PAR) || !pack.getCount()) { return 0; }
+
+    // Touches every index byte, but none of the puzzles
+    size_t histogram[256] = {};
+    for (size_t ii = 0; ii < pack.getCount(); ii++) { histogram[pack.getPar(ii)]++; }
+    printf("par  puzzles\n");
+    for (int par = 0; par < 256; par++) {
+        if (histogram[par]) { printf("%3d  %zu\n", par, histogram[par]); }
+    }
+    return 0;
+}
+
+int dedup(int argc, char *argv[]) {
+    size_t memoryMB = 1024;
+    unsigned int threads = 0;
+    for (int ii = 4; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--memory") && ii + 1 < argc)       { memoryMB = max<size_t>(1, strtoull(argv[++ii], nullptr, 10)); }
+        else if (!strcmp(argv[ii], "--threads") && ii + 1 < argc) { threads = static_cast<unsigned int>(atoi(argv[++ii])); }
+    }
+    PuzzlePack pack;
+    if (!pack.open(argv[2])) { return 1; }
+
+    ThreadPool pool(threads);
+    DedupStats stats;
+    if (!dedupPack(pack, argv[3], memoryMB << 20, pool, stats)) { return 1; }
+    printf("%llu puzzles, %llu unique (%.1f%%) in %.2fs with %zu shards in %zu passes: %s\n",
+           static_cast<unsigned long long>(stats.input), static_cast<unsigned long long>(stats.unique),
+           stats.input ? 100.0 * stats.unique / stats.input : 0.0, stats.seconds, stats.shards, stats.passes, argv[3]);
+    return 0;
+}
+
+int show(const PuzzlePack &pack, size_t index) {
+    if (index >= pack.getCount()) {
+        cout << "The pack only has " << pack.getCount() << " puzzles" << endl;
+        return 1;
+    }
+    Board puzzle = pack.get(index);
+    printf("Puzzle %zu (par %d)\n", index, pack.getPar(index));
+    for (int y = 0; y < puzzle.getHeight(); y++) {
+        for (int x = 0; x < puzzle.getWidth(); x++) { putchar(puzzle.isLit(x, y) ? '#' : '.'); }
+        putchar('\n');
+    }
+    return 0;
+}
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) { return usage(); }
+    if (!strcmp(argv[1], "generate")) { return generate(argc, argv); }
+    if (!strcmp(argv[1], "dedup") && argc >= 4) { return dedup(argc, argv); }
+
+    PuzzlePack pack;
+    if (!strcmp(argv[1], "info") && argc == 3)      { return pack.open(argv[2]) ? info(pack) : 1; }
+    else if (!strcmp(argv[1], "show") && argc == 4) { return pack.open(argv[2]) ? show(pack, strtoull(argv[3], nullptr, 10)) : 1; }
+    return usage();
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+in vec2 WorldPos;
+out vec4 FragColor;
+
+uniform sampler2D cells;  // R8, one texel per light: its state (0 = off)
+uniform vec2 boardMin;
+uniform float pitch;      // Distance between light centers
+uniform float cellSize;   // Size of a light
+uniform float outlineSize;
+uniform vec2 hover;       // Cell under the cursor, or (-1, -1)
+uniform vec4 palette[8]; // Color of each state
+uniform vec4 outlineColor;
+
+void main()
+{
+    // Which light this fragment belongs to, and where in its square it is
+    vec2 cellPos = (WorldPos - boardMin) / pitch;
+    vec2 cell = floor(cellPos);
+    vec2 local = abs(cellPos - cell - 0.5) * pitch; // Distance from the light's center
+
+    // Lights smaller than a pixel have no visible gap; fill the cell so huge boards don't turn into moire
+    float pixel = max(fwidth(WorldPos.x), fwidth(WorldPos.y));
+    float reach = pitch < 2.0 * pixel ? pitch * 0.5 : cellSize * 0.5;
+
+    if (max(local.x, local.y) <= reach) {
+        ivec2 texel = min(ivec2(cell), textureSize(cells, 0) - 1);
+        int state = int(texelFetch(cells, texel, 0).r * 255.0 + 0.5);
+        FragColor = palette[min(state, 7)];
+    } else if (cell == hover && max(local.x, local.y) <= outlineSize * 0.5) {
+        FragColor = outlineColor;
+    } else {
+        discard;
+    }
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+uniform mat4 projection;
+uniform vec2 boardMin; // Bottom left corner of the board (world units)
+uniform vec2 boardMax; // Top right corner
+
+out vec2 WorldPos;
+
+#include "quad.glsl"
+
+void main()
+{
+    // One quad over the whole board
+    WorldPos = mix(boardMin, boardMax, quadCorner());
+    gl_Position = projection * vec4(WorldPos, 0.0, 1.0);
+}
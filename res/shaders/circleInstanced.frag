@@ -0,0 +1,19 @@
+#version 330 core
+
+in vec2 Local;
+in float Radius;
+in vec4 CircleColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    // Coverage is computed analytically: fade out over about one pixel around the edge
+    float dist = length(Local);
+    float edge = fwidth(dist);
+    float coverage = 1.0 - smoothstep(Radius - edge, Radius + edge, dist);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    FragColor = vec4(CircleColor.rgb, CircleColor.a * coverage);
+}
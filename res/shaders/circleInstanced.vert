@@ -0,0 +1,25 @@
+#version 330 core
+
+layout (location = 0) in vec3 aCircle; // <vec2 center, float radius> (per instance)
+layout (location = 1) in vec4 aColor;  // normalized RGBA8 (per instance)
+
+uniform mat4 projection;
+
+#include "quad.glsl"
+
+out vec2 Local;      // Offset from the center, in world units
+out float Radius;
+out vec4 CircleColor;
+
+void main()
+{
+    // (-1,-1) (1,-1) (-1,1) (1,1)
+    vec2 corner = quadCorner() * 2.0 - 1.0;
+
+    // Pad the quad by one unit so the anti-aliased edge isn't clipped
+    float halfSize = aCircle.z + 1.0;
+    Local = corner * halfSize;
+    Radius = aCircle.z;
+    CircleColor = aColor;
+    gl_Position = projection * vec4(aCircle.xy + Local, 0.0, 1.0);
+}
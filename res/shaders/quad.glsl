@@ -0,0 +1,5 @@
+// Corners of a triangle strip quad generated from the vertex ID: (0,0) (1,0) (0,1) (1,1)
+vec2 quadCorner()
+{
+    return vec2(gl_VertexID & 1, gl_VertexID >> 1);
+}
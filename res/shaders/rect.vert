@@ -0,0 +1,25 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos;   // unit quad corner
+#ifdef INSTANCED
+layout (location = 1) in vec4 aRect;  // <vec2 center, vec2 size> (per instance)
+layout (location = 2) in vec4 aColor; // normalized RGBA8 (per instance)
+#else
+uniform mat4 model;
+uniform vec4 shapeColor;
+#endif
+
+uniform mat4 projection;
+
+out vec4 ShapeColor;
+
+void main()
+{
+#ifdef INSTANCED
+    ShapeColor = aColor;
+    gl_Position = projection * vec4(aRect.xy + aPos * aRect.zw, 0.0, 1.0);
+#else
+    ShapeColor = shapeColor;
+    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+#endif
+}
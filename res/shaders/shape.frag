@@ -1,10 +0,0 @@
-#version 330 core
-
-out vec4 FragColor;
-
-uniform vec4 shapeColor;
-
-void main()
-{
-    FragColor = shapeColor;
-}
\ No newline at end of file
@@ -1,14 +1,32 @@
 #version 330 core
+#ifdef INSTANCED
+layout (location = 0) in vec4 aRect;  // <vec2 center, vec2 size> (per instance)
+layout (location = 1) in vec4 aUV;    // <vec2 bottom left, vec2 top right> in the texture (per instance)
+layout (location = 2) in vec4 aColor; // normalized RGBA8 tint (per instance)
+
+out vec4 SpriteColor;
+
+#include "quad.glsl"
+#else
 // Both position and texture coordinates contain two floats, so we combine them into a single vertex attribute
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
 
+uniform mat4 model;
+#endif
+
 out vec2 TexCoords;
 
-uniform mat4 model;
 uniform mat4 projection;
 
 void main()
 {
+#ifdef INSTANCED
+    vec2 corner = quadCorner();
+    TexCoords = mix(aUV.xy, aUV.zw, corner);
+    SpriteColor = aColor;
+    gl_Position = projection * vec4(aRect.xy + (corner - 0.5) * aRect.zw, 0.0, 1.0);
+#else
     TexCoords = vertex.zw;
     gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-}
\ No newline at end of file
+#endif
+}
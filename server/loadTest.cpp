@@ -0,0 +1,215 @@
+// Load generator and end-to-end check for the server. Each thread opens a connection and a set of
+// sessions, then pipelines batches of random presses, checking every reply against a local copy of
+// the board. At the end every session is solved by the server, the solution is played, and the last
+// press has to win.
+//
+//   server_load --unix /tmp/lights.sock [--threads 4] [--sessions 256] [--presses 1000000] [--batch 512] [--size 5x5]
+
+#include "protocol.h"
+#include "../src/game/board.h"
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Protocol;
+
+namespace {
+struct Options {
+    const char *unixPath = nullptr;
+    string host = "127.0.0.1";
+    int port = -1;
+    int threads = 4, sessions = 256, batch = 512;
+    long presses = 1000000;
+    int width = 5, height = 5;
+};
+
+atomic<long> failures{0};
+
+int connectTo(const Options &options) {
+    int fd;
+    if (options.unixPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, options.unixPath, sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) { return fd; }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        inet_pton(AF_INET, options.host.c_str(), &address.sin_addr);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) { return fd; }
+    }
+    if (fd >= 0) { close(fd); }
+    return -1;
+}
+
+bool writeAll(int fd, const void *data, size_t bytes) {
+    auto *at = static_cast<const uint8_t *>(data);
+    while (bytes > 0) {
+        ssize_t written = write(fd, at, bytes);
+        if (written <= 0) { return false; }
+        at += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readAll(int fd, void *data, size_t bytes) {
+    auto *at = static_cast<uint8_t *>(data);
+    while (bytes > 0) {
+        ssize_t received = read(fd, at, bytes);
+        if (received <= 0) { return false; }
+        at += received;
+        bytes -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/// @brief Sends a batch and reads back one response per request (payloads go to payloads, in order)
+bool exchange(int fd, const vector<Request> &requests, vector<Response> &responses, vector<vector<uint8_t>> *payloads) {
+    if (!writeAll(fd, requests.data(), requests.size() * sizeof(Request))) { return false; }
+    responses.resize(requests.size());
+    if (payloads) { payloads->resize(requests.size()); }
+    for (size_t ii = 0; ii < requests.size(); ii++) {
+        if (!readAll(fd, &responses[ii], sizeof(Response))) { return false; }
+        vector<uint8_t> discard;
+        vector<uint8_t> &payload = payloads ? (*payloads)[ii] : discard;
+        payload.resize(responses[ii].payloadBytes);
+        if (!readAll(fd, payload.data(), payload.size())) { return false; }
+    }
+    return true;
+}
+
+void fail(const string &message) {
+    if (failures++ < 10) { cout << message << endl; }
+}
+
+/// @brief One connection's share of the test; returns the number of presses made
+long client(const Options &options, int index, long presses) {
+    int fd = connectTo(options);
+    if (fd < 0) {
+        fail("Failed to connect");
+        return 0;
+    }
+    mt19937 random(index + 1);
+    vector<Request> requests;
+    vector<Response> responses;
+
+    // Open the sessions (all lights on, like the game) and mirror them locally
+    for (int ii = 0; ii < options.sessions; ii++) {
+        requests.push_back({NEW, 0, uint16_t(options.width), uint16_t(options.height), 0, 0, 0});
+    }
+    if (!exchange(fd, requests, responses, nullptr)) { fail("Connection lost"); close(fd); return 0; }
+    vector<uint32_t> ids;
+    vector<Board> boards(options.sessions, Board(options.width, options.height));
+    for (const Response &response : responses) { ids.push_back(response.session); }
+
+    // Random presses, checked against the mirror (the server replies with the lights left on)
+    long done = 0;
+    vector<uint32_t> expected;
+    while (done < presses) {
+        requests.clear();
+        expected.clear();
+        int count = static_cast<int>(min<long>(options.batch, presses - done));
+        for (int ii = 0; ii < count; ii++) {
+            int session = static_cast<int>(random() % options.sessions);
+            uint16_t x = random() % options.width, y = random() % options.height;
+            requests.push_back({PRESS, 0, x, y, 0, ids[session], 0});
+            boards[session].press(x, y);
+            expected.push_back(static_cast<uint32_t>(boards[session].litCount()));
+        }
+        if (!exchange(fd, requests, responses, nullptr)) { fail("Connection lost"); close(fd); return done; }
+        for (int ii = 0; ii < count; ii++) {
+            if (responses[ii].status > WON || responses[ii].value != expected[ii]) {
+                fail("Press mismatch: expected " + to_string(expected[ii]) + " lights, got " + to_string(responses[ii].value));
+            }
+        }
+        done += count;
+    }
+
+    // Solve every session on the server, then play the solution
+    requests.clear();
+    for (uint32_t id : ids) { requests.push_back({SOLVE, 0, 0, 0, 0, id, 0}); }
+    vector<vector<uint8_t>> payloads;
+    if (!exchange(fd, requests, responses, &payloads)) { fail("Connection lost"); close(fd); return done; }
+    const size_t rowBytes = (options.width + 7) / 8;
+    for (int session = 0; session < options.sessions; session++) {
+        if (responses[session].status == UNSOLVABLE) { fail("Reachable board reported unsolvable"); continue; }
+        requests.clear();
+        for (int y = 0; y < options.height; y++) {
+            for (int x = 0; x < options.width; x++) {
+                if ((payloads[session][y * rowBytes + x / 8] >> (x % 8)) & 1) {
+                    requests.push_back({PRESS, 0, uint16_t(x), uint16_t(y), 0, ids[session], 0});
+                }
+            }
+        }
+        vector<Response> played;
+        if (requests.empty()) {
+            if (!boards[session].allOff()) { fail("Empty solution for a lit board"); }
+        } else if (!exchange(fd, requests, played, nullptr) || played.back().status != WON) {
+            fail("Playing the solution didn't win");
+        }
+        done += static_cast<long>(requests.size());
+    }
+
+    requests.clear();
+    for (uint32_t id : ids) { requests.push_back({CLOSE, 0, 0, 0, 0, id, 0}); }
+    exchange(fd, requests, responses, nullptr);
+    close(fd);
+    return done;
+}
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--unix") && ii + 1 < argc)          { options.unixPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--host") && ii + 1 < argc)     { options.host = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--port") && ii + 1 < argc)     { options.port = atoi(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--threads") && ii + 1 < argc)  { options.threads = max(1, atoi(argv[++ii])); }
+        else if (!strcmp(argv[ii], "--sessions") && ii + 1 < argc) { options.sessions = max(1, atoi(argv[++ii])); }
+        else if (!strcmp(argv[ii], "--presses") && ii + 1 < argc)  { options.presses = atol(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--batch") && ii + 1 < argc)    { options.batch = max(1, atoi(argv[++ii])); }
+        else if (!strcmp(argv[ii], "--size") && ii + 1 < argc)     {
+            if (sscanf(argv[++ii], "%dx%d", &options.width, &options.height) != 2) {
+                cout << "Expected --size WxH, e.g. --size 5x5" << endl;
+                return 1;
+            }
+        }
+    }
+    if (!options.unixPath && options.port < 0) {
+        cout << "Usage: server_load (--unix path | --port n [--host address]) [--threads n] [--sessions n]"
+                " [--presses n] [--batch n] [--size WxH]" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    atomic<long> total{0};
+    for (int ii = 0; ii < options.threads; ii++) {
+        threads.emplace_back([&, ii] { total += client(options, ii, options.presses / options.threads); });
+    }
+    for (thread &worker : threads) { worker.join(); }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << total << " presses over " << options.threads << " connections in " << seconds << " s ("
+         << static_cast<long>(total / seconds) << " presses/s), " << failures << " failures" << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#include "server.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+static Server *running = nullptr;
+
+static void onSignal(int) {
+    if (running) { running->stop(); }
+}
+
+int main(int argc, char *argv[]) {
+    const char *unixPath = nullptr, *host = "127.0.0.1";
+    int port = -1;
+    size_t maxSessions = SessionTable::MAX_SESSIONS, maxBoardBytes = Server::DEFAULT_MAX_BOARD_BYTES;
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--unix") && ii + 1 < argc)      { unixPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--port") && ii + 1 < argc) { port = atoi(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--host") && ii + 1 < argc) { host = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--max-sessions") && ii + 1 < argc) { maxSessions = strtoul(argv[++ii], nullptr, 10); }
+        else if (!strcmp(argv[ii], "--max-memory") && ii + 1 < argc)   { maxBoardBytes = strtoul(argv[++ii], nullptr, 10) << 20; }
+    }
+    if (!unixPath && port < 0) {
+        cout << "Usage: server [--unix path] [--port n [--host address]] [--max-sessions n] [--max-memory MB]" << endl;
+        return 1;
+    }
+
+    Server server(maxSessions, maxBoardBytes);
+    if (unixPath && !server.listenUnix(unixPath)) { return 1; }
+    if (port >= 0 && !server.listenTcp(host, static_cast<uint16_t>(port))) { return 1; }
+
+    // Ctrl+C stops the loop, so the socket file is removed and the totals printed
+    running = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    cout << "Serving on" << (unixPath ? string(" ") + unixPath : "")
+         << (port >= 0 ? string(" ") + host + ":" + to_string(port) : "") << endl;
+    server.run();
+
+    const Server::Stats &stats = server.getStats();
+    cout << stats.connections << " connections, " << stats.requests << " requests, "
+         << stats.presses << " presses" << endl;
+    return 0;
+}
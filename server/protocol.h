@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_PROTOCOL_H
+#define GRAPHICS_PROTOCOL_H
+
+#include <cstdint>
+
+/**
+ * @brief Wire format of the Lights Out server (little-endian, no padding between messages).
+ * @details Clients send fixed-size Requests and may pipeline as many as they like without waiting.
+ * Every request gets exactly one Response, in the order the requests were sent. A response is a
+ * fixed header followed by payloadBytes of payload; boards are sent as height rows of
+ * ceil(width / 8) bytes, bit x % 8 of byte x / 8 being column x.
+ */
+namespace Protocol {
+    enum Op : uint8_t {
+        NEW = 1,    ///< a = width, b = height; seed 0 starts with every light on, others a random solvable board; replies with the session, or FULL
+        PRESS = 2,  ///< a = x, b = y; value = lights still on, status WON once they are all off
+        QUERY = 3,  ///< value = moves so far, payload = the board
+        SOLVE = 4,  ///< value = number of presses, payload = the presses (as a board), status UNSOLVABLE if there are none
+        CLOSE = 5,  ///< ends the session
+    };
+
+    enum Status : uint8_t {
+        OK = 0,
+        WON = 1,
+        UNSOLVABLE = 2,
+        BAD_SESSION = 3,
+        BAD_ARGUMENT = 4,
+        BAD_OP = 5,
+        FULL = 6,   ///< NEW refused: the server already holds as many sessions (or as much board memory) as it allows
+    };
+
+    /// @brief Largest board side the server accepts
+    const int MAX_SIDE = 1024;
+
+    #pragma pack(push, 1)
+    struct Request {
+        uint8_t op;
+        uint8_t reserved;
+        uint16_t a, b;
+        uint16_t reserved2;
+        uint32_t session;
+        uint32_t seed;
+    };
+
+    struct Response {
+        uint8_t op;
+        uint8_t status;
+        uint16_t reserved;
+        uint32_t session;
+        uint32_t value;
+        uint32_t payloadBytes;
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(Request) == 16, "requests are 16 bytes on the wire");
+    static_assert(sizeof(Response) == 16, "response headers are 16 bytes on the wire");
+}
+
+#endif //GRAPHICS_PROTOCOL_H
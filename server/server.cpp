@@ -0,0 +1,481 @@
+#include "server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using namespace Protocol;
+
+// --------------------------------------------------------
+// Sessions
+// --------------------------------------------------------
+
+SessionTable::SessionTable(size_t maxSessions, size_t maxBoardBytes)
+    : maxSessions(min<size_t>(maxSessions, MAX_SESSIONS)), maxBoardBytes(maxBoardBytes) {}
+
+size_t SessionTable::boardSize(int width, int height) {
+    return static_cast<size_t>((width + 63) / 64) * height * sizeof(uint64_t);
+}
+
+bool SessionTable::open(int width, int height, uint32_t seed, uint32_t &id) {
+    // A slot past MAX_SESSIONS would spill into the generation bits and alias another session's id
+    size_t bytes = boardSize(width, height);
+    if (size() >= maxSessions || bytes > maxBoardBytes - boardBytes) { return false; }
+
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(sessions.size());
+        sessions.emplace_back();
+    }
+
+    Session &session = sessions[slot];
+    session.board = Board(width, height);
+    session.moves = 0;
+    session.open = true;
+    if (seed != 0) {
+        // Random presses from all off can always be undone, so the board is solvable
+        session.board.fill(false);
+        session.board.scramble(seed);
+    }
+    boardBytes += bytes;
+    id = session.generation << SLOT_BITS | slot;
+    return true;
+}
+
+SessionTable::Session *SessionTable::find(uint32_t id) {
+    uint32_t slot = id & SLOT_MASK;
+    if (slot >= sessions.size()) { return nullptr; }
+    Session &session = sessions[slot];
+    return session.open && session.generation == id >> SLOT_BITS ? &session : nullptr;
+}
+
+void SessionTable::close(uint32_t id) {
+    Session *session = find(id);
+    if (!session) { return; }
+    session->open = false;
+    boardBytes -= boardSize(session->board.getWidth(), session->board.getHeight());
+    session->generation = (session->generation + 1) & (0xFFFFFFFFu >> SLOT_BITS);
+    session->board = Board(1, 1);
+    freeSlots.push_back(id & SLOT_MASK);
+}
+
+// --------------------------------------------------------
+// Sockets
+// --------------------------------------------------------
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+Server::Server(size_t maxSessions, size_t maxBoardBytes)
+    : readBuffer(READ_CHUNK + sizeof(Request)), sessions(maxSessions, maxBoardBytes), workers(make_unique<ThreadPool>()) {
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        cout << "Failed to create epoll instance: " << strerror(errno) << endl;
+        return;
+    }
+    // Workers post finished solves here to wake the loop
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    if (wakeFd < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+        cout << "Failed to create wake-up event: " << strerror(errno) << endl;
+    }
+}
+
+Server::~Server() {
+    // Solves still queued see stopping and return; the one running finishes before the fds go
+    stopping = true;
+    workers.reset();
+    for (auto &entry : connections) { ::close(entry.first); }
+    for (int listener : listeners) { ::close(listener); }
+    if (!unixPath.empty()) { unlink(unixPath.c_str()); }
+    if (wakeFd >= 0) { ::close(wakeFd); }
+    if (epoll >= 0) { ::close(epoll); }
+}
+
+bool Server::addListener(int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (listen(fd, SOMAXCONN) < 0 || !setNonBlocking(fd) || epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) < 0) {
+        cout << "Failed to listen: " << strerror(errno) << endl;
+        ::close(fd);
+        return false;
+    }
+    listeners.push_back(fd);
+    return true;
+}
+
+bool Server::listenUnix(const string &path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        cout << "Socket path too long: " << path << endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    unlink(path.c_str());
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        cout << "Failed to bind " << path << ": " << strerror(errno) << endl;
+        if (fd >= 0) { ::close(fd); }
+        return false;
+    }
+    unixPath = path;
+    return addListener(fd);
+}
+
+bool Server::listenTcp(const string &host, uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        cout << "Not an IPv4 address: " << host << endl;
+        return false;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int yes = 1;
+    if (fd >= 0) { setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)); }
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        cout << "Failed to bind " << host << ":" << port << ": " << strerror(errno) << endl;
+        if (fd >= 0) { ::close(fd); }
+        return false;
+    }
+    return addListener(fd);
+}
+
+void Server::run() {
+    const int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    while (!stopping) {
+        // The timeout only bounds how long a stop() from a signal handler goes unnoticed
+        int count = epoll_wait(epoll, events, MAX_EVENTS, 200);
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            cout << "epoll_wait failed: " << strerror(errno) << endl;
+            return;
+        }
+
+        for (int ii = 0; ii < count; ii++) {
+            int fd = events[ii].data.fd;
+            if (fd == wakeFd) {
+                deliverSolved();
+                continue;
+            }
+            if (find(listeners.begin(), listeners.end(), fd) != listeners.end()) {
+                accept(fd);
+                continue;
+            }
+            auto found = connections.find(fd);
+            if (found == connections.end()) { continue; }
+            Connection &connection = *found->second;
+
+            if (events[ii].events & (EPOLLHUP | EPOLLERR) && !(events[ii].events & EPOLLIN)) {
+                disconnect(connection);
+                connections.erase(found);
+                continue;
+            }
+            if (events[ii].events & EPOLLIN) {
+                receive(connection);
+                if (connection.fd < 0) { connections.erase(found); continue; }
+            }
+            // Answer everything this wake-up produced with one write
+            flush(connection);
+            if (connection.fd < 0) { connections.erase(found); }
+        }
+    }
+}
+
+void Server::accept(int listener) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) { return; }
+
+        // Responses are already batched, so Nagle would only add delay (fails harmlessly on Unix sockets)
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        auto connection = make_unique<Connection>();
+        connection->fd = fd;
+        connection->serial = nextSerial++;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::move(connection);
+        stats.connections++;
+    }
+}
+
+void Server::receive(Connection &connection) {
+    // Put the unfinished request from last time in front of the new data
+    uint8_t *buffer = readBuffer.data();
+    memcpy(buffer, connection.partial, connection.partialBytes);
+    ssize_t received = read(connection.fd, buffer + connection.partialBytes, READ_CHUNK);
+    if (received == 0) {
+        // The client is done sending (or half-closed): answer what it sent, then close
+        connection.ended = true;
+        return;
+    }
+    if (received < 0 && errno != EAGAIN && errno != EINTR) {
+        disconnect(connection);
+        return;
+    }
+    if (received < 0) { return; }
+
+    size_t available = connection.partialBytes + static_cast<size_t>(received), offset = 0;
+    for (; offset + sizeof(Request) <= available; offset += sizeof(Request)) {
+        Request request;
+        memcpy(&request, buffer + offset, sizeof(Request));
+        handle(connection, request);
+    }
+    connection.partialBytes = available - offset;
+    memcpy(connection.partial, buffer + offset, connection.partialBytes);
+}
+
+uint8_t *Server::respond(Connection &connection, const Request &request, uint8_t status,
+                         uint32_t session, uint32_t value, uint32_t payloadBytes) {
+    // Behind an unfinished solve, the response waits with everything else that came after it
+    vector<uint8_t> *target = &connection.out;
+    if (!connection.held.empty()) {
+        if (connection.held.back().ticket != 0) { connection.held.emplace_back(); }
+        target = &connection.held.back().bytes;
+        connection.heldBytes += sizeof(Response) + payloadBytes;
+    }
+
+    Response response{request.op, status, 0, session, value, payloadBytes};
+    size_t start = target->size();
+    target->resize(start + sizeof(Response) + payloadBytes);
+    memcpy(target->data() + start, &response, sizeof(Response));
+    return target->data() + start + sizeof(Response);
+}
+
+uint32_t Server::packedSize(const Board &board) {
+    return static_cast<uint32_t>((board.getWidth() + 7) / 8 * board.getHeight());
+}
+
+void Server::packBoard(const Board &board, uint8_t *payload) {
+    // Rows are little-endian words, so their first bytes are already the wire format (x86, ARM)
+    const size_t rowBytes = (board.getWidth() + 7) / 8;
+    for (int y = 0; y < board.getHeight(); y++) {
+        memcpy(payload + y * rowBytes, board.row(y), rowBytes);
+    }
+}
+
+void Server::handle(Connection &connection, const Request &request) {
+    stats.requests++;
+    SessionTable::Session *session = nullptr;
+    if (request.op != NEW && request.op != CLOSE) {
+        session = sessions.find(request.session);
+        if (!session) {
+            respond(connection, request, BAD_SESSION, request.session, 0);
+            return;
+        }
+    }
+
+    switch (request.op) {
+        case NEW: {
+            if (request.a < 1 || request.b < 1 || request.a > MAX_SIDE || request.b > MAX_SIDE) {
+                respond(connection, request, BAD_ARGUMENT, 0, 0);
+                return;
+            }
+            uint32_t id;
+            if (!sessions.open(request.a, request.b, request.seed, id)) {
+                respond(connection, request, FULL, 0, 0);
+                return;
+            }
+            respond(connection, request, OK, id, 0);
+            break;
+        }
+        case PRESS: {
+            Board &board = session->board;
+            if (request.a >= board.getWidth() || request.b >= board.getHeight()) {
+                respond(connection, request, BAD_ARGUMENT, request.session, 0);
+                return;
+            }
+            board.press(request.a, request.b);
+            session->moves++;
+            stats.presses++;
+            auto lit = static_cast<uint32_t>(board.litCount());
+            respond(connection, request, lit == 0 ? WON : OK, request.session, lit);
+            break;
+        }
+        case QUERY: {
+            uint8_t *payload = respond(connection, request, session->board.allOff() ? WON : OK, request.session,
+                                       session->moves, packedSize(session->board));
+            packBoard(session->board, payload);
+            break;
+        }
+        case SOLVE:
+            solve(connection, request, session->board);
+            break;
+        case CLOSE: {
+            bool found = sessions.find(request.session) != nullptr;
+            sessions.close(request.session);
+            respond(connection, request, found ? OK : BAD_SESSION, request.session, 0);
+            break;
+        }
+        default:
+            respond(connection, request, BAD_OP, request.session, 0);
+            break;
+    }
+}
+
+// --------------------------------------------------------
+// Solving
+// --------------------------------------------------------
+
+shared_ptr<Server::CachedSolver> Server::solverFor(int width, int height) {
+    uint32_t key = uint32_t(width) << 16 | uint32_t(height);
+    shared_ptr<CachedSolver> &cached = solvers[key];
+    if (!cached) {
+        cached = make_shared<CachedSolver>();
+        if (solvers.size() > MAX_SOLVERS) {
+            // Solves already queued keep their own reference, so dropping it here is safe
+            auto oldest = solvers.end();
+            for (auto it = solvers.begin(); it != solvers.end(); ++it) {
+                if (it->first != key && (oldest == solvers.end() || it->second->lastUsed < oldest->second->lastUsed)) {
+                    oldest = it;
+                }
+            }
+            solvers.erase(oldest);
+        }
+    }
+    cached->lastUsed = ++solverClock;
+    return cached;
+}
+
+void Server::solve(Connection &connection, const Request &request, const Board &board) {
+    // Later presses in the same batch mustn't change the board being solved, so the worker gets a copy
+    uint64_t ticket = nextTicket++;
+    Held &held = connection.held.emplace_back();
+    held.ticket = ticket;
+    held.reserved = sizeof(Response) + packedSize(board);
+    connection.heldBytes += held.reserved;
+
+    workers->submit([this, solver = solverFor(board.getWidth(), board.getHeight()), board,
+                    fd = connection.fd, serial = connection.serial, ticket, request]() {
+        if (stopping) { return; }
+        call_once(solver->built, [&]() { solver->solver = make_unique<Solver>(board.getWidth(), board.getHeight()); });
+
+        Solved result{fd, serial, ticket, vector<uint8_t>(sizeof(Response))};
+        Board presses;
+        Response response{request.op, UNSOLVABLE, 0, request.session, 0, 0};
+        if (solver->solver->solve(board, presses)) {
+            response.status = OK;
+            response.value = static_cast<uint32_t>(presses.litCount());
+            response.payloadBytes = packedSize(presses);
+            result.response.resize(sizeof(Response) + response.payloadBytes);
+            packBoard(presses, result.response.data() + sizeof(Response));
+        }
+        memcpy(result.response.data(), &response, sizeof(Response));
+
+        lock_guard<mutex> lock(solvedMutex);
+        solved.push_back(std::move(result));
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) { /* already signalled */ }
+    });
+}
+
+void Server::deliverSolved() {
+    uint64_t count;
+    if (read(wakeFd, &count, sizeof(count)) < 0) { /* spurious wake-up */ }
+    vector<Solved> finished;
+    {
+        lock_guard<mutex> lock(solvedMutex);
+        finished.swap(solved);
+    }
+
+    for (Solved &result : finished) {
+        // The client may have gone (and its fd been reused) while the solve ran
+        auto found = connections.find(result.fd);
+        if (found == connections.end() || found->second->serial != result.serial) { continue; }
+        Connection &connection = *found->second;
+        for (Held &held : connection.held) {
+            if (held.ticket != result.ticket) { continue; }
+            connection.heldBytes += result.response.size() - held.reserved;
+            held.ticket = 0;
+            held.reserved = 0;
+            held.bytes = std::move(result.response);
+            break;
+        }
+        release(connection);
+        flush(connection);
+        if (connection.fd < 0) { connections.erase(found); }
+    }
+}
+
+void Server::release(Connection &connection) {
+    while (!connection.held.empty() && connection.held.front().ticket == 0) {
+        vector<uint8_t> &bytes = connection.held.front().bytes;
+        connection.out.insert(connection.out.end(), bytes.begin(), bytes.end());
+        connection.heldBytes -= bytes.size();
+        connection.held.pop_front();
+    }
+}
+
+void Server::flush(Connection &connection) {
+    while (connection.sent < connection.out.size()) {
+        ssize_t written = write(connection.fd, connection.out.data() + connection.sent,
+                                connection.out.size() - connection.sent);
+        if (written < 0) {
+            if (errno == EINTR) { continue; }
+            if (errno != EAGAIN) { disconnect(connection); return; }
+            break;
+        }
+        connection.sent += static_cast<size_t>(written);
+    }
+    if (connection.sent == connection.out.size()) {
+        connection.out.clear();
+        connection.sent = 0;
+        if (connection.ended && connection.held.empty()) {
+            disconnect(connection);
+            return;
+        }
+    }
+    updateEvents(connection);
+}
+
+void Server::updateEvents(Connection &connection) {
+    // Wait for room to write while there's a backlog; stop reading while it's too big, or for good after EOF
+    bool writing = connection.sent < connection.out.size();
+    bool reading = !connection.ended && connection.out.size() - connection.sent + connection.heldBytes < MAX_BACKLOG;
+    if (writing == connection.writing && reading == connection.reading) { return; }
+    connection.writing = writing;
+    connection.reading = reading;
+
+    epoll_event event{};
+    event.events = (reading ? uint32_t(EPOLLIN) : 0u) | (writing ? uint32_t(EPOLLOUT) : 0u);
+    event.data.fd = connection.fd;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void Server::disconnect(Connection &connection) {
+    // Sessions outlive connections: a client may reconnect and carry on with its session ids
+    epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+}
@@ -0,0 +1,207 @@
+#ifndef GRAPHICS_SERVER_H
+#define GRAPHICS_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "protocol.h"
+#include "../src/framework/threadPool.h"
+#include "../src/game/board.h"
+#include "../src/game/solver.h"
+
+using std::vector, std::unique_ptr, std::shared_ptr;
+
+/**
+ * @brief Every open game, addressed by session id.
+ * @details Slots are reused; the id also carries a generation count, so a stale id from a closed
+ * session can't reach the game that took its slot.
+ */
+class SessionTable {
+public:
+    /// @brief Most sessions ids can address: the rest of the id is the generation
+    static const uint32_t SLOT_BITS = 24, MAX_SESSIONS = 1u << SLOT_BITS;
+
+    struct Session {
+        Board board;
+        uint32_t moves = 0;
+        uint32_t generation = 0;
+        bool open = false;
+    };
+
+    /// @param maxSessions Most sessions open at once (no more than MAX_SESSIONS)
+    /// @param maxBoardBytes Most memory the boards of the open sessions may take together
+    explicit SessionTable(size_t maxSessions = MAX_SESSIONS, size_t maxBoardBytes = SIZE_MAX);
+
+    /// @brief Starts a game
+    /// @param seed 0 for every light on, anything else seeds a random solvable board
+    /// @param id Receives the session id
+    /// @return false if the session or memory limit doesn't leave room for it
+    bool open(int width, int height, uint32_t seed, uint32_t &id);
+
+    /// @brief Returns the open session with this id, or nullptr
+    Session *find(uint32_t id);
+
+    /// @brief Ends a session (its slot is reused by a later open())
+    void close(uint32_t id);
+
+    /// @brief Returns the number of open sessions
+    size_t size() const { return sessions.size() - freeSlots.size(); }
+
+    /// @brief Returns the memory taken by the open boards
+    size_t getBoardBytes() const { return boardBytes; }
+
+private:
+    static const uint32_t SLOT_MASK = MAX_SESSIONS - 1;
+
+    vector<Session> sessions;
+    vector<uint32_t> freeSlots;
+    size_t maxSessions, maxBoardBytes, boardBytes = 0;
+
+    static size_t boardSize(int width, int height);
+};
+
+/**
+ * @brief Headless Lights Out server: one epoll loop serving any number of Unix and TCP clients.
+ * @details Each wake-up reads whatever a client has sent, runs every complete request in it, and answers
+ * them all with a single write, so pipelining clients cost one read and one write per batch rather than
+ * per request. A client that doesn't read its responses is no longer read from once its backlog passes
+ * MAX_BACKLOG, until it catches up. A client that shuts down its sending side still gets every response
+ * before the connection is closed. SOLVE runs on a worker pool so a big board doesn't stall everyone
+ * else; responses after it on the same connection are held back until it finishes, keeping them in order.
+ * Linux only.
+ */
+class Server {
+public:
+    /// @brief Most board memory held for sessions unless the caller says otherwise
+    static const size_t DEFAULT_MAX_BOARD_BYTES = size_t(1) << 30;
+
+    /// @param maxSessions NEW is refused with FULL once this many sessions are open
+    /// @param maxBoardBytes ... or once a new board would take the open boards past this much memory
+    explicit Server(size_t maxSessions = SessionTable::MAX_SESSIONS, size_t maxBoardBytes = DEFAULT_MAX_BOARD_BYTES);
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    /// @brief Accepts clients on a Unix domain socket (an existing file at the path is replaced)
+    bool listenUnix(const std::string &path);
+
+    /// @brief Accepts clients on a TCP port
+    /// @param host Address to bind, e.g. "127.0.0.1" for loopback only
+    bool listenTcp(const std::string &host, uint16_t port);
+
+    /// @brief Serves clients until stop() is called
+    void run();
+
+    /// @brief Makes run() return (safe to call from a signal handler)
+    void stop() { stopping = true; }
+
+    /// @brief Totals since the server started
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t presses = 0;
+        uint64_t connections = 0;
+    };
+    const Stats &getStats() const { return stats; }
+
+private:
+    static const size_t READ_CHUNK = 256 * 1024;
+    static const size_t MAX_BACKLOG = 8 * 1024 * 1024;
+    /// @brief Board sizes whose solver is kept; the least recently used is dropped past this
+    static const size_t MAX_SOLVERS = 16;
+
+    /// @brief Responses that have to wait for a solve ahead of them
+    struct Held {
+        /// @brief The solve this is the answer to, or 0 once the bytes are final
+        uint64_t ticket = 0;
+        vector<uint8_t> bytes;
+        /// @brief Bytes counted against the backlog while the solve runs
+        size_t reserved = 0;
+    };
+
+    struct Connection {
+        int fd = -1;
+        /// @brief Tells a connection apart from a later one that got the same fd
+        uint64_t serial = 0;
+        /// @brief Start of a request that didn't arrive whole
+        uint8_t partial[sizeof(Protocol::Request)];
+        size_t partialBytes = 0;
+        /// @brief Responses not yet written, from sent on
+        vector<uint8_t> out;
+        size_t sent = 0;
+        /// @brief Responses queued behind unfinished solves, oldest first, and their size
+        std::deque<Held> held;
+        size_t heldBytes = 0;
+        bool reading = true, writing = false;
+        /// @brief The client has finished sending: close once every response has been written
+        bool ended = false;
+    };
+
+    /// @brief A solver shared by the solves of one board size, built by the first of them to run
+    struct CachedSolver {
+        std::once_flag built;
+        unique_ptr<Solver> solver;
+        uint64_t lastUsed = 0;
+    };
+
+    /// @brief A finished solve, waiting for the loop to deliver it
+    struct Solved {
+        int fd;
+        uint64_t serial, ticket;
+        vector<uint8_t> response;
+    };
+
+    int epoll = -1;
+    vector<int> listeners;
+    std::string unixPath;
+    std::unordered_map<int, unique_ptr<Connection>> connections;
+    vector<uint8_t> readBuffer;
+    std::atomic<bool> stopping{false};
+
+    SessionTable sessions;
+    /// @brief Solvers of recently solved board sizes, keyed by width << 16 | height
+    std::unordered_map<uint32_t, shared_ptr<CachedSolver>> solvers;
+    uint64_t solverClock = 0;
+    uint64_t nextSerial = 1, nextTicket = 1;
+    Stats stats;
+
+    /// @brief Solves finished by the workers; wakeFd is signalled when one is added
+    vector<Solved> solved;
+    std::mutex solvedMutex;
+    int wakeFd = -1;
+    unique_ptr<ThreadPool> workers;
+
+    bool addListener(int fd);
+    void accept(int listener);
+    void receive(Connection &connection);
+    void handle(Connection &connection, const Protocol::Request &request);
+    void flush(Connection &connection);
+    void updateEvents(Connection &connection);
+    void disconnect(Connection &connection);
+
+    /// @brief Queues a solve of the board on the workers
+    void solve(Connection &connection, const Protocol::Request &request, const Board &board);
+    /// @brief Returns the solver for a board size, dropping the least recently used past MAX_SOLVERS
+    shared_ptr<CachedSolver> solverFor(int width, int height);
+    /// @brief Hands the finished solves to their connections
+    void deliverSolved();
+    /// @brief Moves held responses that no longer wait on a solve to the output
+    static void release(Connection &connection);
+
+    /// @brief Appends a response header and reserves its payload, returning where the payload goes
+    uint8_t *respond(Connection &connection, const Protocol::Request &request, uint8_t status,
+                     uint32_t session, uint32_t value, uint32_t payloadBytes = 0);
+
+    /// @brief Appends a board in the wire format
+    static void packBoard(const Board &board, uint8_t *payload);
+    static uint32_t packedSize(const Board &board);
+};
+
+#endif //GRAPHICS_SERVER_H
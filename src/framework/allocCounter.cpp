@@ -0,0 +1,29 @@
+#include "allocCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// Plain counters: each thread only ever touches its own
+static thread_local AllocCounter::Counts counts;
+
+AllocCounter::Counts AllocCounter::thisThread() {
+    return counts;
+}
+
+// The other forms of new (arrays, nothrow) end up here; over-aligned new has its own path and isn't counted
+void *operator new(size_t size) {
+    counts.allocations++;
+    counts.bytes += size;
+    if (void *memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
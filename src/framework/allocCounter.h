@@ -0,0 +1,22 @@
+#ifndef GRAPHICS_ALLOCCOUNTER_H
+#define GRAPHICS_ALLOCCOUNTER_H
+
+#include <cstddef>
+
+/**
+ * @brief Counts heap allocations made by the calling thread.
+ * @details allocCounter.cpp replaces the global operator new, so everything built into the program is
+ * counted, standard containers included. Take a snapshot before and after a piece of code to see how
+ * many allocations it made; a steady-state frame should make none.
+ */
+namespace AllocCounter {
+    struct Counts {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    /// @brief Returns the totals for the calling thread since it started
+    Counts thisThread();
+}
+
+#endif //GRAPHICS_ALLOCCOUNTER_H
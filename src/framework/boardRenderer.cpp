@@ -0,0 +1,122 @@
+#include "boardRenderer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+BoardRenderer::BoardRenderer(Shader &shader, const BoardLayout &layout, const Board &board, int states)
+    : shader(shader), layout(layout), states(states), width(board.getWidth()), height(board.getHeight()),
+      uploadedGenerations(board.getHeight(), 0) {
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (board.getWidth() > maxSize || board.getHeight() > maxSize) {
+        std::cout << "ERROR::BOARD: " << board.getWidth() << "x" << board.getHeight()
+                  << " board exceeds the maximum texture size (" << maxSize << ")" << std::endl;
+    }
+
+    // Quad corners come from gl_VertexID, but core profile still needs a VAO to draw
+    VAO.create("BoardRenderer");
+
+    texture.create("BoardRenderer");
+    GLState::get().activeTexture(GL_TEXTURE0);
+    GLState::get().bindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, board.getWidth(), board.getHeight(), 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    texture.setBytes(GLResources::textureBytes(board.getWidth(), board.getHeight(), 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    setUniforms();
+}
+
+void BoardRenderer::setUniforms() {
+    // Everything but the hover outline is fixed for the lifetime of the board
+    vec2 boardMin = layout.origin - vec2(layout.pitch / 2, layout.pitch / 2);
+    vec2 boardMax = boardMin + vec2(width * layout.pitch, height * layout.pitch);
+    hoverIndex = -1;
+    this->shader.use();
+    this->shader.setInteger("cells", 0);
+    this->shader.setVector2f("boardMin", boardMin);
+    this->shader.setVector2f("boardMax", boardMax);
+    this->shader.setFloat("pitch", layout.pitch);
+    this->shader.setFloat("cellSize", layout.cellSize);
+    this->shader.setFloat("outlineSize", layout.outlineSize);
+    this->shader.setVector2f("hover", -1, -1);
+    for (int ii = 0; ii < PALETTE_SIZE; ii++) {
+        this->shader.setVector4f(("palette[" + std::to_string(ii) + "]").c_str(), stateColor(ii, states).vec);
+    }
+    this->shader.setVector4f("outlineColor", RED.vec);
+}
+
+template <typename Upload>
+void BoardRenderer::uploadChangedRows(const std::vector<uint64_t> &rowGenerations, Upload upload) {
+    // Each run of consecutive changed rows is uploaded with one call
+    uploadedRows = 0;
+    for (int y = 0; y < height;) {
+        if (rowGenerations[y] == uploadedGenerations[y]) {
+            y++;
+            continue;
+        }
+        int end = y + 1;
+        while (end < height && rowGenerations[end] != uploadedGenerations[end]) { end++; }
+        upload(y, end - y);
+        std::copy(rowGenerations.begin() + y, rowGenerations.begin() + end, uploadedGenerations.begin() + y);
+        uploadedRows += end - y;
+        y = end;
+    }
+}
+
+void BoardRenderer::draw(const Board &board, const std::vector<uint64_t> &rowGenerations, int hoverIndex) {
+    GLState::get().activeTexture(GL_TEXTURE0);
+    GLState::get().bindTexture(GL_TEXTURE_2D, texture);
+    uploadChangedRows(rowGenerations, [&](int first, int count) { uploadRows(board, first, count); });
+    drawQuad(width, hoverIndex);
+}
+
+void BoardRenderer::draw(const ModBoard &cells, const std::vector<uint64_t> &rowGenerations, int hoverIndex) {
+    GLState::get().activeTexture(GL_TEXTURE0);
+    GLState::get().bindTexture(GL_TEXTURE_2D, texture);
+
+    // Rows are uploaded in place (the row length skips the padding of each row)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, cells.getStride());
+    uploadChangedRows(rowGenerations, [&](int first, int count) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, width, count, GL_RED, GL_UNSIGNED_BYTE, cells.row(first));
+    });
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    drawQuad(width, hoverIndex);
+}
+
+void BoardRenderer::drawQuad(int width, int hoverIndex) {
+    this->shader.use();
+    if (hoverIndex != this->hoverIndex) {
+        this->hoverIndex = hoverIndex;
+        if (hoverIndex >= 0) {
+            this->shader.setVector2f("hover", static_cast<float>(hoverIndex % width),
+                                     static_cast<float>(hoverIndex / width));
+        } else {
+            this->shader.setVector2f("hover", -1, -1);
+        }
+    }
+    GLState::get().bindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void BoardRenderer::uploadRows(const Board &board, int first, int count) {
+    const int width = board.getWidth();
+    const int batch = std::max(1, static_cast<int>(MAX_STAGING_BYTES / width));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (int y = first; y < first + count; y += batch) {
+        int rows = std::min(batch, first + count - y);
+        staging.resize(static_cast<size_t>(rows) * width);
+        for (int row = 0; row < rows; row++) {
+            const uint64_t *words = board.row(y + row);
+            uint8_t *out = &staging[static_cast<size_t>(row) * width];
+            for (int x = 0; x < width; x++) {
+                out[x] = words[x >> 6] >> (x & 63) & 1;
+            }
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, width, rows, GL_RED, GL_UNSIGNED_BYTE, staging.data());
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef GRAPHICS_BOARDRENDERER_H
+#define GRAPHICS_BOARDRENDERER_H
+
+#include <cstdint>
+#include <vector>
+#include "shader.h"
+#include "glResources.h"
+#include "../game/board.h"
+#include "../game/game.h"
+#include "../game/modBoard.h"
+
+/**
+ * @brief Draws a whole board with one quad, for boards too big for a shape per light.
+ * @details The board lives on the GPU as an R8 texture with one texel per light holding its state
+ * (one byte per cell, up to 8192x8192), and the shader looks each state up in a palette (stateColor()). The fragment shader (res/shaders/board.frag) works out which light each pixel
+ * belongs to and draws the lights, the gaps and the hover outline procedurally, so the draw costs the
+ * same for any board size. The renderer remembers the generation (see GameSnapshot) of each row in the texture,
+ * and only rows whose generation changed are sent again (a press touches at most three), so a frame doesn't
+ * compare or copy the whole board.
+ */
+class BoardRenderer {
+public:
+    /// @brief Creates the texture (filled in by the first draw)
+    /// @param shader The board shader (res/shaders/board.vert); its projection must already be set
+    /// @param layout Where the lights are drawn
+    /// @param board The initial board (only its size is used)
+    /// @param states Number of states of the lights (2 to PALETTE_SIZE)
+    BoardRenderer(Shader &shader, const BoardLayout &layout, const Board &board, int states = 2);
+
+    BoardRenderer(const BoardRenderer &) = delete;
+    BoardRenderer &operator=(const BoardRenderer &) = delete;
+
+    /// @brief Uploads the rows that changed since the last draw, then draws the board
+    /// @param board The board to draw (same size as the initial board)
+    /// @param rowGenerations Generation of each row of the board (see GameSnapshot)
+    /// @param hoverIndex Index (y * width + x) of the light to outline, or -1
+    void draw(const Board &board, const std::vector<uint64_t> &rowGenerations, int hoverIndex);
+
+    /// @brief Same for a board with more than two states
+    /// @details Its lights are already a byte each, so changed rows are uploaded straight from the board.
+    void draw(const ModBoard &cells, const std::vector<uint64_t> &rowGenerations, int hoverIndex);
+
+    /// @brief Sets the uniforms that stay the same from frame to frame (again after the shader is reloaded)
+    void setUniforms();
+
+    /// @brief Number of rows uploaded by the last draw()
+    int getUploadedRows() const { return uploadedRows; }
+
+private:
+    /// @brief Upper bound on the staging buffer (rows are uploaded in batches of at most this many bytes)
+    static const size_t MAX_STAGING_BYTES = 1 << 20;
+
+    Shader &shader;
+    BoardLayout layout;
+    int states;
+    GLVertexArray VAO;
+    GLTexture texture;
+
+    int width, height;
+    /// @brief Generation of each row in the texture (0 before it was first uploaded)
+    std::vector<uint64_t> uploadedGenerations;
+    std::vector<uint8_t> staging;
+    int hoverIndex = -1;
+    int uploadedRows = 0;
+
+    /// @brief Calls upload(first, count) for each run of consecutive rows whose generation changed
+    template <typename Upload>
+    void uploadChangedRows(const std::vector<uint64_t> &rowGenerations, Upload upload);
+
+    /// @brief Expands rows [first, first + count) to one byte per light and uploads them
+    void uploadRows(const Board &board, int first, int count);
+
+    /// @brief Updates the hover outline and draws the quad
+    void drawQuad(int width, int hoverIndex);
+};
+
+#endif //GRAPHICS_BOARDRENDERER_H
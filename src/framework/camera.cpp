@@ -0,0 +1,40 @@
+#include "camera.h"
+
+#include <algorithm>
+
+Camera::Camera(vec2 viewport) : viewport(viewport), center(viewport * 0.5f) {}
+
+mat4 Camera::getProjection() const {
+    vec2 min = getVisibleMin(), max = getVisibleMax();
+    return glm::ortho(min.x, max.x, min.y, max.y, -1.0f, 1.0f);
+}
+
+vec2 Camera::screenToWorld(vec2 screen) const {
+    return center + (screen - viewport * 0.5f) / zoom;
+}
+
+vec2 Camera::worldToScreen(vec2 world) const {
+    return (world - center) * zoom + viewport * 0.5f;
+}
+
+void Camera::pan(vec2 screenDelta) {
+    center -= screenDelta / zoom;
+}
+
+void Camera::zoomAt(vec2 screen, float factor) {
+    vec2 anchor = screenToWorld(screen);
+    zoom = std::clamp(zoom * factor, minZoom, maxZoom);
+    // Move the center so the anchor maps back onto the same window position
+    center = anchor - (screen - viewport * 0.5f) / zoom;
+}
+
+void Camera::reset() {
+    center = viewport * 0.5f;
+    zoom = 1;
+}
+
+void Camera::setZoomLimits(float minZoom, float maxZoom) {
+    this->minZoom = minZoom;
+    this->maxZoom = maxZoom;
+    zoom = std::clamp(zoom, minZoom, maxZoom);
+}
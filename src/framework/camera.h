@@ -0,0 +1,63 @@
+#ifndef GRAPHICS_CAMERA_H
+#define GRAPHICS_CAMERA_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using glm::vec2, glm::mat4;
+
+/**
+ * @brief A 2D camera over the board: which part of the world fills the window, and how large.
+ * @details World units are the pixels of the original layout, so the default camera (centered on
+ * the window, zoom 1) shows exactly what the fixed projection used to. The camera has no OpenGL state:
+ * the game moves it and uses it for picking, and the renderer turns it into a projection matrix.
+ */
+class Camera {
+public:
+    /// @brief Construct a camera showing the window at zoom 1
+    /// @param viewport Size of the window in pixels
+    explicit Camera(vec2 viewport = vec2(1, 1));
+
+    /// @brief Orthographic projection from world units to clip space
+    mat4 getProjection() const;
+
+    /// @brief Converts a window position (origin at the bottom left) to world units
+    vec2 screenToWorld(vec2 screen) const;
+
+    /// @brief Converts a world position to window coordinates
+    vec2 worldToScreen(vec2 world) const;
+
+    /// @brief Bottom left corner of the visible part of the world
+    vec2 getVisibleMin() const { return center - viewport * 0.5f / zoom; }
+    /// @brief Top right corner of the visible part of the world
+    vec2 getVisibleMax() const { return center + viewport * 0.5f / zoom; }
+
+    /// @brief Moves the view by a distance in screen pixels (the world follows the pointer)
+    void pan(vec2 screenDelta);
+
+    /// @brief Zooms by a factor, keeping the world point under a window position in place
+    void zoomAt(vec2 screen, float factor);
+
+    /// @brief Back to the initial view
+    void reset();
+
+    /// @brief Sets the range zoom is clamped to (e.g. so the smallest light can still be made big enough to click)
+    void setZoomLimits(float minZoom, float maxZoom);
+
+    vec2 getCenter() const   { return center; }
+    float getZoom() const    { return zoom; }
+    vec2 getViewport() const { return viewport; }
+
+    bool operator==(const Camera &other) const {
+        return center == other.center && zoom == other.zoom && viewport == other.viewport;
+    }
+    bool operator!=(const Camera &other) const { return !(*this == other); }
+
+private:
+    vec2 viewport;
+    vec2 center;
+    float zoom = 1;      // Window pixels per world unit
+    float minZoom = 0.25f, maxZoom = 16;
+};
+
+#endif //GRAPHICS_CAMERA_H
@@ -0,0 +1,42 @@
+#include "circleRenderer.h"
+
+#include <glad/glad.h>
+#include <cstddef>
+
+CircleRenderer::CircleRenderer(Shader &shader, StreamBuffer &stream) : shader(shader), stream(stream) {
+    this->initRenderData();
+}
+
+void CircleRenderer::initRenderData() {
+    // No vertex buffer: the quad's corners come from gl_VertexID
+    this->VAO.create("CircleRenderer");
+    GLState::get().bindVertexArray(this->VAO);
+
+    // Per-instance attributes; draw() points them at the frame's allocation in the stream buffer
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    GLState::get().bindVertexArray(0);
+}
+
+void CircleRenderer::draw(const vec2 *centers, const float *radii, const uint32_t *colors, size_t count) {
+    if (count == 0) { return; }
+
+    // Written straight into the stream buffer; no staging copy and no wait for the GPU
+    GLintptr offset;
+    auto *instances = static_cast<Instance *>(stream.map(count * sizeof(Instance), sizeof(Instance), offset));
+    if (!instances) { return; }
+    for (size_t ii = 0; ii < count; ii++) {
+        instances[ii] = {centers[ii].x, centers[ii].y, radii[ii], colors[ii]};
+    }
+    stream.unmap();
+
+    this->shader.use();
+    GLState::get().bindVertexArray(this->VAO);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, stream.getId());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, x)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)(offset + offsetof(Instance, color)));
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+}
@@ -0,0 +1,58 @@
+#ifndef GRAPHICS_CIRCLERENDERER_H
+#define GRAPHICS_CIRCLERENDERER_H
+
+#include <cstdint>
+#include <vector>
+#include "shader.h"
+#include "streamBuffer.h"
+#include "glResources.h"
+
+using glm::vec2;
+
+/**
+ * @brief Draws many circles with a single instanced draw call.
+ * @details Each circle is one quad generated in the vertex shader; the fragment shader computes
+ * anti-aliased coverage from the distance to the center. The only GPU data per circle is its
+ * center, radius and packed color (16 bytes), instead of a triangle fan per circle.
+ */
+class CircleRenderer {
+public:
+    /**
+     * @brief Construct a new Circle Renderer object
+     * @details The shader must be the instanced circle shader (res/shaders/circleInstanced.vert)
+     *
+     * @param shader The shader to use
+     * @param stream Buffer the instance data is streamed through
+     */
+    CircleRenderer(Shader &shader, StreamBuffer &stream);
+
+    /**
+     * @brief Uploads and draws a set of circles
+     *
+     * @param centers The center of each circle
+     * @param radii The radius of each circle
+     * @param colors The packed RGBA8 color of each circle (see packColor())
+     * @param count The number of circles
+     */
+    void draw(const vec2 *centers, const float *radii, const uint32_t *colors, size_t count);
+
+private:
+    /// @brief Layout of one instance in the instance buffer
+    struct Instance {
+        float x, y, radius;
+        uint32_t color;
+    };
+
+    Shader &shader;
+    StreamBuffer &stream;
+
+    /// @brief The VAO (its instance attributes point into the stream buffer)
+    GLVertexArray VAO;
+
+    /**
+     * @brief Initializes and configures the buffer and vertex attributes
+     */
+    void initRenderData();
+};
+
+#endif //GRAPHICS_CIRCLERENDERER_H
@@ -2,6 +2,7 @@
 #define GRAPHICS_COLOR_H
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <iostream>
 #include <random>
 using std::ostream, glm::vec4;
@@ -29,6 +30,39 @@ typedef struct color {
     }
 } color;
 
+// Colors shared by the game and the renderer
+inline const color WHITE(1, 1, 1);
+inline const color GRAY(0.5, 0.5, 0.5);
+inline const color BLACK(0, 0, 0);
+inline const color YELLOW(1, 1, 0);
+inline const color RED(1, 0, 0);
+
+/// @brief Number of light states the renderer has colors for (see stateColor())
+const int PALETTE_SIZE = 8;
+
+/// @brief Color of a light in a given state: state 0 (off) is gray, the rest run from red to yellow
+/// @details With two states this is the classic gray and yellow.
+/// @param state The light's state (0 to states - 1)
+/// @param states Number of states of the board
+inline color stateColor(int state, int states) {
+    if (state <= 0) { return GRAY; }
+    float t = states > 2 ? static_cast<float>(state - 1) / static_cast<float>(states - 2) : 1.0f;
+    return {1, t, 0};
+}
+
+/// @brief Packs a color into a 32-bit RGBA8 value (red in the lowest byte).
+/// @details This matches an OpenGL vertex attribute of 4 GL_UNSIGNED_BYTEs with normalization on.
+inline uint32_t packColor(const color &c) {
+    auto channel = [](float f) { return static_cast<uint32_t>(glm::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(c.red) | (channel(c.green) << 8) | (channel(c.blue) << 16) | (channel(c.alpha) << 24);
+}
+
+/// @brief Unpacks a 32-bit RGBA8 value created by packColor().
+inline color unpackColor(uint32_t packed) {
+    return {(packed & 0xFF) / 255.0f, ((packed >> 8) & 0xFF) / 255.0f,
+            ((packed >> 16) & 0xFF) / 255.0f, ((packed >> 24) & 0xFF) / 255.0f};
+}
+
 
 //// How to do this with a class:
 //class Color {
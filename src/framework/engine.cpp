@@ -1,37 +1,33 @@
 #include "engine.h"
+#include "allocCounter.h"
 #include <iostream>
-#include <string>
+#include <algorithm>
 
 using namespace std;
 
-// Color objects
-const color WHITE(1, 1, 1);
-const color GRAY(0.5, 0.5, 0.5);
-const color BLACK(0, 0, 0);
-const color YELLOW(1, 1, 0);
-const color RED(1, 0, 0);
-
-// vec3 object representing the color for comparisons
-vec3 YELLOW_VECT = {YELLOW.red, YELLOW.green, YELLOW.blue};
-
-// counter for moves
-static int moveCount = 0;
-
-// Time keeping variables
-static int startTime, endTime;
+Engine::Engine(bool offscreen, int boardWidth, int boardHeight, int states)
+    : game(vec2(WIDTH, HEIGHT), boardWidth, boardHeight, states), offscreen(offscreen) {
+    this->initWindow();
 
+    // The render thread always has something to draw
+    publish();
+}
 
-enum state {start, instructions, play, over};
-state screen = start;
+Engine::~Engine() {
+    running = false;
+    if (renderThread.joinable()) {
+        renderThread.join();
+    }
 
-Engine::Engine() {
-    this->initWindow();
-    this->initShaders();
-    this->initShapes();
+    // Offscreen mode keeps the context on this thread, so GL objects can be deleted here
+    if (offscreen) {
+        recorder.reset();
+        framebuffer.reset();
+        renderer.reset();
+        GLResources::get().reportLeaks();
+    }
 }
 
-Engine::~Engine() = default;
-
 unsigned int Engine::initWindow(bool debug) {
     // glfw: initialize and configure
     glfwInit();
@@ -45,239 +41,296 @@ unsigned int Engine::initWindow(bool debug) {
 #endif
     glfwWindowHint(GLFW_RESIZABLE, false);
 
+    if (offscreen) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+        // Without a display server (see main), the only way to get a context is OSMesa (e.g. Mesa llvmpipe)
+        if (glfwGetPlatform() == GLFW_PLATFORM_NULL) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        }
+#endif
+    }
+
     window = glfwCreateWindow(WIDTH, HEIGHT, "engine", nullptr, nullptr);
+    if (window == nullptr) {
+        cout << "Failed to create GLFW window" << endl;
+        return -1;
+    }
     glfwMakeContextCurrent(window);
 
+    // The wheel only reports through a callback, so it's summed here and drained by processInput()
+    glfwSetWindowUserPointer(window, this);
+    glfwSetScrollCallback(window, [](GLFWwindow *w, double, double yOffset) {
+        static_cast<Engine *>(glfwGetWindowUserPointer(w))->scrollAccum += static_cast<float>(yOffset);
+    });
+
+    // Input is otherwise polled, but callbacks run while events are processed, which is the earliest
+    // the event can be timestamped. Only presses count: a release changes nothing on screen, so measuring
+    // it would add samples that are only as slow as the next frame.
+    glfwSetMouseButtonCallback(window, [](GLFWwindow *w, int, int action, int) {
+        if (action == GLFW_PRESS) {
+            static_cast<Engine *>(glfwGetWindowUserPointer(w))->noteInputEvent();
+        }
+    });
+    glfwSetKeyCallback(window, [](GLFWwindow *w, int, int, int action, int) {
+        if (action == GLFW_PRESS) {
+            static_cast<Engine *>(glfwGetWindowUserPointer(w))->noteInputEvent();
+        }
+    });
+
     // glad: load all OpenGL function pointers
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         cout << "Failed to initialize GLAD" << endl;
         return -1;
     }
 
-    // OpenGL configuration
+    // In windowed mode the context belongs to the render thread from here on
+    if (!offscreen) {
+        glfwMakeContextCurrent(nullptr);
+    }
+    return 0;
+}
+
+void Engine::run() {
+    running = true;
+    renderThread = std::thread(&Engine::renderLoop, this);
+
+    // Fixed-rate simulation: sleep until the next step is due, waking early only to handle window events
+    const double step = 1.0 / SIM_RATE;
+    double nextStep = glfwGetTime();
+    while (!shouldClose()) {
+        double now = glfwGetTime();
+        if (now < nextStep) {
+            glfwWaitEventsTimeout(nextStep - now);
+
+            // In low-latency mode a click is handled (and published) as soon as it arrives, not at the next step
+            if (lowLatency && pendingEventTime >= 0) {
+                processInput();
+                publish();
+            }
+            continue;
+        }
+
+        processInput();
+        update();
+
+        // Don't try to catch up on steps missed while the process was suspended
+        nextStep = std::max(nextStep + step, now - 0.25);
+    }
+
+    running = false;
+    renderThread.join();
+    inputLatency.print(lowLatency ? "Input to swap (low-latency mode)" : "Input to swap");
+}
+
+void Engine::initRenderer() {
+    // OpenGL configuration (the context is new to this thread, so nothing in the state cache applies)
+    GLState::get().invalidate();
     glViewport(0, 0, WIDTH, HEIGHT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::get().setBlend(true);
+    GLState::get().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    snapshots.update();
+    renderer = make_unique<Renderer>(WIDTH, HEIGHT, game.getLayout(), snapshots.readBuffer().board,
+                                      game.getStates());
+    if (!skin.empty()) {
+        renderer->loadSkin(skin);
+    }
+}
+
+void Engine::renderLoop() {
+    glfwMakeContextCurrent(window);
     glfwSwapInterval(1);
+    initRenderer();
+    // Only the interactive window reloads shaders: offscreen runs must draw the same frames every time
+    renderer->watchShaders();
 
-    return 0;
+    while (running) {
+        if (lowLatency) {
+            pacer.waitForDeadline();
+        }
+        render();
+    }
+
+    // GL objects have to be deleted while the context is still current
+    recorder.reset();
+    renderer.reset();
+    GLResources::get().reportLeaks();
+    glfwMakeContextCurrent(nullptr);
 }
 
-void Engine::initShaders() {
-    shaderManager = make_unique<ShaderManager>();
-    shapeShader = this->shaderManager->loadShader("../res/shaders/shape.vert",
-                                                  "../res/shaders/shape.frag",
-                                                  nullptr, "shape");
-    shapeShader.use();
-    shapeShader.setMatrix4("projection", this->PROJECTION);
-
-    // Configure text shader and renderer
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", FONT_SIZE);
-
-    // Set uniforms
-    textShader.use().setVector2f("vertex", vec4(100, 100, .5, .5));
-    shapeShader.use().setMatrix4("projection", this->PROJECTION);
+double Engine::runOffscreen(int frames, const InputState &input) {
+    if (!renderer) {
+        initRenderer();
+        framebuffer = make_unique<Framebuffer>(WIDTH, HEIGHT);
+    }
+    framebuffer->bind();
+
+    double start = glfwGetTime();
+    for (int frame = 0; frame < frames; frame++) {
+        game.processInput(input);
+        update();
+        render();
+    }
+    double elapsed = glfwGetTime() - start;
+
+    Framebuffer::unbind();
+    return frames > 0 ? elapsed * 1000.0 / frames : 0.0;
 }
 
-void Engine::initShapes() {
-    // Shape object for the cursor
-    cursor = make_unique<Rect>(shapeShader, vec2(10, 10), vec2(0, 0), WHITE);
+void Engine::record(const string &path) {
+    recordPath = path;
+    if (!recorder) {
+        recordToggleRequested = true;
+    }
+}
 
-    for (int column = 1; column <= 5; column++) {
-        for (int row = 1; row <= 5; row++) {
-            // This will probably just need to be guess-and-check
-            coordinateMatrix.push_back({column * 160, row * 160});
-        }
+void Engine::updateRecorder() {
+    if (!recordToggleRequested.exchange(false)) {
+        return;
+    }
+    if (recorder) {
+        recorder.reset();
+    } else {
+        recorder = make_unique<Recorder>(recordPath, WIDTH, HEIGHT);
     }
+}
 
+Image Engine::captureFrame() const {
+    Image image;
+    if (framebuffer) {
+        image.width = framebuffer->getWidth();
+        image.height = framebuffer->getHeight();
+        framebuffer->readPixels(image.pixels);
+    }
+    return image;
+}
 
-    for(int ii = 0; ii < NUM_LIGHTS; ii++) {
-        vector<int> coordVect = coordinateMatrix[ii];
-        lights.push_back(make_unique<Rect>(shapeShader, vec2{coordVect[0], coordVect[1]}, vec2{140, 140},
-                                           color{YELLOW.red, YELLOW.green, YELLOW.blue, YELLOW.alpha}));
-        redOutline.push_back(make_unique<Rect>(shapeShader, vec2{coordVect[0], coordVect[1]}, vec2{155, 155},
-                                           color{RED.red, RED.green, RED.blue, RED.alpha}));
+void Engine::noteInputEvent() {
+    if (pendingEventTime < 0) {
+        pendingEventTime = glfwGetTime();
     }
 }
 
 void Engine::processInput() {
     glfwPollEvents();
 
-    static bool mousePressedLastFrame = false;
-    vector<int> neighborVect;
-
-    // Close window if escape key is pressed
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, true);
-    }
+    InputState input;
 
     // Mouse position saved to check for collisions
+    double mouseX, mouseY;
     glfwGetCursorPos(window, &mouseX, &mouseY);
-    mouseY = HEIGHT - mouseY; // make sure mouse y-axis isn't flipped
-
-    cursor->setPosX(mouseX);
-    cursor->setPosY(mouseY);
-
-    switch (screen) {
-        case start: {
-            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-                startTime = clock();
-                screen = play;
-            } else if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) { screen = instructions; }
-            break;
-        }
-        case instructions: {
-            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-                startTime = clock();
-                screen = play;
-            }
-            break;
-        }
-        case play: {
-            // Variable to hold mouse press status
-            bool mousePressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
-
-            // If the mouse has been pressed and released, we're gonna do a bunch of stuff
-            // For all the lights, if they were overlapping, invert the color of it and
-            // the color of its neighbors. The logic for the neighbors is brute-forced
-            // because I didn't have time to write a generalized system. Save the hovered-over
-            // node to render its outline
-            for (int ii = 0; ii < lights.size(); ii++) {
-                if (lights[ii]->isOverlapping(*cursor)) {
-                    if (!mousePressed && mousePressedLastFrame) {
-                        moveCount++;
-                        // All this mess is the logic making vectors of the lights to invert
-                        if (ii == 0) { neighborVect = {ii, ii + 1, ii + 5}; }
-                        else if (ii == 4) { neighborVect = {ii, ii - 1, ii + 5}; }
-                        else if (ii == 20) { neighborVect = {ii, ii + 1, ii - 5}; }
-                        else if (ii == 24) { neighborVect = {ii, ii - 1, ii - 5}; }
-                        else if (ii >= 1 && ii <= 3) { neighborVect = {ii, ii - 1, ii + 1, ii + 5}; }
-                        else if (ii >= 21 && ii <= 23) { neighborVect = {ii, ii - 1, ii + 1, ii - 5}; }
-                        else if (ii == 5 || ii == 10 || ii == 15) { neighborVect = {ii, ii + 1, ii + 5, ii - 5}; }
-                        else if (ii == 9 || ii == 14 || ii == 19) { neighborVect = {ii, ii - 1, ii + 5, ii - 5}; }
-                        else { neighborVect = {ii, ii - 1, ii + 1, ii - 5, ii + 5}; }
-                        // Invert each light
-                        for (int jj: neighborVect) {
-                            if (lights[jj]->getColor3() == YELLOW_VECT) { lights[jj]->setColor(GRAY); }
-                            else { lights[jj]->setColor(YELLOW); }
-                        }
-                    }
-                    // Save the index of the hovered index
-                    hoverIndices.push_back(ii);
-                }
-            }
-            // Save the status of the mouse press
-            mousePressedLastFrame = mousePressed;
-            break;
-        }
+    input.mouse = vec2(mouseX, HEIGHT - mouseY); // make sure mouse y-axis isn't flipped
+
+    input.mouseLeft = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    input.keyStart = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.keyInstructions = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+    input.keyQuit = glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS;
+
+    // Camera: right-drag or arrows pan, wheel or +/- zoom, 0 resets
+    input.mouseRight = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+    input.scroll = scrollAccum;
+    scrollAccum = 0;
+    auto key = [this](int k) { return glfwGetKey(window, k) == GLFW_PRESS ? 1.0f : 0.0f; };
+    input.panKeys = vec2(key(GLFW_KEY_RIGHT) - key(GLFW_KEY_LEFT), key(GLFW_KEY_UP) - key(GLFW_KEY_DOWN));
+    input.zoomKeys = key(GLFW_KEY_EQUAL) - key(GLFW_KEY_MINUS);
+    input.keyResetView = glfwGetKey(window, GLFW_KEY_0) == GLFW_PRESS;
+
+    // History: z undoes, y redoes, b switches to the next branch
+    input.keyUndo = glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS;
+    input.keyRedo = glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS;
+    input.keyBranch = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+
+    // Levels: l opens the level select screen, r picks a random level
+    input.keyLevels = glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS;
+    input.keyRandomLevel = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+
+    game.processInput(input);
+    if (pendingEventTime >= 0) {
+        if (unpublishedEventTime < 0) { unpublishedEventTime = pendingEventTime; }
+        pendingEventTime = -1;
+    }
+
+    // F9 starts and stops recording; the render thread picks the request up before its next frame
+    bool recordKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+    if (recordKey && !recordKeyDown) {
+        recordToggleRequested = true;
+    }
+    recordKeyDown = recordKey;
+
+    // F8 prints the GPU memory in use (on the render thread, which owns the objects)
+    bool memoryKey = glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS;
+    if (memoryKey && !memoryKeyDown) {
+        memoryReportRequested = true;
+    }
+    memoryKeyDown = memoryKey;
+
+    // Close window if escape key is pressed
+    if (game.shouldQuit()) {
+        glfwSetWindowShouldClose(window, true);
     }
 }
 
 void Engine::update() {
-    // Change values of objects
-    // Calculate delta time
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
-
-    // If we're playing and all the lights are off, change screen to over (end the game)
-    if (screen == play) {
-        allLightsOff = true;
-        for (const unique_ptr<Rect> &light: lights) {
-            if (light->getRed() == YELLOW.red &&
-                light->getGreen() == YELLOW.green &&
-                light->getBlue() == YELLOW.blue) {
-                allLightsOff = false;
-            }
-        }
-        if (allLightsOff) {
-            endTime = clock();
-            screen = over;
-        }
+    game.update(static_cast<float>(1.0 / SIM_RATE));
+    publish();
+}
+
+void Engine::publish() {
+    GameSnapshot &snapshot = snapshots.writeBuffer();
+    game.writeSnapshot(snapshot);
+
+    // Events that reach the game together are measured as one, from the oldest
+    if (unpublishedEventTime >= 0) {
+        inputSerial++;
+        inputTime = unpublishedEventTime;
+        unpublishedEventTime = -1;
     }
+    snapshot.inputSerial = inputSerial;
+    snapshot.inputTime = inputTime;
+    snapshots.publish();
 }
 
 void Engine::render() {
-    // Draw objects
-    glClearColor(BLACK.red, BLACK.green, BLACK.blue, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    shapeShader.use();
-
-    switch (screen) {
-        case start: {
-            // TODO: Add instructions screen with text
-            // Display intro screen
-            string titleMessage = "Lights Out!";
-            string commandMessage1 = "Commands:";
-            string commandMessage2 = "[i] to show the directions";
-            string commandMessage3 = "[s] to launch the game";
-            string commandMessage4 = "[Esc] to quit";
-            this->fontRenderer->renderText(titleMessage, 260, 500, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(commandMessage1, 290, 270, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(commandMessage2, 100, 240, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(commandMessage3, 140, 210, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(commandMessage4, 250, 180, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            break;
-        }
-        case instructions: {
-            string titleMessage = "Lights Out!";
-            string instructionMessage1 = "The goal of this game is to";
-            string instructionMessage2 = "turn off all the lights.";
-            string instructionMessage3 = "Clicking a light inverts it as";
-            string instructionMessage4 = "well as its immediate neighbors.";
-            string instructionMessage5 = "Press [s] to launch the game when ready";
-            this->fontRenderer->renderText(titleMessage, 260, 500, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(instructionMessage1, 140, 300, 0.8, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(instructionMessage2, 170, 270, 0.8, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(instructionMessage3, 110, 240, 0.8, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(instructionMessage4, 95, 210, 0.8, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(instructionMessage5, 30, 180, 0.8, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            break;
-        }
-        case play: {
-            // Show the light squares and the hover outlines if there are any
-            for(int ii = 0; ii < hoverIndices.size(); ii++) {
-                redOutline[hoverIndices[ii]]->setUniforms();
-                redOutline[hoverIndices[ii]]->draw();
-                hoverIndices.pop_back();
-            }
-            for (const unique_ptr<Rect> &light: lights) {
-                light->setUniforms();
-                light->draw();
-            }
-
-            // Display the moves taken and the timer
-            string movesMessage = "Moves: " + to_string(moveCount);
-            string timerMessage = "Time: " + to_string((clock() - startTime) / 1000);
-            this->fontRenderer->renderText(movesMessage, 550, 400, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(timerMessage, 550, 200, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
+    AllocCounter::Counts before = AllocCounter::thisThread();
+    double start = glfwGetTime();
 
-            break;
-        }
-        case over: {
-            // Show the lights all turned off
-            for (const unique_ptr<Rect> &light: lights) {
-                light->setUniforms();
-                light->draw();
-            }
+    // Draw the newest snapshot (or the previous one again if the simulation hasn't stepped since)
+    snapshots.update();
+    renderer->render(snapshots.readBuffer());
 
-            // Show win message
-            string winMessage = "Winner!";
-            string movesMessage = "Moves: " + to_string(moveCount);
-            string timerMessage = "Time: " + to_string((endTime - startTime) / 1000);
-            this->fontRenderer->renderText(winMessage, 220, 290, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(movesMessage, 550, 400, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            this->fontRenderer->renderText(timerMessage, 550, 200, 1, vec3{WHITE.red, WHITE.green, WHITE.blue});
-            break;
+    updateRecorder();
+    if (memoryReportRequested.exchange(false)) {
+        GLResources::get().printUsage();
+    }
+    if (recorder) {
+        recorder->capture(framebuffer ? framebuffer->getId() : 0);
+    }
+    GLState::get().endFrame();
+    frameAllocations = AllocCounter::thisThread().allocations - before.allocations;
+
+    if (offscreen) {
+        // Nothing to present; wait for the GPU so frame timings include the actual drawing
+        glFinish();
+    } else {
+        // In low-latency mode the driver may not queue frames ahead: finishing first makes the draw time
+        // measurable, finishing after the swap makes it return at the refresh instead of when queued
+        if (lowLatency) { glFinish(); }
+        double drawn = glfwGetTime();
+        glfwSwapBuffers(window);
+        if (lowLatency) { glFinish(); }
+        double swapped = glfwGetTime();
+        pacer.frameDone(drawn - start, swapped);
+
+        // The first swap showing a new input event ends its measurement (the display adds its scanout delay)
+        const GameSnapshot &shown = snapshots.readBuffer();
+        if (shown.inputSerial != measuredSerial) {
+            measuredSerial = shown.inputSerial;
+            inputLatency.add((swapped - shown.inputTime) * 1000.0);
         }
     }
-    cursor->setUniforms();
-    cursor->draw();
-    glfwSwapBuffers(window);
 }
 
 bool Engine::shouldClose() {
     return glfwWindowShouldClose(window);
-}
\ No newline at end of file
+}
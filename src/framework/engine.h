@@ -1,87 +1,166 @@
 #ifndef GRAPHICS_ENGINE_H
 #define GRAPHICS_ENGINE_H
 
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <thread>
 #include <iostream>
 #include <GLFW/glfw3.h>
 
-#include "shaderManager.h"
-#include "../shapes/circle.h"
-#include "../shapes/rect.h"
-#include "../shapes/shape.h"
-#include "fontRenderer.h"
+#include "renderer.h"
+#include "tripleBuffer.h"
+#include "framebuffer.h"
+#include "image.h"
+#include "recorder.h"
+#include "glResources.h"
+#include "latencyStats.h"
+#include "../game/game.h"
+#include "../game/gameSnapshot.h"
 
-using std::vector, std::unique_ptr, std::make_unique, glm::ortho, glm::mat4, glm::vec3, glm::vec4;
+using std::vector, std::string, std::unique_ptr, std::make_unique;
 
 /**
  * @brief The Engine class.
- * @details The Engine class is responsible for initializing the GLFW window, loading shaders, and rendering the game state.
+ * @details The Engine class owns the GLFW window and runs the game on two threads:
+ * - The main thread polls input (GLFW requires this) and steps the Game at a fixed rate,
+ *   publishing a snapshot of the game state after every step.
+ * - The render thread owns the OpenGL context and draws the most recent snapshot.
+ * Snapshots are handed over through a lock-free triple buffer, so a slow frame or a vsync wait
+ * never delays input handling, and the renderer never sees a half-written state.
+ *
+ * In offscreen mode the window stays hidden (or, on GLFW's null platform, doesn't exist at all) and
+ * frames are drawn into a Framebuffer on the calling thread, so they can be read back for
+ * golden-image tests and render benchmarks on machines without a display.
  */
 class Engine {
     private:
-        const int NUM_LIGHTS = 25;
-        const int FONT_SIZE = 24;
-
         /// @brief The actual GLFW window.
         GLFWwindow* window{};
 
         /// @brief The width and height of the window.
         const int WIDTH = 1300, HEIGHT = 960; // Window dimensions
 
-        /// @brief Responsible for loading and storing all the shaders used in the project.
-        /// @details Initialized in initShaders()
-        unique_ptr<ShaderManager> shaderManager;
-        unique_ptr<FontRenderer> fontRenderer;
+        /// @brief Simulation steps per second.
+        const double SIM_RATE = 120.0;
+
+        /// @brief Game state, only touched by the simulation (main) thread.
+        Game game;
+
+        /// @brief Snapshots handed from the simulation thread to the render thread.
+        TripleBuffer<GameSnapshot> snapshots;
+
+        /// @brief Draws snapshots; created and destroyed on the render thread.
+        unique_ptr<Renderer> renderer;
+        /// @brief Skin directory handed to the renderer when it is created (empty for flat squares)
+        string skin;
+
+        /// @brief Render into a framebuffer on the calling thread instead of a visible window.
+        bool offscreen;
+        unique_ptr<Framebuffer> framebuffer;
+
+        std::thread renderThread;
+        std::atomic<bool> running{false};
+
+        /// @brief Recording state: the recorder lives on the render thread; the main thread only flips the request flag.
+        unique_ptr<Recorder> recorder;
+        std::atomic<bool> recordToggleRequested{false};
+        string recordPath = "recording.gif";
+        bool recordKeyDown = false;
+
+        /// @brief F8 prints the GPU memory in use; the registry belongs to the render thread, which prints it.
+        std::atomic<bool> memoryReportRequested{false};
+        bool memoryKeyDown = false;
+
+        /// @brief Heap allocations made by the last render() (zero once the caches and arenas have warmed up).
+        size_t frameAllocations = 0;
+
+        /// @brief Mouse wheel notches since the last input poll (main thread only).
+        float scrollAccum = 0;
+
+        /// @brief Latency instrumentation (main thread): when the oldest click or key press not yet handed to
+        /// the game happened, the same for events handed over but not yet published, and the last event's number.
+        double pendingEventTime = -1;
+        double unpublishedEventTime = -1;
+        uint32_t inputSerial = 0;
+        double inputTime = 0;
 
-        // Shapes
-        vector<vector<int>> coordinateMatrix;   // A 2-D vector of coordinates for the lights
-        vector<unique_ptr<Rect>> lights;
-        vector<unique_ptr<Rect>> redOutline;
-        unique_ptr<Rect> cursor;
-        vector<int> hoverIndices;
+        /// @brief Latency instrumentation (render thread): event-to-swap times, and the last event measured.
+        LatencyStats inputLatency;
+        uint32_t measuredSerial = 0;
 
-        // Shaders
-        Shader shapeShader;
-        Shader textShader;
+        /// @brief Low-latency mode: frames start just before the swap deadline and input is handled as it arrives.
+        std::atomic<bool> lowLatency{false};
+        FramePacer pacer;
 
-        double mouseX{}, mouseY{};
-        bool allLightsOff{};
+        /// @brief Copies the game state into the snapshot buffer and hands it to the render thread.
+        void publish();
+
+        /// @brief Timestamps a click or key press (GLFW callbacks, main thread).
+        void noteInputEvent();
+
+        /// @brief Starts or stops the recorder if the main thread asked for it (render thread only).
+        void updateRecorder();
+
+        /// @brief Body of the render thread: takes the context, renders until stopped, then releases it.
+        void renderLoop();
+
+        /// @brief Sets the GL state and creates the renderer (on the thread that has the context).
+        void initRenderer();
 public:
         /// @brief Constructor for the Engine class.
-        /// @details Initializes window and shaders.
-        Engine();
+        /// @details Initializes the window and publishes the first snapshot.
+        /// @param offscreen Use a hidden window and draw into a framebuffer (see runOffscreen())
+        /// @param boardWidth Number of columns of lights
+        /// @param boardHeight Number of rows of lights
+        /// @param states Number of states each light cycles through (2 to PALETTE_SIZE)
+        explicit Engine(bool offscreen = false, int boardWidth = 5, int boardHeight = 5, int states = 2);
 
         /// @brief Destructor for the Engine class.
+        /// @details Stops the render thread if it is still running. Once the GL objects are deleted, any that
+        /// are left are reported as leaks (see GLResources::reportLeaks()).
         ~Engine();
 
         /// @brief Initializes the GLFW window.
         /// @return 0 if successful, -1 otherwise.
         unsigned int initWindow(bool debug = false);
 
-        /// @brief Loads shaders from files and stores them in the shaderManager.
-        /// @details Renderers are initialized here.
-        void initShaders();
+        /// @brief Runs the game until the window is closed.
+        /// @details Starts the render thread and runs input and simulation on the calling (main) thread.
+        void run();
+
+        /// @brief Steps and renders frames into the offscreen framebuffer, all on the calling thread.
+        /// @details Every frame runs one simulation step with the given input and waits for the GPU to finish,
+        /// so the result is deterministic and the timing covers the whole render() path.
+        /// @param frames Number of frames to render
+        /// @param input Input applied on every step
+        /// @return Average milliseconds per frame
+        double runOffscreen(int frames, const InputState &input = InputState());
 
-        /// @brief Initializes the shapes to be rendered.
-        void initShapes();
+        /// @brief Starts recording to the given file (stopped again with F9)
+        /// @param path Output file; ".gif" files are encoded as GIF, anything else receives raw RGBA frames
+        void record(const string &path);
+
+        /// @brief Trades throughput for responsiveness (see FramePacer); call before run()
+        void setLowLatency(bool enabled) { lowLatency = enabled; }
+
+        /// @brief Draws the lights with the images in a skin directory (see Renderer::loadSkin()); call before
+        /// run() or runOffscreen()
+        void setSkin(const string &directory) { skin = directory; }
+
+        /// @brief Reads back the last frame drawn by runOffscreen()
+        Image captureFrame() const;
 
         /// @brief Processes input from the user.
-        /// @details (e.g. keyboard input, mouse input, etc.)
+        /// @details Samples the keyboard and mouse and hands them to the game.
         void processInput();
 
-        /// @brief Updates the game state.
-        /// @details (e.g. collision detection, delta time, etc.)
+        /// @brief Updates the game state by one fixed step and publishes a snapshot.
         void update();
 
-        /// @brief Renders the game state.
-        /// @details Displays/renders objects on the screen.
+        /// @brief Renders the most recent snapshot (render thread only).
         void render();
 
-        /* deltaTime variables */
-        float deltaTime = 0.0f; // Time between current frame and last frame
-        float lastFrame = 0.0f; // Time of last frame (used to calculate deltaTime)
-
         // -----------------------------------
         // Getters
         // -----------------------------------
@@ -92,15 +171,11 @@ public:
         /// @return false if the window should not close
         bool shouldClose();
 
-        /// Projection matrix used for 2D rendering (orthographic projection).
-        /// We don't have to change this matrix since the screen size never changes.
-        /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
-        /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
-        /// @note The projection matrix is used in the vertex shader.
-        // 1st quadrant
-        mat4 PROJECTION = ortho(0.0f, static_cast<float>(WIDTH), 0.0f, static_cast<float>(HEIGHT), -1.0f, 1.0f);
-        // 4th quadrant
-        // mat4 PROJECTION = ortho(0.0f, static_cast<float>(WIDTH), static_cast<float>(HEIGHT), 0.0f, -1.0f, 1.0f);
+        /// @brief Returns how many heap allocations the last render() made on the render thread
+        size_t getFrameAllocations() const { return frameAllocations; }
+
+        /// @brief The game (only use it from the thread that calls run(), and not while it is running)
+        Game &getGame() { return game; }
 };
 
-#endif //GRAPHICS_ENGINE_H
\ No newline at end of file
+#endif //GRAPHICS_ENGINE_H
@@ -1,5 +1,6 @@
 #include "font.h"
 #include <glad/glad.h>
+#include "glState.h"
 
 #include <iostream>
 
@@ -36,9 +37,8 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
         }
 
         // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLTexture &texture = textures.emplace_back("Font");
+        GLState::get().bindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
                 GL_TEXTURE_2D,
                 0,
@@ -50,6 +50,7 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
                 GL_UNSIGNED_BYTE,
                 face->glyph->bitmap.buffer
         );
+        texture.setBytes(GLResources::textureBytes(face->glyph->bitmap.width, face->glyph->bitmap.rows, 1));
 
         // set texture options
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -59,19 +60,25 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
 
         // now store character for later use
         Character character = {
-                texture,
+                texture.get(),
                 glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
                 glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
                 static_cast<unsigned int>(face->glyph->advance.x)
         };
         Characters.insert(std::pair<char, Character>(c, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::get().bindTexture(GL_TEXTURE_2D, 0);
 
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
 }
 
-std::map<char, Character> Font::getCharacters() const {
+const std::map<char, Character> &Font::getCharacters() const {
     return Characters;
-}
\ No newline at end of file
+}
+
+const Character &Font::getCharacter(char c) const {
+    static const Character missing = {};
+    auto character = Characters.find(c);
+    return character != Characters.end() ? character->second : missing;
+}
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 
 #include <glm/glm.hpp>
@@ -10,6 +11,8 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "glResources.h"
+
 /**
  * @brief A single character
  * @details This struct is used to store information about a single character
@@ -28,7 +31,8 @@ struct Character {
 
 /**
  * @brief A font
- * @details This class is used to store information about a font
+ * @details This class is used to store information about a font. It owns the glyph textures, which are
+ * deleted along with it, so it can be moved but not copied.
  */
 class Font {
 public:
@@ -46,7 +50,14 @@ public:
      *
      * @return a map of characters
      */
-    std::map<char, Character> getCharacters() const;
+    const std::map<char, Character> &getCharacters() const;
+
+    /**
+     * @brief Get a single character
+     *
+     * @return the character, or an empty one (no texture, no advance) if the font doesn't have it
+     */
+    const Character &getCharacter(char c) const;
 
 private:
     /**
@@ -54,6 +65,11 @@ private:
      */
     std::map<char, Character> Characters;
 
+    /**
+     * @brief The glyph textures the characters point to
+     */
+    std::vector<GLTexture> textures;
+
 };
 
 #endif //GRAPHICS_FONT_H
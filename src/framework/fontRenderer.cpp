@@ -1,53 +1,49 @@
 #include "fontRenderer.h"
 
 #include <glad/glad.h>
+#include <cstring>
 
-FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
-    this->shader = shader;
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize)
+    : shader(shader), stream(stream), font(fontPath, fontSize) {
     this->initRenderData();
-    Font myFont(fontPath, fontSize);
-    this->font = myFont.getCharacters();
-}
-
-FontRenderer::~FontRenderer() {
-    glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &this->VBO);
 }
 
 void FontRenderer::initRenderData() {
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    this->VAO.create("FontRenderer");
+    GLState::get().bindVertexArray(this->VAO);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, stream.getId());
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::get().bindVertexArray(0);
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, float scale, glm::vec3 color) {
+void FontRenderer::renderText(std::string_view text, float x, float y, float scale, glm::vec3 color) {
+    if (text.empty()) { return; }
+
     // activate corresponding render state
 
     this->shader.use();
     glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
     glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+    GLState::get().activeTexture(GL_TEXTURE0);
+    GLState::get().bindVertexArray(this->VAO);
 
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
+    // write the quads of all characters into one allocation (6 vertices of 4 floats per character)
+    const size_t vertexSize = 4 * sizeof(float);
+    GLintptr offset;
+    auto *vertices = static_cast<float (*)[4]>(stream.map(text.size() * 6 * vertexSize, vertexSize, offset));
+    if (!vertices) { return; }
+    for (char c : text) {
+        const Character &ch = font.getCharacter(c);
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
+        const float quad[6][4] = {
                 { xpos,     ypos + h,   0.0f, 0.0f },
                 { xpos,     ypos,       0.0f, 1.0f },
                 { xpos + w, ypos,       1.0f, 1.0f },
@@ -56,18 +52,19 @@ void FontRenderer::renderText(std::string text, float x, float y, float scale, g
                 { xpos + w, ypos,       1.0f, 1.0f },
                 { xpos + w, ypos + h,   1.0f, 0.0f }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        memcpy(vertices, quad, sizeof(quad));
+        vertices += 6;
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
     }
+    stream.unmap();
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+    // render each glyph texture over its quad; the attribute starts at the beginning of the buffer,
+    // so the allocation's offset turns into the first vertex index
+    GLint first = static_cast<GLint>(offset / vertexSize);
+    for (char c : text) {
+        GLState::get().bindTexture(GL_TEXTURE_2D, font.getCharacter(c).TextureID);
+        glDrawArrays(GL_TRIANGLES, first, 6);
+        first += 6;
+    }
+}
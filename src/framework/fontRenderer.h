@@ -1,9 +1,13 @@
 #ifndef FONTRENDERER_H
 #define FONTRENDERER_H
 
+#include <string_view>
+
 #include "shaderManager.h"
 #include "shader.h"
 #include "font.h"
+#include "streamBuffer.h"
+#include "glResources.h"
 
 /**
  * @brief A font renderer
@@ -16,19 +20,15 @@ public:
      * @details This constructor will call the font constructor and initialize the render data
      *
      * @param shader The shader to use
+     * @param stream Buffer the glyph quads are streamed through
      * @param fontPath The path to the font file
      * @param fontSize The size of the font
      */
-    FontRenderer(Shader& shader, std::string fontPath, int fontSize);
-
-    /**
-     * @brief Destroy the Font Renderer object
-     * @details destroys the VAO and VBO associated with the font renderer
-     */
-    ~FontRenderer();
+    FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize);
 
     /**
      * @brief Renders text on the screen
+     * @details The quads of the whole string are uploaded at once; each glyph is then drawn from its own range
      *
      * @param text The text to render
      * @param x The x position of the text
@@ -36,18 +36,23 @@ public:
      * @param scale The scale of the text
      * @param color The color of the text
      */
-    void renderText(std::string text, float x, float y, float scale, glm::vec3 color);
+    void renderText(std::string_view text, float x, float y, float scale, glm::vec3 color);
 
 private:
     /**
-     * @brief The shader to use
+     * @brief The shader to use (owned by the ShaderManager, so a reloaded program is picked up)
+     */
+    Shader &shader;
+
+    /**
+     * @brief The buffer the glyph quads are written to
      */
-    Shader shader;
+    StreamBuffer& stream;
 
     /**
-     * @brief The VAO and VBO associated with the font renderer
+     * @brief The VAO associated with the font renderer (its attribute reads from the stream buffer)
      */
-    GLuint VAO, VBO;
+    GLVertexArray VAO;
 
     /**
      * @brief The projection matrix
@@ -55,10 +60,9 @@ private:
     glm::mat4 projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f); // TODO: decide if this should be here or constant in engine class
 
     /**
-     * @brief A set of character structs mapped to their ASCII character representations
-     * @details This is the same map generated by the font class
+     * @brief The font's glyphs (their textures live as long as the renderer)
      */
-    std::map<char, Character> font;
+    Font font;
 
     /**
      * @brief Initializes and configures the buffer and vertex attributes
@@ -0,0 +1,61 @@
+#include "frameArena.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t capacity) : block(new char[capacity]), capacity(capacity) {}
+
+void *FrameArena::allocate(size_t bytes, size_t alignment) {
+    // Align the address rather than the offset: new char[] only guarantees max_align_t
+    auto base = reinterpret_cast<uintptr_t>(block.get());
+    uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (start + bytes <= base + capacity) {
+        used = start + bytes - base;
+        return reinterpret_cast<void *>(start);
+    }
+
+    // Doesn't fit: take it from the heap for now, reset() makes the block big enough for next time
+    overflow.emplace_back(new char[bytes + alignment]);
+    overflowBytes += bytes + alignment;
+    auto extra = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void *>((extra + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+void FrameArena::reset() {
+    size_t total = used + overflowBytes;
+    highWater = std::max(highWater, total);
+    if (!overflow.empty()) {
+        overflow.clear();
+        overflowBytes = 0;
+        capacity = std::max(capacity * 2, highWater + highWater / 2);
+        block.reset(new char[capacity]);
+    }
+    used = 0;
+}
+
+std::string_view FrameArena::format(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list retry;
+    va_copy(retry, args);
+
+    // Try to format into whatever is left of the block; only measure and retry if that's too small
+    size_t space = capacity - used;
+    char *text = static_cast<char *>(allocate(0, 1));
+    int length = vsnprintf(text, space, fmt, args);
+    va_end(args);
+    if (length < 0) {
+        va_end(retry);
+        return {};
+    }
+    if (static_cast<size_t>(length) < space) {
+        allocate(length + 1, 1);
+    } else {
+        text = static_cast<char *>(allocate(length + 1, 1));
+        vsnprintf(text, length + 1, fmt, retry);
+    }
+    va_end(retry);
+    return {text, static_cast<size_t>(length)};
+}
@@ -0,0 +1,100 @@
+#ifndef GRAPHICS_FRAMEARENA_H
+#define GRAPHICS_FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A linear allocator for data that only lives until the end of the frame.
+ * @details Allocating bumps a pointer; nothing is freed individually, reset() takes everything back
+ * at once. If a frame needs more than the block holds, the extra comes from the heap and the block
+ * is regrown at the next reset() to fit, so after the first few frames the arena stops touching the
+ * heap altogether. Not thread-safe: use one arena per thread.
+ */
+class FrameArena {
+public:
+    /// @brief Allocates the block
+    /// @param capacity Initial size of the block in bytes
+    explicit FrameArena(size_t capacity = 64 * 1024);
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /// @brief Returns uninitialized memory that stays valid until the next reset()
+    /// @param bytes Size of the allocation
+    /// @param alignment Alignment of the allocation (a power of two)
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /// @brief Releases everything allocated since the last reset, growing the block if it overflowed
+    void reset();
+
+    /// @brief Formats like printf into arena memory
+    /// @return The formatted text, valid until the next reset()
+    std::string_view format(const char *fmt, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /// @brief Returns the bytes allocated since the last reset (including overflow)
+    size_t getUsed() const { return used + overflowBytes; }
+
+    /// @brief Returns the size of the block
+    size_t getCapacity() const { return capacity; }
+
+    /// @brief Returns the most bytes any frame has used so far
+    size_t getHighWater() const { return highWater; }
+
+private:
+    std::unique_ptr<char[]> block;
+    size_t capacity;
+    size_t used = 0;
+    size_t highWater = 0;
+
+    /// @brief Allocations that didn't fit in the block, freed at the next reset()
+    std::vector<std::unique_ptr<char[]>> overflow;
+    size_t overflowBytes = 0;
+};
+
+/**
+ * @brief Standard allocator handing out FrameArena memory, so containers can be built per frame.
+ * @details deallocate() does nothing: the memory comes back when the arena is reset. Containers using
+ * it must not outlive the frame.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena &arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.getArena()) {}
+
+    T *allocate(size_t count) {
+        return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) {}
+
+    FrameArena *getArena() const { return arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.getArena(); }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.getArena(); }
+
+private:
+    FrameArena *arena;
+};
+
+/// @brief Frame-scoped containers
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+#endif //GRAPHICS_FRAMEARENA_H
@@ -0,0 +1,40 @@
+#include "framebuffer.h"
+
+#include <glad/glad.h>
+#include <iostream>
+
+Framebuffer::Framebuffer(int width, int height)
+    : width(width), height(height), FBO("Framebuffer"), colorRBO("Framebuffer") {
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    colorRBO.setBytes(static_cast<size_t>(width) * height * 4);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    if (!isComplete()) {
+        std::cout << "ERROR::FRAMEBUFFER: Framebuffer is not complete" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+}
+
+void Framebuffer::unbind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::readPixels(std::vector<uint8_t> &pixels) const {
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+bool Framebuffer::isComplete() const {
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
@@ -0,0 +1,49 @@
+#ifndef GRAPHICS_FRAMEBUFFER_H
+#define GRAPHICS_FRAMEBUFFER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "glResources.h"
+
+/**
+ * @brief An offscreen render target.
+ * @details A framebuffer object with an RGBA8 color renderbuffer. While it is bound, everything
+ * the renderer draws ends up here instead of in the window, and can be read back to the CPU.
+ */
+class Framebuffer {
+public:
+    /// @brief Creates the framebuffer (requires a current OpenGL context)
+    /// @param width Width in pixels
+    /// @param height Height in pixels
+    Framebuffer(int width, int height);
+
+    Framebuffer(const Framebuffer &) = delete;
+    Framebuffer &operator=(const Framebuffer &) = delete;
+
+    /// @brief Directs drawing into this framebuffer
+    void bind() const;
+
+    /// @brief Directs drawing back to the window
+    static void unbind();
+
+    /// @brief Reads the color buffer back (blocks until the GPU has finished drawing)
+    /// @param pixels Receives width * height RGBA pixels, bottom row first
+    void readPixels(std::vector<uint8_t> &pixels) const;
+
+    /// @brief Returns true if the framebuffer is complete and can be drawn into
+    bool isComplete() const;
+
+    /// @brief Returns the OpenGL framebuffer object name (e.g. to blit from it)
+    unsigned int getId() const { return FBO; }
+
+    int getWidth() const  { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width, height;
+    GLFramebuffer FBO;
+    GLRenderbuffer colorRBO;
+};
+
+#endif //GRAPHICS_FRAMEBUFFER_H
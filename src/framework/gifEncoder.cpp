@@ -0,0 +1,158 @@
+#include "gifEncoder.h"
+
+#include <iostream>
+
+namespace {
+const int RED_LEVELS = 6, GREEN_LEVELS = 7, BLUE_LEVELS = 6;
+const int MIN_CODE_SIZE = 8;
+const int CLEAR_CODE = 1 << MIN_CODE_SIZE;
+const int MAX_CODE = 4095;
+const int HASH_SIZE = 8192; // Power of two larger than the 4096 possible codes
+}
+
+GifEncoder::GifEncoder(const std::string &path, int width, int height, int delayCentiseconds)
+    : width(width), height(height), delay(delayCentiseconds) {
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::GIF: Failed to open " << path << std::endl;
+        return;
+    }
+    indices.resize(static_cast<size_t>(width) * height);
+    hashKeys.resize(HASH_SIZE);
+    hashCodes.resize(HASH_SIZE);
+
+    // Header and logical screen descriptor with a 256-entry global color table
+    fwrite("GIF89a", 1, 6, file);
+    put16(width);
+    put16(height);
+    fputc(0xF7, file); // Global color table, 8 bits per channel, 2^(7+1) entries
+    fputc(0, file);    // Background color
+    fputc(0, file);    // Pixel aspect ratio
+
+    // The palette: every combination of the channel levels, then black padding
+    for (int ii = 0; ii < 256; ii++) {
+        int r = 0, g = 0, b = 0;
+        if (ii < RED_LEVELS * GREEN_LEVELS * BLUE_LEVELS) {
+            r = (ii / (GREEN_LEVELS * BLUE_LEVELS)) * 255 / (RED_LEVELS - 1);
+            g = ((ii / BLUE_LEVELS) % GREEN_LEVELS) * 255 / (GREEN_LEVELS - 1);
+            b = (ii % BLUE_LEVELS) * 255 / (BLUE_LEVELS - 1);
+        }
+        fputc(r, file);
+        fputc(g, file);
+        fputc(b, file);
+    }
+
+    // Netscape extension: loop forever
+    const uint8_t loop[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+                            0x03, 0x01, 0x00, 0x00, 0x00};
+    fwrite(loop, 1, sizeof(loop), file);
+}
+
+GifEncoder::~GifEncoder() {
+    if (file) {
+        fputc(0x3B, file); // Trailer
+        fclose(file);
+    }
+}
+
+void GifEncoder::addFrame(const uint8_t *rgba, bool bottomUp) {
+    if (!file) { return; }
+
+    // Quantize to the fixed palette (rounding each channel to its nearest level)
+    for (int y = 0; y < height; y++) {
+        const uint8_t *src = rgba + static_cast<size_t>(bottomUp ? height - 1 - y : y) * width * 4;
+        uint8_t *dst = &indices[static_cast<size_t>(y) * width];
+        for (int x = 0; x < width; x++, src += 4) {
+            int r = (src[0] * (RED_LEVELS - 1) + 127) / 255;
+            int g = (src[1] * (GREEN_LEVELS - 1) + 127) / 255;
+            int b = (src[2] * (BLUE_LEVELS - 1) + 127) / 255;
+            dst[x] = static_cast<uint8_t>((r * GREEN_LEVELS + g) * BLUE_LEVELS + b);
+        }
+    }
+
+    // Graphic control extension (frame delay), then the image descriptor covering the whole screen
+    const uint8_t control[] = {0x21, 0xF9, 0x04, 0x00, static_cast<uint8_t>(delay & 0xFF),
+                               static_cast<uint8_t>(delay >> 8), 0x00, 0x00};
+    fwrite(control, 1, sizeof(control), file);
+    fputc(0x2C, file);
+    put16(0);
+    put16(0);
+    put16(width);
+    put16(height);
+    fputc(0, file); // No local color table, not interlaced
+
+    fputc(MIN_CODE_SIZE, file);
+    compress();
+    fputc(0, file); // Block terminator
+}
+
+void GifEncoder::compress() {
+    int codeSize = MIN_CODE_SIZE + 1;
+    int nextCode = CLEAR_CODE + 2;
+    std::fill(hashKeys.begin(), hashKeys.end(), -1);
+    bitBuffer = 0;
+    bitCount = 0;
+    block.clear();
+
+    writeCode(CLEAR_CODE, codeSize);
+    int prefix = indices[0];
+    for (size_t ii = 1; ii < indices.size(); ii++) {
+        int pixel = indices[ii];
+        int32_t key = (prefix << 8) | pixel;
+
+        // Look the (prefix, pixel) string up in the dictionary
+        uint32_t slot = (static_cast<uint32_t>(key) * 2654435761u) >> 19;
+        while (hashKeys[slot] != -1 && hashKeys[slot] != key) {
+            slot = (slot + 1) & (HASH_SIZE - 1);
+        }
+        if (hashKeys[slot] == key) {
+            prefix = hashCodes[slot];
+            continue;
+        }
+
+        // Not found: emit the prefix and add the new string
+        writeCode(prefix, codeSize);
+        hashKeys[slot] = key;
+        hashCodes[slot] = static_cast<uint16_t>(nextCode);
+        if (nextCode >= (1 << codeSize)) { codeSize++; }
+        if (++nextCode > MAX_CODE) {
+            // Dictionary full: start over
+            writeCode(CLEAR_CODE, codeSize);
+            std::fill(hashKeys.begin(), hashKeys.end(), -1);
+            codeSize = MIN_CODE_SIZE + 1;
+            nextCode = CLEAR_CODE + 2;
+        }
+        prefix = pixel;
+    }
+    writeCode(prefix, codeSize);
+    writeCode(CLEAR_CODE + 1, codeSize); // End of information
+
+    if (bitCount > 0) {
+        block.push_back(static_cast<uint8_t>(bitBuffer & 0xFF));
+    }
+    flushBlock();
+}
+
+void GifEncoder::writeCode(int code, int codeSize) {
+    // Codes are packed least significant bit first
+    bitBuffer |= static_cast<uint32_t>(code) << bitCount;
+    bitCount += codeSize;
+    while (bitCount >= 8) {
+        block.push_back(static_cast<uint8_t>(bitBuffer & 0xFF));
+        bitBuffer >>= 8;
+        bitCount -= 8;
+        if (block.size() == 255) { flushBlock(); }
+    }
+}
+
+void GifEncoder::flushBlock() {
+    if (block.empty()) { return; }
+    fputc(static_cast<int>(block.size()), file);
+    fwrite(block.data(), 1, block.size(), file);
+    block.clear();
+}
+
+void GifEncoder::put16(int value) {
+    fputc(value & 0xFF, file);
+    fputc((value >> 8) & 0xFF, file);
+}
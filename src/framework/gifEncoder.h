@@ -0,0 +1,57 @@
+#ifndef GRAPHICS_GIFENCODER_H
+#define GRAPHICS_GIFENCODER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes an animated GIF one frame at a time.
+ * @details Every frame is mapped onto a fixed 252-color palette (6 red x 7 green x 6 blue levels),
+ * so no per-frame palette has to be computed, and compressed with LZW. Frames loop forever.
+ */
+class GifEncoder {
+public:
+    /// @brief Opens the file and writes the GIF header
+    /// @param path Output file
+    /// @param width Width of every frame
+    /// @param height Height of every frame
+    /// @param delayCentiseconds Time each frame is shown (1/100 s)
+    GifEncoder(const std::string &path, int width, int height, int delayCentiseconds);
+
+    /// @brief Writes the trailer and closes the file
+    ~GifEncoder();
+
+    GifEncoder(const GifEncoder &) = delete;
+    GifEncoder &operator=(const GifEncoder &) = delete;
+
+    /// @brief Returns true if the file was opened
+    bool isOpen() const { return file != nullptr; }
+
+    /// @brief Appends a frame
+    /// @param rgba width * height RGBA pixels
+    /// @param bottomUp true if the first row is the bottom of the image (glReadPixels order)
+    void addFrame(const uint8_t *rgba, bool bottomUp);
+
+private:
+    FILE *file = nullptr;
+    int width, height, delay;
+
+    /// @brief Palette index of every pixel of the current frame, top row first
+    std::vector<uint8_t> indices;
+
+    // LZW state
+    std::vector<int32_t> hashKeys;  // (prefix code << 8 | next byte), -1 if empty
+    std::vector<uint16_t> hashCodes;
+    std::vector<uint8_t> block;     // Data sub-block being filled (up to 255 bytes)
+    uint32_t bitBuffer = 0;
+    int bitCount = 0;
+
+    void compress();
+    void writeCode(int code, int codeSize);
+    void flushBlock();
+    void put16(int value);
+};
+
+#endif //GRAPHICS_GIFENCODER_H
@@ -0,0 +1,148 @@
+#include "glMock.h"
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+namespace {
+GLMock::Counts counts;
+GLuint nextName = 1;
+std::vector<uint8_t> mapped; // Scratch memory handed out by glMapBufferRange
+
+GLuint newName() {
+    counts.calls++;
+    return nextName++;
+}
+
+void genNames(GLsizei count, GLuint *names) {
+    counts.calls++;
+    for (GLsizei ii = 0; ii < count; ii++) {
+        names[ii] = nextName++;
+    }
+}
+
+void upload(size_t bytes) {
+    counts.calls++;
+    counts.uploadedBytes += bytes;
+}
+
+void draw() {
+    counts.calls++;
+    counts.draws++;
+}
+
+// Every other call only has to be counted; one template stands in for all of their signatures
+template <typename... Args>
+void APIENTRY record(Args...) {
+    counts.calls++;
+}
+
+template <typename... Args>
+void install(void (APIENTRY *&function)(Args...)) {
+    function = &record<Args...>;
+}
+}
+
+void GLMock::install() {
+    // Object creation
+    glad_glGenBuffers = [](GLsizei n, GLuint *names) { genNames(n, names); };
+    glad_glGenVertexArrays = [](GLsizei n, GLuint *names) { genNames(n, names); };
+    glad_glGenTextures = [](GLsizei n, GLuint *names) { genNames(n, names); };
+    glad_glGenFramebuffers = [](GLsizei n, GLuint *names) { genNames(n, names); };
+    glad_glGenRenderbuffers = [](GLsizei n, GLuint *names) { genNames(n, names); };
+    glad_glCreateShader = [](GLenum) { return newName(); };
+    glad_glCreateProgram = []() { return newName(); };
+    glad_glFenceSync = [](GLenum, GLbitfield) { return reinterpret_cast<GLsync>(static_cast<uintptr_t>(newName())); };
+
+    // Queries that have to report success
+    glad_glGetShaderiv = [](GLuint, GLenum, GLint *params) { counts.calls++; *params = GL_TRUE; };
+    glad_glGetProgramiv = [](GLuint, GLenum, GLint *params) { counts.calls++; *params = GL_TRUE; };
+    glad_glGetIntegerv = [](GLenum name, GLint *params) {
+        counts.calls++;
+        *params = name == GL_MAX_TEXTURE_SIZE ? 16384 : 0;
+    };
+    glad_glGetUniformLocation = [](GLuint, const GLchar *) { counts.calls++; return GLint(0); };
+    glad_glGetError = []() { counts.calls++; return GLenum(GL_NO_ERROR); };
+    glad_glCheckFramebufferStatus = [](GLenum) { counts.calls++; return GLenum(GL_FRAMEBUFFER_COMPLETE); };
+    glad_glClientWaitSync = [](GLsync, GLbitfield, GLuint64) { counts.calls++; return GLenum(GL_ALREADY_SIGNALED); };
+
+    // Data transfer
+    glad_glBufferData = [](GLenum, GLsizeiptr size, const void *data, GLenum) { upload(data ? size : 0); };
+    glad_glBufferSubData = [](GLenum, GLintptr, GLsizeiptr size, const void *) { upload(size); };
+    glad_glTexImage2D = [](GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum,
+                           const void *data) {
+        size_t texel = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1; // 8-bit channels
+        upload(data ? static_cast<size_t>(width) * height * texel : 0);
+    };
+    glad_glTexSubImage2D = [](GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum,
+                              const void *) {
+        size_t texel = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+        upload(static_cast<size_t>(width) * height * texel);
+    };
+    glad_glMapBufferRange = [](GLenum, GLintptr, GLsizeiptr length, GLbitfield access) -> void * {
+        if (access & GL_MAP_WRITE_BIT) { upload(length); } else { counts.calls++; }
+        if (mapped.size() < static_cast<size_t>(length)) { mapped.resize(length); }
+        return mapped.data();
+    };
+    glad_glUnmapBuffer = [](GLenum) { counts.calls++; return GLboolean(GL_TRUE); };
+
+    // Draws
+    glad_glDrawArrays = [](GLenum, GLint, GLsizei) { draw(); };
+    glad_glDrawElements = [](GLenum, GLsizei, GLenum, const void *) { draw(); };
+    glad_glDrawArraysInstanced = [](GLenum, GLint, GLsizei, GLsizei) { draw(); };
+    glad_glDrawElementsInstanced = [](GLenum, GLsizei, GLenum, const void *, GLsizei) { draw(); };
+
+    // Everything else is just counted
+    ::install(glad_glActiveTexture);
+    ::install(glad_glAttachShader);
+    ::install(glad_glBindBuffer);
+    ::install(glad_glBindFramebuffer);
+    ::install(glad_glBindRenderbuffer);
+    ::install(glad_glBindTexture);
+    ::install(glad_glBindVertexArray);
+    ::install(glad_glBlendFunc);
+    ::install(glad_glBlitFramebuffer);
+    ::install(glad_glClear);
+    ::install(glad_glClearColor);
+    ::install(glad_glCompileShader);
+    ::install(glad_glDeleteBuffers);
+    ::install(glad_glDeleteFramebuffers);
+    ::install(glad_glDeleteProgram);
+    ::install(glad_glDeleteRenderbuffers);
+    ::install(glad_glDeleteShader);
+    ::install(glad_glDeleteSync);
+    ::install(glad_glDeleteTextures);
+    ::install(glad_glDeleteVertexArrays);
+    ::install(glad_glDisable);
+    ::install(glad_glEnable);
+    ::install(glad_glEnableVertexAttribArray);
+    ::install(glad_glFinish);
+    ::install(glad_glFramebufferRenderbuffer);
+    ::install(glad_glGenerateMipmap);
+    ::install(glad_glGetProgramInfoLog);
+    ::install(glad_glGetShaderInfoLog);
+    ::install(glad_glLinkProgram);
+    ::install(glad_glPixelStorei);
+    ::install(glad_glReadPixels);
+    ::install(glad_glRenderbufferStorage);
+    ::install(glad_glShaderSource);
+    ::install(glad_glTexParameteri);
+    ::install(glad_glUniform1f);
+    ::install(glad_glUniform1i);
+    ::install(glad_glUniform2f);
+    ::install(glad_glUniform3f);
+    ::install(glad_glUniform4f);
+    ::install(glad_glUniformMatrix4fv);
+    ::install(glad_glUseProgram);
+    ::install(glad_glVertexAttribDivisor);
+    ::install(glad_glVertexAttribPointer);
+    ::install(glad_glViewport);
+}
+
+void GLMock::reset() {
+    counts = Counts();
+}
+
+const GLMock::Counts &GLMock::getCounts() {
+    return counts;
+}
@@ -0,0 +1,34 @@
+#ifndef GRAPHICS_GLMOCK_H
+#define GRAPHICS_GLMOCK_H
+
+#include <cstdint>
+
+/**
+ * @brief A fake OpenGL driver for measuring the CPU side of rendering.
+ * @details glad resolves every GL function into a function pointer (glUseProgram is a macro for
+ * glad_glUseProgram), so the whole framework can be pointed at recording stubs by overwriting those
+ * pointers. The stubs hand out object names, report successful compiles and complete framebuffers,
+ * map buffers to scratch memory and count what they're asked to do; nothing is drawn.
+ *
+ * Only the functions the framework calls are stubbed. Use it instead of a context, never alongside one.
+ */
+class GLMock {
+public:
+    /// @brief What the stubs were asked to do since the last reset()
+    struct Counts {
+        uint64_t calls = 0;         // Every GL call
+        uint64_t draws = 0;         // glDraw* calls
+        uint64_t uploadedBytes = 0; // Bytes passed to glBufferData/glBufferSubData/glTexImage2D or mapped for writing
+    };
+
+    /// @brief Replaces glad's function pointers with the stubs
+    static void install();
+
+    /// @brief Zeroes the counts
+    static void reset();
+
+    /// @brief Returns the counts since the last reset()
+    static const Counts &getCounts();
+};
+
+#endif //GRAPHICS_GLMOCK_H
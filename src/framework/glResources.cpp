@@ -0,0 +1,114 @@
+#include "glResources.h"
+#include "glState.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+
+namespace {
+const char *KIND_NAMES[GLResources::KINDS] = {"buffers", "textures", "renderbuffers", "programs", "vertex arrays",
+                                              "framebuffers"};
+}
+
+GLResources &GLResources::get() {
+    static GLResources resources;
+    return resources;
+}
+
+GLuint GLResources::create(GLKind kind, const char *label) {
+    GLuint name = 0;
+    switch (kind) {
+        case GLKind::buffer:       glGenBuffers(1, &name); break;
+        case GLKind::texture:      glGenTextures(1, &name); break;
+        case GLKind::renderbuffer: glGenRenderbuffers(1, &name); break;
+        case GLKind::program:      name = glCreateProgram(); break;
+        case GLKind::vertexArray:  glGenVertexArrays(1, &name); break;
+        case GLKind::framebuffer:  glGenFramebuffers(1, &name); break;
+    }
+    if (name != 0) { get().add(kind, name, label); }
+    return name;
+}
+
+void GLResources::destroy(GLKind kind, GLuint name) {
+    if (name == 0) { return; }
+    switch (kind) {
+        case GLKind::buffer:       GLState::get().deleteBuffers(1, &name); break;
+        case GLKind::texture:      GLState::get().deleteTextures(1, &name); break;
+        case GLKind::renderbuffer: glDeleteRenderbuffers(1, &name); break;
+        case GLKind::program:      GLState::get().deleteProgram(name); break;
+        case GLKind::vertexArray:  GLState::get().deleteVertexArrays(1, &name); break;
+        case GLKind::framebuffer:  glDeleteFramebuffers(1, &name); break;
+    }
+    get().remove(kind, name);
+}
+
+void GLResources::add(GLKind kind, GLuint name, const char *label) {
+    // A name GL hands out again was deleted behind the registry's back: the old entry is stale
+    remove(kind, name);
+    live[static_cast<int>(kind)][name] = {label, 0};
+    usage[static_cast<int>(kind)].objects++;
+}
+
+void GLResources::remove(GLKind kind, GLuint name) {
+    auto &objects = live[static_cast<int>(kind)];
+    auto entry = objects.find(name);
+    if (entry == objects.end()) { return; }
+    usage[static_cast<int>(kind)].objects--;
+    usage[static_cast<int>(kind)].bytes -= entry->second.bytes;
+    objects.erase(entry);
+}
+
+void GLResources::setBytes(GLKind kind, GLuint name, size_t bytes) {
+    auto &objects = live[static_cast<int>(kind)];
+    auto entry = objects.find(name);
+    if (entry == objects.end()) { return; }
+    usage[static_cast<int>(kind)].bytes += bytes - entry->second.bytes;
+    entry->second.bytes = bytes;
+}
+
+size_t GLResources::getTotalBytes() const {
+    size_t total = 0;
+    for (const Usage &kind : usage) { total += kind.bytes; }
+    return total;
+}
+
+void GLResources::printUsage() const {
+    printf("GPU memory: %.1f KB\n", getTotalBytes() / 1024.0);
+    for (int kind = 0; kind < KINDS; kind++) {
+        if (usage[kind].objects == 0) { continue; }
+        printf("  %-14s %6zu objects %10.1f KB\n", KIND_NAMES[kind], usage[kind].objects, usage[kind].bytes / 1024.0);
+    }
+}
+
+size_t GLResources::reportLeaks() const {
+    size_t leaked = 0;
+    for (int kind = 0; kind < KINDS; kind++) {
+        if (live[kind].empty()) { continue; }
+        leaked += live[kind].size();
+
+        // Grouped by owner: a leak is usually many objects from the same place
+        std::map<std::string, Usage> owners;
+        for (const auto &[name, entry] : live[kind]) {
+            Usage &owner = owners[entry.label != nullptr ? entry.label : "?"];
+            owner.objects++;
+            owner.bytes += entry.bytes;
+        }
+        for (const auto &[label, owner] : owners) {
+            printf("ERROR::GLRESOURCES: %zu %s leaked by %s (%.1f KB)\n", owner.objects, KIND_NAMES[kind],
+                   label.c_str(), owner.bytes / 1024.0);
+        }
+    }
+    return leaked;
+}
+
+size_t GLResources::textureBytes(int width, int height, int bytesPerTexel, int maxLevel) {
+    // Every level down to 1x1 (or maxLevel) is a quarter of the one above
+    size_t bytes = 0;
+    if (width <= 0 || height <= 0) { return bytes; }
+    for (int level = 0; maxLevel < 0 || level <= maxLevel; level++) {
+        bytes += static_cast<size_t>(std::max(1, width >> level)) * std::max(1, height >> level) * bytesPerTexel;
+        if ((width >> level) <= 1 && (height >> level) <= 1) { break; }
+    }
+    return bytes;
+}
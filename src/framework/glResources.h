@@ -0,0 +1,137 @@
+#ifndef GRAPHICS_GLRESOURCES_H
+#define GRAPHICS_GLRESOURCES_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#include <glad/glad.h>
+
+/// @brief The kinds of OpenGL objects the registry tracks
+enum class GLKind { buffer, texture, renderbuffer, program, vertexArray, framebuffer };
+
+/**
+ * @brief Registry of every live OpenGL object, with the GPU memory it holds.
+ * @details Objects are created and deleted through create() and destroy() (or a GLObject, which calls them),
+ * so the registry always knows what exists, who made it and, once setBytes() has been told, how big its
+ * storage is. printUsage() sums it up per kind while the program runs; reportLeaks() at shutdown lists
+ * whatever was never deleted, which in a long session is memory that keeps growing.
+ *
+ * The sizes are what was asked for (mipmaps included), not what the driver actually reserved. Like GLState
+ * the registry assumes one context and is only used from the thread that has it current.
+ */
+class GLResources {
+public:
+    static constexpr int KINDS = 6;
+
+    /// @brief Live objects of one kind and their storage
+    struct Usage {
+        size_t objects = 0;
+        size_t bytes = 0;
+    };
+
+    /// @brief Returns the registry of the current context
+    static GLResources &get();
+
+    /// @brief Creates an object and registers it
+    /// @param kind What to create (glGen* or glCreateProgram)
+    /// @param label Who owns it, shown by reportLeaks() (must outlive the object, e.g. a string literal)
+    /// @return The object's name
+    static GLuint create(GLKind kind, const char *label);
+
+    /// @brief Deletes an object (through GLState, where it caches the kind) and forgets it; 0 is ignored
+    static void destroy(GLKind kind, GLuint name);
+
+    /// @brief Records the size of an object's storage, replacing the previous size (e.g. after glBufferData)
+    void setBytes(GLKind kind, GLuint name, size_t bytes);
+
+    /// @brief Returns the live objects of a kind
+    Usage getUsage(GLKind kind) const { return usage[static_cast<int>(kind)]; }
+
+    /// @brief Returns the storage of every live object
+    size_t getTotalBytes() const;
+
+    /// @brief Prints the live objects and their memory per kind
+    void printUsage() const;
+
+    /// @brief Prints every object still alive; call once everything should have been deleted
+    /// @return The number of objects that were leaked
+    size_t reportLeaks() const;
+
+    /// @brief Size of a 2D texture's storage
+    /// @param bytesPerTexel Bytes of one texel of the internal format (e.g. 4 for GL_RGBA8)
+    /// @param maxLevel The last mip level (0 for none, -1 for the whole chain down to 1x1)
+    static size_t textureBytes(int width, int height, int bytesPerTexel, int maxLevel = 0);
+
+private:
+    struct Entry {
+        const char *label;
+        size_t bytes;
+    };
+
+    std::unordered_map<GLuint, Entry> live[KINDS];
+    Usage usage[KINDS];
+
+    GLResources() = default;
+
+    void add(GLKind kind, GLuint name, const char *label);
+    void remove(GLKind kind, GLuint name);
+};
+
+/**
+ * @brief Owns one OpenGL object: deletes it when destroyed, and can be moved but not copied.
+ * @details Converts to the object's name, so it can be passed to GL calls and GLState as it is.
+ */
+template <GLKind Kind>
+class GLObject {
+public:
+    /// @brief Holds no object (name 0) until create()
+    GLObject() = default;
+
+    /// @brief Creates the object (requires a current OpenGL context)
+    explicit GLObject(const char *label) : name(GLResources::create(Kind, label)) { }
+
+    ~GLObject() { reset(); }
+
+    GLObject(const GLObject &) = delete;
+    GLObject &operator=(const GLObject &) = delete;
+
+    GLObject(GLObject &&other) noexcept : name(std::exchange(other.name, 0)) { }
+
+    GLObject &operator=(GLObject &&other) noexcept {
+        if (this != &other) {
+            reset();
+            name = std::exchange(other.name, 0);
+        }
+        return *this;
+    }
+
+    /// @brief Replaces the object with a new one
+    void create(const char *label) {
+        reset();
+        name = GLResources::create(Kind, label);
+    }
+
+    /// @brief Deletes the object, if there is one
+    void reset() {
+        GLResources::destroy(Kind, name);
+        name = 0;
+    }
+
+    /// @brief Records the size of the object's storage (see GLResources::setBytes())
+    void setBytes(size_t bytes) const { GLResources::get().setBytes(Kind, name, bytes); }
+
+    GLuint get() const { return name; }
+    operator GLuint() const { return name; }
+
+private:
+    GLuint name = 0;
+};
+
+using GLBuffer = GLObject<GLKind::buffer>;
+using GLTexture = GLObject<GLKind::texture>;
+using GLRenderbuffer = GLObject<GLKind::renderbuffer>;
+using GLVertexArray = GLObject<GLKind::vertexArray>;
+using GLFramebuffer = GLObject<GLKind::framebuffer>;
+
+#endif //GRAPHICS_GLRESOURCES_H
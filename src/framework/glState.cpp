@@ -0,0 +1,126 @@
+#include "glState.h"
+
+GLState &GLState::get() {
+    static GLState state;
+    return state;
+}
+
+void GLState::invalidate() {
+    program = vao = unit = blendSrc = blendDst = UNKNOWN;
+    blend = -1;
+    for (GLuint &buffer : buffers)   { buffer = UNKNOWN; }
+    for (GLuint &texture : textures) { texture = UNKNOWN; }
+}
+
+bool GLState::change(GLuint &cached, GLuint value) {
+    if (cached == value) {
+        frame.skipped++;
+        return false;
+    }
+    cached = value;
+    frame.issued++;
+    return true;
+}
+
+int GLState::bufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:        return 0;
+        case GL_PIXEL_PACK_BUFFER:   return 1;
+        case GL_PIXEL_UNPACK_BUFFER: return 2;
+        default:                     return -1;
+    }
+}
+
+void GLState::useProgram(GLuint program) {
+    if (change(this->program, program)) { glUseProgram(program); }
+}
+
+void GLState::bindVertexArray(GLuint vao) {
+    if (change(this->vao, vao)) { glBindVertexArray(vao); }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferSlot(target);
+    if (slot < 0) {
+        frame.issued++;
+        glBindBuffer(target, buffer);
+    } else if (change(buffers[slot], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (change(this->unit, unit)) { glActiveTexture(unit); }
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    // Only 2D textures are cached; the unit is only known once activeTexture() has been called
+    int index = static_cast<int>(unit - GL_TEXTURE0);
+    if (target != GL_TEXTURE_2D || unit == UNKNOWN || index >= TEXTURE_UNITS) {
+        frame.issued++;
+        glBindTexture(target, texture);
+    } else if (change(textures[index], texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void GLState::setBlend(bool enabled) {
+    if (blend == static_cast<int>(enabled)) {
+        frame.skipped++;
+        return;
+    }
+    blend = enabled;
+    frame.issued++;
+    if (enabled) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
+
+void GLState::blendFunc(GLenum src, GLenum dst) {
+    if (blendSrc == src && blendDst == dst) {
+        frame.skipped++;
+        return;
+    }
+    blendSrc = src;
+    blendDst = dst;
+    frame.issued++;
+    glBlendFunc(src, dst);
+}
+
+void GLState::deleteProgram(GLuint program) {
+    // A program in use stays alive until another one is installed, but its name must not match the cache
+    if (this->program == program) { this->program = UNKNOWN; }
+    glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArrays(GLsizei count, const GLuint *vaos) {
+    for (GLsizei ii = 0; ii < count; ii++) {
+        if (vao == vaos[ii]) { vao = 0; }
+    }
+    glDeleteVertexArrays(count, vaos);
+}
+
+void GLState::deleteBuffers(GLsizei count, const GLuint *buffers) {
+    for (GLsizei ii = 0; ii < count; ii++) {
+        for (GLuint &buffer : this->buffers) {
+            if (buffer == buffers[ii]) { buffer = 0; }
+        }
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void GLState::deleteTextures(GLsizei count, const GLuint *textures) {
+    for (GLsizei ii = 0; ii < count; ii++) {
+        for (GLuint &texture : this->textures) {
+            if (texture == textures[ii]) { texture = 0; }
+        }
+    }
+    glDeleteTextures(count, textures);
+}
+
+void GLState::endFrame() {
+    lastFrame = frame;
+    frame = Stats();
+}
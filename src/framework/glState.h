@@ -0,0 +1,75 @@
+#ifndef GRAPHICS_GLSTATE_H
+#define GRAPHICS_GLSTATE_H
+
+#include <glad/glad.h>
+
+/**
+ * @brief Shadow copy of the OpenGL binding and blend state.
+ * @details Every program switch, VAO/buffer/texture bind and blend change in the framework goes
+ * through this class, which drops calls that wouldn't change anything. Since each of those calls
+ * still costs a trip into the driver, the renderers can bind what they need per draw without
+ * having to care about what was bound before, and without unbinding afterwards.
+ *
+ * The element array buffer binding belongs to the bound VAO, so it isn't cached. Objects must be
+ * deleted through this class too (GLResources::destroy() does), or a reused name could be mistaken
+ * for a binding that GL has already reset. The cache assumes a single context: call invalidate() after making a context current.
+ */
+class GLState {
+public:
+    /// @brief Calls issued to and skipped before reaching the driver
+    struct Stats {
+        unsigned int issued = 0;
+        unsigned int skipped = 0;
+    };
+
+    /// @brief Returns the state of the current context
+    static GLState &get();
+
+    /// @brief Forgets everything, so the next call of each kind reaches GL
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void activeTexture(GLenum unit);
+    void bindTexture(GLenum target, GLuint texture);
+    void setBlend(bool enabled);
+    void blendFunc(GLenum src, GLenum dst);
+
+    // Delete objects and clear the bindings GL resets along with them
+    void deleteProgram(GLuint program);
+    void deleteVertexArrays(GLsizei count, const GLuint *vaos);
+    void deleteBuffers(GLsizei count, const GLuint *buffers);
+    void deleteTextures(GLsizei count, const GLuint *textures);
+
+    /// @brief Ends the frame: its counts become getLastFrame() and counting starts over
+    void endFrame();
+
+    /// @brief Returns the counts of the last completed frame
+    const Stats &getLastFrame() const { return lastFrame; }
+
+private:
+    static const GLuint UNKNOWN = ~0u; // Never a valid object name, so the first bind always goes through
+    static const int TEXTURE_UNITS = 16;
+    static const int BUFFER_TARGETS = 3;
+
+    GLuint program = UNKNOWN;
+    GLuint vao = UNKNOWN;
+    GLuint buffers[BUFFER_TARGETS];
+    GLenum unit = UNKNOWN;
+    GLuint textures[TEXTURE_UNITS];
+    int blend = -1;
+    GLenum blendSrc = UNKNOWN, blendDst = UNKNOWN;
+
+    Stats frame, lastFrame;
+
+    GLState() { invalidate(); }
+
+    /// @brief Returns the cache slot of a buffer target, or -1 if the target isn't cached
+    static int bufferSlot(GLenum target);
+
+    /// @brief Compares and updates a cached value; returns true if the call has to be issued
+    bool change(GLuint &cached, GLuint value);
+};
+
+#endif //GRAPHICS_GLSTATE_H
@@ -0,0 +1,54 @@
+#include "image.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+bool saveImage(const Image &image, const std::string &path) {
+    // Rows are stored bottom first; PNG wants the top row first
+    stbi_flip_vertically_on_write(1);
+    if (!stbi_write_png(path.c_str(), image.width, image.height, 4, image.pixels.data(), image.width * 4)) {
+        std::cout << "ERROR::IMAGE: Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadImage(Image &image, const std::string &path) {
+    int channels;
+    stbi_uc *data = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+    if (!data) {
+        std::cout << "ERROR::IMAGE: Failed to read " << path << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    // Flipped here rather than with stbi_set_flip_vertically_on_load(), which is global to every thread
+    const size_t rowBytes = static_cast<size_t>(image.width) * 4;
+    image.pixels.resize(rowBytes * image.height);
+    for (int y = 0; y < image.height; y++) {
+        memcpy(&image.pixels[rowBytes * y], data + rowBytes * (image.height - 1 - y), rowBytes);
+    }
+    stbi_image_free(data);
+    return true;
+}
+
+ImageDiff diffImages(const Image &a, const Image &b, int tolerance) {
+    ImageDiff diff;
+    diff.sameSize = a.width == b.width && a.height == b.height && a.pixels.size() == b.pixels.size();
+    if (!diff.sameSize) { return diff; }
+
+    for (size_t pixel = 0; pixel < a.pixels.size(); pixel += 4) {
+        int worst = 0;
+        for (size_t channel = 0; channel < 4; channel++) {
+            worst = std::max(worst, std::abs(a.pixels[pixel + channel] - b.pixels[pixel + channel]));
+        }
+        diff.maxChannelDelta = std::max(diff.maxChannelDelta, worst);
+        if (worst > tolerance) { diff.differingPixels++; }
+    }
+    return diff;
+}
@@ -0,0 +1,38 @@
+#ifndef GRAPHICS_IMAGE_H
+#define GRAPHICS_IMAGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An 8-bit RGBA image in memory, bottom row first (the order glReadPixels returns).
+ */
+struct Image {
+    int width = 0, height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/// @brief Writes an image to a PNG file
+/// @return true if the file was written
+bool saveImage(const Image &image, const std::string &path);
+
+/// @brief Loads a PNG (or any format stb_image reads) into an RGBA image
+/// @details Safe to call from several threads at once.
+/// @return true if the file was read
+bool loadImage(Image &image, const std::string &path);
+
+/**
+ * @brief Result of comparing two images pixel by pixel
+ */
+struct ImageDiff {
+    bool sameSize = false;
+    size_t differingPixels = 0; // Pixels where any channel differs by more than the tolerance
+    int maxChannelDelta = 0;    // Largest difference seen in any channel
+};
+
+/// @brief Compares two images for golden-image tests
+/// @param tolerance Largest per-channel difference that still counts as equal
+ImageDiff diffImages(const Image &a, const Image &b, int tolerance = 0);
+
+#endif //GRAPHICS_IMAGE_H
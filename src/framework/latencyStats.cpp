@@ -0,0 +1,61 @@
+#include "latencyStats.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+LatencyStats::LatencyStats(size_t capacity) : samples(std::max<size_t>(capacity, 1)) {
+    sorted.reserve(samples.size());
+}
+
+void LatencyStats::add(double milliseconds) {
+    samples[next] = milliseconds;
+    next = (next + 1) % samples.size();
+    filled = std::min(filled + 1, samples.size());
+}
+
+double LatencyStats::percentile(double fraction) const {
+    if (filled == 0) { return 0; }
+    sorted.assign(samples.begin(), samples.begin() + filled);
+    auto rank = static_cast<size_t>(std::clamp(fraction, 0.0, 1.0) * (filled - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+void LatencyStats::print(const char *label) const {
+    if (filled == 0) {
+        std::cout << label << ": no samples" << std::endl;
+        return;
+    }
+    char line[128];
+    snprintf(line, sizeof(line), "p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms",
+             percentile(0.5), percentile(0.9), percentile(0.99), percentile(1.0));
+    std::cout << label << " (" << filled << " samples): " << line << std::endl;
+}
+
+void FramePacer::waitForDeadline() const {
+    if (lastSwap < 0) { return; }
+    double start = lastSwap + period - drawEstimate - SAFETY;
+    double now = glfwGetTime();
+    if (start > now) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(start - now));
+    }
+}
+
+void FramePacer::frameDone(double drawSeconds, double swapTime) {
+    // Intervals well over a period are missed refreshes, not a slower display
+    if (lastSwap >= 0) {
+        double interval = swapTime - lastSwap;
+        if (interval > 0 && interval < period * 1.5) {
+            period += (interval - period) * 0.05;
+        }
+    }
+    lastSwap = swapTime;
+
+    // Follow slower frames at once (a missed refresh costs a whole period), faster ones gradually
+    drawEstimate = drawSeconds > drawEstimate ? drawSeconds : drawEstimate + (drawSeconds - drawEstimate) * 0.1;
+}
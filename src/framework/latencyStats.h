@@ -0,0 +1,64 @@
+#ifndef GRAPHICS_LATENCYSTATS_H
+#define GRAPHICS_LATENCYSTATS_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Collects latency samples and reports percentiles.
+ * @details Keeps the most recent samples in a fixed ring, so adding never allocates and a long
+ * session reports on recent behaviour. Not thread-safe.
+ */
+class LatencyStats {
+public:
+    /// @param capacity Number of samples kept
+    explicit LatencyStats(size_t capacity = 4096);
+
+    /// @brief Records one sample
+    void add(double milliseconds);
+
+    /// @brief Returns the number of samples kept (at most the capacity)
+    size_t count() const { return filled; }
+
+    /// @brief Returns the value below which the given fraction of the samples fall (0 if there are none)
+    /// @param fraction 0.5 for the median, 0.99 for the 99th percentile, ...
+    double percentile(double fraction) const;
+
+    /// @brief Prints the sample count and the 50th, 90th and 99th percentiles and the maximum
+    /// @param label What was measured, e.g. "Input to swap"
+    void print(const char *label) const;
+
+private:
+    std::vector<double> samples;
+    mutable std::vector<double> sorted;
+    size_t next = 0, filled = 0;
+};
+
+/**
+ * @brief Decides when to start a frame so it is drawn as late as possible and still makes the next refresh.
+ * @details With vsync, a frame started right after the previous swap waits most of a refresh interval
+ * before it is shown, with input that was sampled at its start. Starting late instead (just the draw
+ * time plus a safety margin before the deadline) shows newer input. The refresh interval and the draw
+ * time are measured from the frames themselves. This only works if the swap blocks until the refresh,
+ * i.e. with vsync and without the driver queueing frames ahead (see Engine::render()).
+ */
+class FramePacer {
+public:
+    /// @brief Sleeps until the next frame has to start
+    void waitForDeadline() const;
+
+    /// @brief Records a finished frame
+    /// @param drawSeconds Time from the start of the frame until it was ready to swap
+    /// @param swapTime When the swap returned (glfwGetTime())
+    void frameDone(double drawSeconds, double swapTime);
+
+private:
+    /// @brief Slack kept for scheduling noise, in seconds
+    static constexpr double SAFETY = 0.0015;
+
+    double lastSwap = -1;
+    double period = 1.0 / 60.0;
+    double drawEstimate = 0.002;
+};
+
+#endif //GRAPHICS_LATENCYSTATS_H
@@ -0,0 +1,192 @@
+#include "recorder.h"
+#include "glState.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+Recorder::Recorder(const string &path, int width, int height, double frameRate, int frameInterval, int scale)
+    : path(path), width(width / scale), height(height / scale), sourceWidth(width), sourceHeight(height),
+      frameInterval(frameInterval), frameRate(frameRate) {
+    gif = path.size() >= 4 && path.compare(path.size() - 4, 4, ".gif") == 0;
+
+    // The blit target: downscaling on the GPU cuts readback and encoding work by scale^2
+    scaledFBO.create("Recorder");
+    scaledRBO.create("Recorder");
+    glBindRenderbuffer(GL_RENDERBUFFER, scaledRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, this->width, this->height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, scaledFBO);
+    glFramebufferRenderbuffer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, scaledRBO);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    const size_t frameBytes = static_cast<size_t>(this->width) * this->height * 4;
+    scaledRBO.setBytes(frameBytes);
+    for (GLBuffer &pbo : pbos) {
+        pbo.create("Recorder");
+        GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frameBytes), nullptr, GL_STREAM_READ);
+        pbo.setBytes(frameBytes);
+    }
+    GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    pool.resize(POOL_SIZE, vector<uint8_t>(frameBytes));
+    for (int ii = POOL_SIZE - 1; ii >= 0; ii--) {
+        freeFrames.push_back(ii);
+    }
+
+    worker = thread(&Recorder::encodeLoop, this);
+    cout << "Recording " << this->width << "x" << this->height << " to " << path << endl;
+}
+
+Recorder::~Recorder() {
+    // Frames still on the GPU are worth a short stall now that recording is over
+    for (int ii = 0; ii < PBO_COUNT; ii++) {
+        int index = (nextPBO + ii) % PBO_COUNT;
+        if (fences[index]) {
+            collect(index, true);
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+
+    double captureMs = chrono::duration<double, milli>(captureTime).count();
+    cout << "Recorded " << encoded << " frames to " << path << " (" << dropped << " dropped, "
+         << (frameCounter > 0 ? captureMs / frameCounter : 0.0) << " ms per frame spent capturing)" << endl;
+    if (!gif) {
+        cout << "Convert with: ffmpeg -f rawvideo -pixel_format rgba -video_size " << width << "x" << height
+             << " -framerate " << frameRate / frameInterval << " -i " << path << " -vf vflip out.mp4" << endl;
+    }
+}
+
+void Recorder::capture(GLuint sourceFBO) {
+    auto start = chrono::steady_clock::now();
+    if (frameCounter++ % frameInterval != 0) {
+        return;
+    }
+
+    // The PBO written two captures ago has to be emptied before it can be reused. Its fence has almost
+    // always signaled by now; if the GPU is that far behind, skip this capture instead of waiting.
+    int index = nextPBO;
+    if (fences[index] && !collect(index, false)) {
+        dropped++;
+        captureTime += chrono::steady_clock::now() - start;
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, scaledFBO);
+    glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    // With a pack buffer bound, glReadPixels only schedules the copy and returns immediately
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, scaledFBO);
+    GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, pbos[index]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, sourceFBO);
+    nextPBO = (index + 1) % PBO_COUNT;
+    captured++;
+
+    // Collect the previous capture early if it's ready, so frames reach the encoder with less delay
+    int previous = (index + PBO_COUNT - 1) % PBO_COUNT;
+    if (fences[previous]) {
+        collect(previous, false);
+    }
+    captureTime += chrono::steady_clock::now() - start;
+}
+
+bool Recorder::collect(int index, bool wait) {
+    GLuint64 timeout = wait ? 1000000000ull : 0;
+    GLenum status = glClientWaitSync(fences[index], wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    glDeleteSync(fences[index]);
+    fences[index] = nullptr;
+
+    int frame = -1;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (!freeFrames.empty()) {
+            frame = freeFrames.back();
+            freeFrames.pop_back();
+        }
+    }
+    if (frame < 0) {
+        // The encoder is behind; the PBO is free again either way
+        dropped++;
+        return true;
+    }
+
+    GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, pbos[index]);
+    const void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(pool[frame].size()),
+                                          GL_MAP_READ_BIT);
+    if (mapped) {
+        memcpy(pool[frame].data(), mapped, pool[frame].size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    GLState::get().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (mapped) {
+            queue.push_back(frame);
+        } else {
+            freeFrames.push_back(frame);
+        }
+    }
+    wake.notify_one();
+    return true;
+}
+
+void Recorder::encodeLoop() {
+    unique_ptr<GifEncoder> encoder;
+    FILE *raw = nullptr;
+    if (gif) {
+        // GIF delays are in hundredths of a second
+        int delay = static_cast<int>(100.0 * frameInterval / frameRate + 0.5);
+        encoder = make_unique<GifEncoder>(path, width, height, delay > 0 ? delay : 1);
+    } else {
+        raw = fopen(path.c_str(), "wb");
+        if (!raw) {
+            cout << "ERROR::RECORDER: Failed to open " << path << endl;
+        }
+    }
+
+    while (true) {
+        int frame;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            frame = queue.front();
+            queue.pop_front();
+        }
+
+        if (encoder) {
+            encoder->addFrame(pool[frame].data(), true);
+        } else if (raw) {
+            fwrite(pool[frame].data(), 1, pool[frame].size(), raw);
+        }
+        encoded++;
+
+        lock_guard<mutex> lock(queueMutex);
+        freeFrames.push_back(frame);
+    }
+
+    if (raw) {
+        fclose(raw);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef GRAPHICS_RECORDER_H
+#define GRAPHICS_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "gifEncoder.h"
+#include "glResources.h"
+
+using std::string, std::vector;
+
+/**
+ * @brief Records the rendered frames to a GIF or a raw RGBA video file.
+ * @details The render thread only issues GPU commands: every frameInterval-th frame is scaled down
+ * into a small framebuffer and read into one of two pixel buffer objects. A PBO is mapped a frame later,
+ * once its fence has signaled, so glReadPixels never waits for the GPU. The mapped pixels are copied into
+ * a buffer from a fixed pool and handed to a worker thread that does the encoding. If the worker falls
+ * behind and the pool runs dry, frames are dropped rather than stalling the render loop.
+ *
+ * Files ending in ".gif" are encoded as GIF; anything else receives raw RGBA frames, bottom row first.
+ * All methods must be called on the thread that owns the OpenGL context.
+ */
+class Recorder {
+public:
+    /// @brief Creates the GL objects and starts the encoding thread
+    /// @param path Output file
+    /// @param width Width of the frames being rendered
+    /// @param height Height of the frames being rendered
+    /// @param frameRate Rate at which frames are rendered (used for the GIF frame delay)
+    /// @param frameInterval Capture every frameInterval-th frame
+    /// @param scale Divide the width and height by this
+    Recorder(const string &path, int width, int height, double frameRate = 60.0, int frameInterval = 2, int scale = 2);
+
+    /// @brief Reads back the frames still in flight, waits for the encoder and prints statistics
+    ~Recorder();
+
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+
+    /// @brief Captures the frame that was just drawn (call after rendering, before swapping buffers)
+    /// @param sourceFBO Framebuffer that was drawn into (0 for the window)
+    void capture(GLuint sourceFBO = 0);
+
+private:
+    static const int PBO_COUNT = 2;
+    static const int POOL_SIZE = 8;
+
+    string path;
+    int width, height;          // Captured (scaled) size
+    int sourceWidth, sourceHeight;
+    int frameInterval;
+    double frameRate;
+    bool gif;
+
+    // GL objects
+    GLFramebuffer scaledFBO;
+    GLRenderbuffer scaledRBO;
+    GLBuffer pbos[PBO_COUNT];
+    GLsync fences[PBO_COUNT] = {};
+    int nextPBO = 0;
+
+    // Frame buffers cycle between the free list (render thread) and the queue (worker thread)
+    vector<vector<uint8_t>> pool;
+    vector<int> freeFrames;
+    std::deque<int> queue;
+    std::mutex queueMutex;
+    std::condition_variable wake;
+    std::thread worker;
+    bool stopping = false;
+
+    // Statistics
+    long frameCounter = 0, captured = 0, dropped = 0, encoded = 0;
+    std::chrono::steady_clock::duration captureTime{};
+
+    /// @brief Maps a PBO whose readback has finished and queues its pixels for encoding
+    /// @param wait Block until the GPU is done (only when stopping)
+    /// @return false if the readback hasn't finished yet
+    bool collect(int index, bool wait);
+
+    /// @brief Body of the encoding thread
+    void encodeLoop();
+};
+
+#endif //GRAPHICS_RECORDER_H
@@ -0,0 +1,91 @@
+#include "rectRenderer.h"
+
+#include <glad/glad.h>
+#include <cstddef>
+
+RectRenderer::RectRenderer(Shader &shader, StreamBuffer &stream) : shader(shader), stream(stream) {
+    this->initRenderData();
+}
+
+void RectRenderer::initRenderData() {
+    float quad[] = {
+        -0.5f, 0.5f,   // Top left
+        0.5f, 0.5f,    // Top right
+        -0.5f, -0.5f,  // Bottom left
+        0.5f, -0.5f    // Bottom right
+    };
+    unsigned int indices[] = {
+        0, 1, 2, // First triangle
+        1, 2, 3  // Second triangle
+    };
+
+    this->VAO.create("RectRenderer");
+    this->quadVBO.create("RectRenderer");
+    this->quadEBO.create("RectRenderer");
+    GLState::get().bindVertexArray(this->VAO);
+
+    // Shared unit quad
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    this->quadVBO.setBytes(sizeof(quad));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    GLState::get().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->quadEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    this->quadEBO.setBytes(sizeof(indices));
+
+    // Per-instance center/size and color, advanced once per instance (pointed at the stream buffer in draw())
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLState::get().bindVertexArray(0);
+}
+
+void RectRenderer::draw(const ShapeStore &store) {
+    draw(store, 0, static_cast<ShapeHandle>(store.size()));
+}
+
+void RectRenderer::draw(const ShapeStore &store, ShapeHandle begin, ShapeHandle end) {
+    ShapeRange range{begin, end};
+    draw(store, &range, 1);
+}
+
+void RectRenderer::draw(const ShapeStore &store, const ShapeRange *ranges, size_t count) {
+    size_t capacity = 0;
+    for (size_t ii = 0; ii < count; ii++) {
+        if (ranges[ii].end > ranges[ii].begin) { capacity += ranges[ii].end - ranges[ii].begin; }
+    }
+    if (capacity == 0) { return; }
+
+    // Gather the visible shapes straight into the stream buffer; every array is walked front to back.
+    // Room is allocated for every shape in the ranges, the unused tail is simply never drawn.
+    const float *posX = store.getPosX(), *posY = store.getPosY();
+    const float *sizeX = store.getSizeX(), *sizeY = store.getSizeY();
+    const uint32_t *colors = store.getColors();
+    const uint8_t *flags = store.getFlags();
+    const uint8_t drawable = SHAPE_ALIVE | SHAPE_VISIBLE;
+
+    GLintptr offset;
+    auto *instances = static_cast<Instance *>(stream.map(capacity * sizeof(Instance), alignof(Instance), offset));
+    if (!instances) { return; }
+    GLsizei drawn = 0;
+    for (size_t range = 0; range < count; range++) {
+        for (ShapeHandle ii = ranges[range].begin; ii < ranges[range].end; ii++) {
+            if ((flags[ii] & drawable) == drawable) {
+                instances[drawn++] = {posX[ii], posY[ii], sizeX[ii], sizeY[ii], colors[ii]};
+            }
+        }
+    }
+    stream.unmap();
+    if (drawn == 0) { return; }
+
+    this->shader.use();
+    GLState::get().bindVertexArray(this->VAO);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, stream.getId());
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, x)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)(offset + offsetof(Instance, color)));
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, drawn);
+}
@@ -0,0 +1,73 @@
+#ifndef GRAPHICS_RECTRENDERER_H
+#define GRAPHICS_RECTRENDERER_H
+
+#include <vector>
+#include "shader.h"
+#include "streamBuffer.h"
+#include "glResources.h"
+#include "../shapes/shapeStore.h"
+
+/**
+ * @brief Draws every visible shape of a ShapeStore with a single instanced draw call.
+ * @details All rectangles share one unit quad; the per-instance buffer only holds
+ * the center, size and packed color of each shape (20 bytes per instance), which is written
+ * straight into the frame's StreamBuffer allocation.
+ */
+class RectRenderer {
+public:
+    /**
+     * @brief Construct a new Rect Renderer object
+     * @details The shader must be the instanced variant of the rect shader (res/shaders/rect.vert with INSTANCED)
+     *
+     * @param shader The shader to use
+     * @param stream Buffer the instance data is streamed through
+     */
+    RectRenderer(Shader &shader, StreamBuffer &stream);
+
+    /**
+     * @brief Uploads the visible shapes of the store and draws them in slot order
+     *
+     * @param store The shapes to draw
+     */
+    void draw(const ShapeStore &store);
+
+    /**
+     * @brief Uploads the visible shapes in [begin, end) and draws them in slot order
+     *
+     * @param store The shapes to draw
+     * @param begin The first handle to consider
+     * @param end One past the last handle to consider
+     */
+    void draw(const ShapeStore &store, ShapeHandle begin, ShapeHandle end);
+
+    /**
+     * @brief Uploads the visible shapes of several ranges and draws them with one call, in the order given
+     * @details Lets callers cull: only the ranges passed in are looked at
+     *
+     * @param store The shapes to draw
+     * @param ranges The handle ranges to consider
+     * @param count The number of ranges
+     */
+    void draw(const ShapeStore &store, const ShapeRange *ranges, size_t count);
+
+private:
+    /// @brief Layout of one instance in the instance buffer
+    struct Instance {
+        float x, y, width, height;
+        uint32_t color;
+    };
+
+    Shader &shader;
+    StreamBuffer &stream;
+
+    /// @brief The VAO and the unit quad's VBO and EBO
+    GLVertexArray VAO;
+    GLBuffer quadVBO, quadEBO;
+
+    /**
+     * @brief Initializes and configures the buffers and vertex attributes
+     */
+    void initRenderData();
+};
+
+#endif //GRAPHICS_RECTRENDERER_H
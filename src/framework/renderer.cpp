@@ -0,0 +1,291 @@
+#include "renderer.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+using namespace std;
+
+Renderer::Renderer(int width, int height, const BoardLayout &layout, const Board &board, int states)
+    : width(width), height(height), layout(layout), states(std::clamp(states, 2, PALETTE_SIZE)),
+      camera(vec2(width, height)),
+      projection(glm::ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f)) {
+    for (int ii = 0; ii < PALETTE_SIZE; ii++) {
+        palette[ii] = packColor(stateColor(ii, this->states));
+    }
+    this->initShaders(board);
+    this->initShapes(board);
+}
+
+Renderer::~Renderer() = default;
+
+void Renderer::initShaders(const Board &board) {
+    shaderManager = make_unique<ShaderManager>();
+    stream = make_unique<StreamBuffer>();
+
+    // Instanced variant of the rect shader, used for everything stored in the shape store
+    shaderManager->addShader("../res/shaders/rect.vert", "../res/shaders/rect.frag", nullptr, "rect", {"INSTANCED"});
+    // Instanced circle shader used for the win screen particles
+    shaderManager->addShader("../res/shaders/circleInstanced.vert", "../res/shaders/circleInstanced.frag",
+                             nullptr, "circleInstanced");
+    // Boards too big for a shape per light are drawn from a texture
+    if (isHugeBoard(board))
+        shaderManager->addShader("../res/shaders/board.vert", "../res/shaders/board.frag", nullptr, "board");
+    shaderManager->addShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
+    // Every program is submitted before any is checked, so the driver can build them side by side
+    shaderManager->compileAll();
+
+    shaderManager->getShader("rect").use().setMatrix4("projection", projection);
+    rectRenderer = make_unique<RectRenderer>(shaderManager->getShader("rect"), *stream);
+    shaderManager->getShader("circleInstanced").use().setMatrix4("projection", projection);
+    circleRenderer = make_unique<CircleRenderer>(shaderManager->getShader("circleInstanced"), *stream);
+    if (isHugeBoard(board)) {
+        shaderManager->getShader("board").use().setMatrix4("projection", projection);
+        boardRenderer = make_unique<BoardRenderer>(shaderManager->getShader("board"), layout, board, this->states);
+    }
+
+    // Configure text renderer
+    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), *stream, "../res/fonts/MxPlus_IBM_BIOS.ttf", FONT_SIZE);
+}
+
+void Renderer::watchShaders() {
+    shaderManager->watch("../res/shaders");
+}
+
+bool Renderer::loadSkin(const std::string &directory) {
+    if (boardRenderer) {
+        cout << "ERROR::RENDERER: Skins are only drawn on boards of up to 64x64 lights" << endl;
+        return false;
+    }
+    // A skin is a handful of images: a few decoding threads are plenty
+    auto skin = make_unique<TextureManager>(4);
+    for (int state = 0; state < states; state++) {
+        // A state without an image of its own gets the shared one in its palette color
+        std::string own = directory + "/" + std::to_string(state) + ".png";
+        bool hasOwn = std::filesystem::exists(own);
+        stateSprites[state] = skin->load(hasOwn ? own : directory + "/light.png");
+        stateTints[state] = hasOwn ? packColor(WHITE) : palette[state];
+    }
+
+    // The images decode while the shader compiles
+    shaderManager->addShader("../res/shaders/sprite.vert", "../res/shaders/sprite.frag", nullptr, "sprite",
+                             {"INSTANCED"});
+    if (!shaderManager->compileAll() || !skin->finishLoading()) {
+        cout << "ERROR::RENDERER: Could not load the skin in " << directory << endl;
+        return false;
+    }
+    const TextureManager::Stats &stats = skin->getStats();
+    printf("Skin %s: %zu images, %zu unique, %zu atlas pages (%.0f%% used), %.1f KB of textures in %.1f ms\n",
+           directory.c_str(), stats.images, stats.unique, stats.pages, 100.0 * stats.occupancy,
+           stats.textureBytes / 1024.0, stats.milliseconds);
+
+    textures = std::move(skin);
+    restoreUniforms("sprite");
+    spriteRenderer = make_unique<SpriteRenderer>(shaderManager->getShader("sprite"), *stream);
+    return true;
+}
+
+void Renderer::restoreUniforms(const std::string &name) {
+    // The text shader gets its uniforms with every string, so it needs nothing
+    if (name == "rect") {
+        shaderManager->getShader("rect").use().setMatrix4("projection", camera.getProjection());
+    } else if (name == "circleInstanced") {
+        shaderManager->getShader("circleInstanced").use().setMatrix4("projection", projection);
+    } else if (name == "board" && boardRenderer) {
+        shaderManager->getShader("board").use().setMatrix4("projection", camera.getProjection());
+        boardRenderer->setUniforms();
+    } else if (name == "sprite") {
+        shaderManager->getShader("sprite").use().setMatrix4("projection", camera.getProjection());
+        shaderManager->getShader("sprite").setInteger("image", 0);
+    }
+}
+
+void Renderer::initShapes(const Board &board) {
+    // Huge boards only need the cursor: the board renderer draws the lights
+    if (!boardRenderer) {
+        // Outlines go first so they are drawn behind the lights; they stay hidden until hovered.
+        // Both are created in board order, so light (x, y) is lights[y * width + x].
+        shapes.reserve(2 * board.getCellCount() + 1);
+        for (int y = 0; y < board.getHeight(); y++) {
+            for (int x = 0; x < board.getWidth(); x++) {
+                redOutline.push_back(shapes.create(layout.cellCenter(x, y), vec2(layout.outlineSize, layout.outlineSize),
+                                                   RED, false));
+            }
+        }
+        for (int y = 0; y < board.getHeight(); y++) {
+            for (int x = 0; x < board.getWidth(); x++) {
+                lights.push_back(shapes.create(layout.cellCenter(x, y), vec2(layout.cellSize, layout.cellSize), YELLOW));
+            }
+        }
+    }
+
+    // Shape object for the cursor (created last so it's drawn on top); zero-sized, so it is a point
+    cursor = shapes.create(vec2(0, 0), vec2(0, 0), WHITE);
+}
+
+void Renderer::applyCamera(const GameSnapshot &snapshot) {
+    if (snapshot.camera != camera) {
+        camera = snapshot.camera;
+        mat4 view = camera.getProjection();
+        shaderManager->getShader("rect").use().setMatrix4("projection", view);
+        if (boardRenderer) {
+            shaderManager->getShader("board").use().setMatrix4("projection", view);
+        }
+        if (spriteRenderer) {
+            shaderManager->getShader("sprite").use().setMatrix4("projection", view);
+        }
+    }
+    visibleCells = layout.cellsIn(camera.getVisibleMin(), camera.getVisibleMax(),
+                                  snapshot.board.getWidth(), snapshot.board.getHeight());
+}
+
+void Renderer::syncShapes(const GameSnapshot &snapshot) {
+    shapes.setPos(cursor, snapshot.cursor);
+    if (boardRenderer) { return; }
+
+    // Only lights in view are updated (and drawn), so the cost follows the screen rather than the board.
+    // A skin draws the lights straight from the snapshot instead.
+    const Board &board = snapshot.board;
+    for (int y = visibleCells.y0; y < visibleCells.y1 && !spriteRenderer; y++) {
+        for (int x = visibleCells.x0; x < visibleCells.x1; x++) {
+            int state = snapshot.states > 2 ? snapshot.cells.get(x, y) : board.isLit(x, y);
+            shapes.setColor(lights[y * board.getWidth() + x], palette[state]);
+        }
+    }
+
+    if (shownOutline != snapshot.hoverIndex) {
+        if (shownOutline >= 0) { shapes.setVisible(redOutline[shownOutline], false); }
+        if (snapshot.hoverIndex >= 0) { shapes.setVisible(redOutline[snapshot.hoverIndex], true); }
+        shownOutline = snapshot.hoverIndex;
+    }
+}
+
+void Renderer::drawBoard(const GameSnapshot &snapshot) {
+    if (boardRenderer) {
+        // Off-screen parts of the quad are clipped before any fragment work
+        if (snapshot.states > 2) {
+            boardRenderer->draw(snapshot.cells, snapshot.rowGenerations, snapshot.hoverIndex);
+        } else {
+            boardRenderer->draw(snapshot.board, snapshot.rowGenerations, snapshot.hoverIndex);
+        }
+        return;
+    }
+
+    if (spriteRenderer) {
+        // Every state's image is on the same atlas page: one texture bind and one draw for the grid
+        if (shownOutline >= 0) { rectRenderer->draw(shapes, redOutline[shownOutline], redOutline[shownOutline] + 1); }
+        const vec2 size(layout.cellSize, layout.cellSize);
+        for (int y = visibleCells.y0; y < visibleCells.y1; y++) {
+            for (int x = visibleCells.x0; x < visibleCells.x1; x++) {
+                int state = snapshot.states > 2 ? snapshot.cells.get(x, y) : snapshot.board.isLit(x, y);
+                spriteRenderer->add(textures->getSprite(stateSprites[state]), layout.cellCenter(x, y), size,
+                                    stateTints[state]);
+            }
+        }
+        spriteRenderer->flush();
+        return;
+    }
+
+    // The hover outline goes first so it's behind the lights, then one range per visible row of lights
+    ArenaVector<ShapeRange> visibleRanges{ArenaAllocator<ShapeRange>(arena)};
+    visibleRanges.reserve(visibleCells.y1 - visibleCells.y0 + 1);
+    if (shownOutline >= 0) {
+        visibleRanges.push_back({redOutline[shownOutline], redOutline[shownOutline] + 1});
+    }
+    if (!visibleCells.empty()) {
+        const int width = snapshot.board.getWidth();
+        for (int y = visibleCells.y0; y < visibleCells.y1; y++) {
+            visibleRanges.push_back({lights[y * width + visibleCells.x0], lights[y * width + visibleCells.x1 - 1] + 1});
+        }
+    }
+    rectRenderer->draw(shapes, visibleRanges.data(), visibleRanges.size());
+}
+
+void Renderer::text(string_view message, float x, float y, float scale) {
+    this->fontRenderer->renderText(message, x, y, scale, vec3{WHITE.red, WHITE.green, WHITE.blue});
+}
+
+void Renderer::render(const GameSnapshot &snapshot) {
+    arena.reset();
+    stream->beginFrame();
+
+    // Shaders edited since the last frame are swapped in between frames
+    for (const std::string &name : shaderManager->applyReloads()) {
+        restoreUniforms(name);
+    }
+
+    // Draw objects
+    glClearColor(BLACK.red, BLACK.green, BLACK.blue, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    applyCamera(snapshot);
+    syncShapes(snapshot);
+
+    switch (snapshot.screen) {
+        case Screen::start: {
+            // Display intro screen
+            text("Lights Out!", 260, 500, 1);
+            text("Commands:", 290, 270, 1);
+            text("[i] to show the directions", 100, 240, 1);
+            text("[s] to launch the game", 140, 210, 1);
+            text("[Esc] to quit", 250, 180, 1);
+            if (snapshot.levelCount) { text("[l] to pick a level", 170, 150, 1); }
+            break;
+        }
+        case Screen::instructions: {
+            text("Lights Out!", 260, 500, 1);
+            text("The goal of this game is to", 140, 300, 0.8);
+            text("turn off all the lights.", 170, 270, 0.8);
+            text("Clicking a light inverts it as", 110, 240, 0.8);
+            text("well as its immediate neighbors.", 95, 210, 0.8);
+            text("Right-drag or arrows to pan, wheel or", 45, 180, 0.8);
+            text("[+]/[-] to zoom, [0] to reset the view.", 40, 150, 0.8);
+            text("[z] undo, [y] redo, [b] other branches.", 40, 120, 0.8);
+            text("Press [s] to launch the game when ready", 30, 90, 0.8);
+            break;
+        }
+        case Screen::levels: {
+            // Preview of the level being picked
+            drawBoard(snapshot);
+            text(arena.format("Level %zu", snapshot.level + 1), 550, 500, 0.8);
+            text(arena.format("of %zu", snapshot.levelCount), 550, 470, 0.6);
+            if (snapshot.par >= 0) { text(arena.format("Par: %d", snapshot.par), 550, 420, 0.8); }
+            text("[Left]/[Right] +/-1", 550, 300, 0.5);
+            text("[Down]/[Up] +/-100", 550, 275, 0.5);
+            text("[r] random level", 550, 250, 0.5);
+            text("[s] to play", 550, 225, 0.5);
+            break;
+        }
+        case Screen::play: {
+            // Show the light squares and the hover outline (if there is one)
+            drawBoard(snapshot);
+            if (snapshot.levelCount) {
+                text(arena.format("Level %zu", snapshot.level + 1), 550, 500, 0.8);
+                if (snapshot.par >= 0) { text(arena.format("Par: %d", snapshot.par), 550, 470, 0.8); }
+            }
+
+            // Display the moves taken and the timer
+            text(arena.format("Moves: %d", snapshot.moveCount), 550, 400, 1);
+            text(arena.format("Time: %d", static_cast<int>(snapshot.elapsedSeconds)), 550, 200, 1);
+            break;
+        }
+        case Screen::over: {
+            // Show the lights all turned off
+            drawBoard(snapshot);
+
+            // Celebration particles
+            circleRenderer->draw(snapshot.particlePositions.data(), snapshot.particleRadii.data(),
+                                 snapshot.particleColors.data(), snapshot.particlePositions.size());
+
+            // Show win message
+            text("Winner!", 220, 290, 1);
+            text(arena.format("Moves: %d", snapshot.moveCount), 550, 400, 1);
+            text(arena.format("Time: %d", static_cast<int>(snapshot.elapsedSeconds)), 550, 200, 1);
+            break;
+        }
+    }
+    rectRenderer->draw(shapes, cursor, cursor + 1);
+
+    stream->endFrame();
+}
@@ -0,0 +1,130 @@
+#ifndef GRAPHICS_RENDERER_H
+#define GRAPHICS_RENDERER_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "shaderManager.h"
+#include "fontRenderer.h"
+#include "rectRenderer.h"
+#include "circleRenderer.h"
+#include "boardRenderer.h"
+#include "spriteRenderer.h"
+#include "textureManager.h"
+#include "streamBuffer.h"
+#include "frameArena.h"
+#include "../shapes/shapeStore.h"
+#include "../game/game.h"
+#include "../game/gameSnapshot.h"
+
+using std::unique_ptr, std::vector, glm::mat4, glm::vec3;
+
+/**
+ * @brief Draws game snapshots.
+ * @details Owns every OpenGL object (shaders, buffers, fonts), so it must be created, used and destroyed
+ * on the thread that has the context current. It only reads snapshots and never touches game state.
+ */
+class Renderer {
+public:
+    /// @brief Loads the shaders and creates the shapes for a board of the given size
+    /// @param width Width of the framebuffer
+    /// @param height Height of the framebuffer
+    /// @param layout Where the lights are on screen
+    /// @param board A board with the dimensions that will be drawn
+    /// @param states Number of states of the lights (2 to PALETTE_SIZE)
+    Renderer(int width, int height, const BoardLayout &layout, const Board &board, int states = 2);
+
+    ~Renderer();
+
+    /// @brief Clears the framebuffer and draws the snapshot
+    void render(const GameSnapshot &snapshot);
+
+    /// @brief Reloads the shaders whenever their files in res/shaders change (see ShaderManager::watch())
+    void watchShaders();
+
+    /**
+     * @brief Draws the lights with images from a skin directory instead of flat squares
+     * @details State s is drawn with "s.png" if the skin has one, else with "light.png" tinted by the state's
+     * color. The images are decoded on worker threads and packed into one atlas (see TextureManager), so the
+     * whole grid is still one draw call. Huge boards (see BoardRenderer) have no per-light shapes to skin.
+     *
+     * @param directory The skin directory, e.g. ../res/skins/bevel
+     * @return false if the skin can't be used (the board keeps its flat squares)
+     */
+    bool loadSkin(const std::string &directory);
+
+private:
+    const int FONT_SIZE = 24;
+    int width, height;
+    BoardLayout layout;
+
+    /// @brief Number of states of the lights, and the packed color of each (see stateColor())
+    int states;
+    uint32_t palette[PALETTE_SIZE];
+
+    /// @brief Responsible for loading and storing all the shaders used in the project.
+    unique_ptr<ShaderManager> shaderManager;
+
+    /// @brief All per-frame vertex data (text quads, rect and circle instances) is sub-allocated from here.
+    unique_ptr<StreamBuffer> stream;
+    unique_ptr<FontRenderer> fontRenderer;
+    unique_ptr<RectRenderer> rectRenderer;
+    unique_ptr<CircleRenderer> circleRenderer;
+
+    /// @brief Draws huge boards from a texture; null for boards small enough for a shape per light
+    unique_ptr<BoardRenderer> boardRenderer;
+
+    /// @brief The skin's images and the renderer that draws the lights with them; null without a skin
+    unique_ptr<TextureManager> textures;
+    unique_ptr<SpriteRenderer> spriteRenderer;
+    /// @brief The sprite and tint of each state of the lights
+    SpriteHandle stateSprites[PALETTE_SIZE] = {};
+    uint32_t stateTints[PALETTE_SIZE] = {};
+
+    /// @brief Every rectangle on screen, drawn in slot order: outlines, then lights, then the cursor
+    ShapeStore shapes;
+    vector<ShapeHandle> lights;
+    vector<ShapeHandle> redOutline;
+    ShapeHandle cursor{};
+
+    /// @brief The outline currently marked visible, or -1
+    int shownOutline = -1;
+
+    /// @brief Lights inside the camera's view, found every frame
+    CellRange visibleCells;
+
+    /// @brief Memory for data that only lives during render() (text, draw ranges); reset every frame
+    FrameArena arena;
+
+    /// @brief The camera the world-space shaders' projections were last set from
+    Camera camera;
+
+    /// @brief Projection matrix for screen-space drawing (orthographic projection, 1st quadrant).
+    /// @details The board and the cursor use the snapshot's camera instead (see applyCamera()).
+    mat4 projection;
+
+    /// @brief Loads shaders from files and stores them in the shaderManager.
+    /// @details Renderers are initialized here.
+    void initShaders(const Board &board);
+
+    /// @brief Initializes the shapes to be rendered.
+    void initShapes(const Board &board);
+
+    /// @brief Sets the uniforms of a shader again after its program was reloaded
+    void restoreUniforms(const std::string &name);
+
+    /// @brief Points the world-space shaders at the snapshot's camera (if it moved) and finds the visible lights
+    void applyCamera(const GameSnapshot &snapshot);
+
+    /// @brief Copies the snapshot's visible lights, hover outline and cursor into the shape store
+    void syncShapes(const GameSnapshot &snapshot);
+
+    /// @brief Draws the lights and the hover outline
+    void drawBoard(const GameSnapshot &snapshot);
+
+    /// @brief Draws a line of white text
+    void text(std::string_view message, float x, float y, float scale);
+};
+
+#endif //GRAPHICS_RENDERER_H
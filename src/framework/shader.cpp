@@ -1,48 +1,122 @@
 #include "shader.h"
 
+#include <cstring>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+namespace {
+/// @brief Set by Shader::enableParallelCompile()
+bool parallelCompile = false;
+
+/// @brief Whether the driver can tell the size of a linked program (GL_ARB_get_program_binary, core in GL 4.1)
+bool hasProgramBinary() {
+    static const bool supported = []() {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint ii = 0; ii < count; ii++) {
+            const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, ii));
+            if (name != nullptr && !strcmp(name, "GL_ARB_get_program_binary"))
+                return true;
+        }
+        return false;
+    }();
+    return supported;
+}
+}
+
 Shader &Shader::use() {
-    glUseProgram(this->ID);
+    GLState::get().useProgram(this->ID);
     return *this;
 }
 
-void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
-    unsigned int sVertex, sFragment, gShader;
-
-    // vertex Shader
-    sVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sVertex, 1, &vertexSource, NULL);
-    glCompileShader(sVertex);
-    checkCompileErrors(sVertex, "VERTEX");
-
-    // fragment Shader
-    sFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(sFragment, 1, &fragmentSource, NULL);
-    glCompileShader(sFragment);
-    checkCompileErrors(sFragment, "FRAGMENT");
+bool Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+    return finishCompile(startCompile(vertexSource, fragmentSource, geometrySource));
+}
 
-    // if geometry shader source code is given, also compile geometry shader
-    if (geometrySource != nullptr) {
-        gShader = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(gShader, 1, &geometrySource, NULL);
-        glCompileShader(gShader);
-        checkCompileErrors(gShader, "GEOMETRY");
-    }
+PendingProgram Shader::startCompile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+    PendingProgram pending;
+    auto stage = [&pending](GLenum type, const char *source) {
+        unsigned int shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+        pending.stages[pending.stageCount++] = shader;
+    };
+
+    // vertex and fragment shaders, and the geometry shader if its source code is given
+    stage(GL_VERTEX_SHADER, vertexSource);
+    stage(GL_FRAGMENT_SHADER, fragmentSource);
+    if (geometrySource != nullptr)
+        stage(GL_GEOMETRY_SHADER, geometrySource);
 
     // shader program
-    this->ID = glCreateProgram();
-    glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
-    if (geometrySource != nullptr)
-        glAttachShader(this->ID, gShader);
+    pending.program = GLResources::create(GLKind::program, "Shader");
+    for (int ii = 0; ii < pending.stageCount; ii++)
+        glAttachShader(pending.program, pending.stages[ii]);
+    glLinkProgram(pending.program);
+    return pending;
+}
 
-    glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+bool Shader::finishCompile(const PendingProgram &pending) {
+    static const char *STAGE_TYPES[] = {"VERTEX", "FRAGMENT", "GEOMETRY"};
+    bool success = true;
+    for (int ii = 0; ii < pending.stageCount; ii++)
+        success = checkCompileErrors(pending.stages[ii], STAGE_TYPES[ii]) && success;
+    // a stage that failed already explains why the link did
+    success = success && checkCompileErrors(pending.program, "PROGRAM");
 
     // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(sVertex);
-    glDeleteShader(sFragment);
-    if (geometrySource != nullptr)
-        glDeleteShader(gShader);
+    for (int ii = 0; ii < pending.stageCount; ii++)
+        glDeleteShader(pending.stages[ii]);
+
+    if (!success) {
+        GLResources::destroy(GLKind::program, pending.program);
+        return false;
+    }
+    GLResources::destroy(GLKind::program, this->ID);
+    this->ID = pending.program;
+
+    // the size of the linked binary is the closest thing to the program's share of GPU memory
+    if (hasProgramBinary()) {
+        int binaryLength = 0;
+        glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        GLResources::get().setBytes(GLKind::program, this->ID, static_cast<size_t>(binaryLength));
+    }
+    return true;
+}
+
+bool Shader::enableParallelCompile() {
+    static const bool supported = []() {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint ii = 0; ii < count; ii++) {
+            const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, ii));
+            if (name != nullptr && (!strcmp(name, "GL_KHR_parallel_shader_compile")
+                                    || !strcmp(name, "GL_ARB_parallel_shader_compile")))
+                return true;
+        }
+        return false;
+    }();
+#ifdef GL_KHR_parallel_shader_compile
+    // 0xFFFFFFFF asks for as many threads as the implementation wants to use
+    if (supported && glMaxShaderCompilerThreadsKHR != nullptr)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+#endif
+    parallelCompile = supported;
+    return supported;
+}
+
+bool Shader::isCompileDone(const PendingProgram &pending) {
+    if (!parallelCompile)
+        return true;
+    // the program only completes once its stages have, so one query covers them all
+    int done = GL_FALSE;
+    glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
 }
 
 void Shader::setFloat(const char *name, float value) const {
@@ -83,7 +157,7 @@ void Shader::setMatrix4(const char *name, const glm::mat4 &matrix) const {
 }
 
 
-void Shader::checkCompileErrors(unsigned int object, string type) {
+bool Shader::checkCompileErrors(unsigned int object, string type) {
     int success;
     char infoLog[1024];
 
@@ -106,4 +180,5 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
                       << endl;
         }
     }
-}
\ No newline at end of file
+    return success;
+}
@@ -4,17 +4,26 @@
 #include <string>
 
 #include <glad/glad.h>
+#include "glState.h"
+#include "glResources.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 using std::string, std::ifstream, std::stringstream, std::cout, std::endl;
 
+/// @brief A program whose stages have been submitted to the driver but not checked yet (see Shader::startCompile())
+struct PendingProgram {
+    unsigned int program = 0;
+    unsigned int stages[3] = {};
+    int stageCount = 0;
+};
+
 /// @brief General purpose shader object.
 /// @details Compiles from file, generates compile/link-time error messages and hosts several utility functions for easy management.
 class Shader {
     public:
-        /// @brief The shader program ID
-        unsigned int ID;
+        /// @brief The shader program ID (0 until a compile succeeds)
+        unsigned int ID = 0;
 
         /// @brief Construct a new Shader object
         Shader() { }
@@ -29,7 +38,27 @@ class Shader {
         /// @param vertexSource the source code for the vertex shader
         /// @param fragmentSource the source code for the fragment shader
         /// @param geometrySource the source code for the geometry shader (optional)
-        void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
+        /// @return false if a stage failed to compile or the program failed to link (the previous program is kept)
+        bool compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
+
+        /// @brief Submits the stages and the link without asking for the result
+        /// @details Nothing here waits for the driver, so the work can overlap with the frames until finishCompile().
+        static PendingProgram startCompile(const char *vertexSource, const char *fragmentSource,
+                                           const char *geometrySource = nullptr);
+
+        /// @brief Checks a program from startCompile() and, if it linked, replaces this shader's program with it
+        /// @details Uniforms are per program, so the caller has to set them again after a replacement.
+        /// @return false if it failed (the errors are printed, the new program is deleted and the old one kept)
+        bool finishCompile(const PendingProgram &pending);
+
+        /// @brief Lets the driver compile and link on its own threads, with GL_KHR_parallel_shader_compile
+        /// @details Checks for the extension once (with a current context) and asks for as many threads as it has.
+        /// @return true if the extension is there, so isCompileDone() can be asked without blocking
+        static bool enableParallelCompile();
+
+        /// @brief Whether finishCompile() can check a program from startCompile() without waiting for the driver
+        /// @details Always true without GL_KHR_parallel_shader_compile (finishCompile() then waits instead).
+        static bool isCompileDone(const PendingProgram &pending);
 
         // ------------------------------------------------------------------------
         // utility functions
@@ -93,7 +122,8 @@ class Shader {
         /// @brief Checks if compilation or linking failed and if so, print the error logs
         /// @param object the shader object to check
         /// @param type the type of shader object (vertex, fragment, geometry)
-        void checkCompileErrors(unsigned int object, std::string type);
+        /// @return true if it compiled (or linked)
+        bool checkCompileErrors(unsigned int object, std::string type);
 };
 
 #endif
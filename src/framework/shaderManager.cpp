@@ -1,63 +1,272 @@
 #include "shaderManager.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 ShaderManager::~ShaderManager() {
+#ifdef __linux__
+    if (watcher.joinable()) {
+        char wake = 0;
+        (void)!write(wakeFds[1], &wake, 1);
+        watcher.join();
+        close(wakeFds[0]);
+        close(wakeFds[1]);
+        close(watchFd);
+    }
+#endif
+    // Programs still being linked were never swapped in
+    for (const Build &build : linking) {
+        for (int ii = 0; ii < build.pending.stageCount; ii++)
+            glDeleteShader(build.pending.stages[ii]);
+        GLResources::destroy(GLKind::program, build.pending.program);
+    }
     clear();
 }
 
-Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile,
-                                 std::string name) {
-    shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+Shader &ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile,
+                                  std::string name, const std::vector<std::string> &defines) {
+    addShader(vShaderFile, fShaderFile, gShaderFile, name, defines);
+    compileQueued(false);
     return shaders[name];
 }
 
+void ShaderManager::addShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile,
+                              std::string name, const std::vector<std::string> &defines) {
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        ShaderFiles &paths = files[name];
+        paths = {vShaderFile, fShaderFile, gShaderFile != nullptr ? gShaderFile : "", defines, {}};
+        paths.dependencies = {paths.vertex, paths.fragment, paths.geometry};
+    }
+    shaders[name];
+    if (std::find(queued.begin(), queued.end(), name) == queued.end()) { queued.push_back(name); }
+}
+
+bool ShaderManager::compileAll() {
+    return compileQueued(true);
+}
+
 Shader& ShaderManager::getShader(std::string name) {
     return shaders[name];
 }
 
 void ShaderManager::clear() {
-    // delete all shaders: "iter" here is const std::pair<std::string, Shader>&, so we need to use
-    // "iter.second" to get the Shader, and delete the program by ID
-    for (const auto& iter : shaders)
-        glDeleteProgram(iter.second.ID);
-}
-
-Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
-    // 1. retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
-    }
-    catch (std::exception& e) {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
-    }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    // 2. now create shader object from source code
-    Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
-    return shader;
-}
\ No newline at end of file
+    // delete all programs: "iter" here is std::pair<const std::string, Shader>&, so we need to use
+    // "iter.second" to get the Shader, and delete the program by ID. The ID is reset so that a second
+    // clear() doesn't delete a name GL has handed out again since.
+    for (auto& iter : shaders) {
+        GLResources::destroy(GLKind::program, iter.second.ID);
+        iter.second.ID = 0;
+    }
+}
+
+bool ShaderManager::compileQueued(bool report) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const bool parallel = Shader::enableParallelCompile();
+    bool success = true;
+
+    // 1. preprocess and submit everything; nothing here waits for the driver
+    std::vector<Build> builds;
+    std::vector<Clock::time_point> submitted;
+    builds.reserve(queued.size());
+    for (const std::string &name : queued) {
+        const auto begin = Clock::now();
+        ShaderFiles paths;
+        {
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            paths = files[name];
+        }
+        Build build{name, variantName(name, paths.defines), {}, {}};
+        if (!readSources(paths, build.sources)) {
+            success = false;
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            files[name].dependencies = dependencies(build.sources);
+        }
+        build.pending = startCompile(build.sources);
+        builds.push_back(std::move(build));
+        submitted.push_back(begin);
+    }
+    queued.clear();
+
+    // 2. check each program once the driver is done with it
+    std::vector<double> milliseconds(builds.size(), -1.0);
+    for (size_t remaining = builds.size(); remaining > 0;) {
+        bool progress = false;
+        for (size_t ii = 0; ii < builds.size(); ii++) {
+            if (milliseconds[ii] >= 0 || !Shader::isCompileDone(builds[ii].pending)) { continue; }
+            success = finishCompile(builds[ii]) && success;
+            milliseconds[ii] = std::chrono::duration<double, std::milli>(Clock::now() - submitted[ii]).count();
+            remaining--;
+            progress = true;
+        }
+        if (!progress) { std::this_thread::sleep_for(std::chrono::microseconds(100)); }
+    }
+
+    if (report && !builds.empty()) {
+        printf("Compiled %zu shader variants in %.1f ms (%s)\n", builds.size(),
+               std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+               parallel ? "in parallel, GL_KHR_parallel_shader_compile" : "one at a time");
+        for (size_t ii = 0; ii < builds.size(); ii++)
+            printf("  %-28s %6.1f ms\n", builds[ii].variant.c_str(), milliseconds[ii]);
+    }
+    return success;
+}
+
+bool ShaderManager::readSources(const ShaderFiles &paths, ShaderSources &sources) {
+    sources.hasGeometry = !paths.geometry.empty();
+    return preprocessShader(paths.vertex, paths.defines, sources.vertex)
+           && preprocessShader(paths.fragment, paths.defines, sources.fragment)
+           && (!sources.hasGeometry || preprocessShader(paths.geometry, paths.defines, sources.geometry));
+}
+
+std::vector<std::string> ShaderManager::dependencies(const ShaderSources &sources) {
+    std::vector<std::string> result;
+    for (const ShaderSource *stage : {&sources.vertex, &sources.fragment, &sources.geometry}) {
+        for (const std::string &file : stage->files) {
+            if (std::find(result.begin(), result.end(), file) == result.end()) { result.push_back(file); }
+        }
+    }
+    return result;
+}
+
+std::string ShaderManager::variantName(const std::string &name, const std::vector<std::string> &defines) {
+    std::string variant = name;
+    for (size_t ii = 0; ii < defines.size(); ii++)
+        variant += (ii == 0 ? " [" : " ") + defines[ii];
+    return defines.empty() ? variant : variant + "]";
+}
+
+PendingProgram ShaderManager::startCompile(const ShaderSources &sources) {
+    return Shader::startCompile(sources.vertex.code.c_str(), sources.fragment.code.c_str(),
+                                sources.hasGeometry ? sources.geometry.code.c_str() : nullptr);
+}
+
+bool ShaderManager::finishCompile(const Build &build) {
+    if (shaders[build.name].finishCompile(build.pending)) { return true; }
+
+    // The driver's log names files by number ("1:12" is line 12 of file 1)
+    std::cout << "ERROR::SHADER: " << build.variant << " failed to build. Files in the log:" << std::endl;
+    const char *stageNames[] = {"vertex", "fragment", "geometry"};
+    const ShaderSource *stages[] = {&build.sources.vertex, &build.sources.fragment, &build.sources.geometry};
+    for (int stage = 0; stage < (build.sources.hasGeometry ? 3 : 2); stage++) {
+        std::cout << "  " << stageNames[stage] << ":";
+        for (size_t ii = 0; ii < stages[stage]->files.size(); ii++)
+            std::cout << (ii == 0 ? " " : ", ") << ii << " = " << stages[stage]->files[ii];
+        std::cout << std::endl;
+    }
+    return false;
+}
+
+// --------------------------------------------------------
+// Hot reload
+// --------------------------------------------------------
+
+void ShaderManager::watch(const std::string &directory) {
+#ifdef __linux__
+    if (watcher.joinable()) { return; }
+    // Editors either write the file in place or write a new one and rename it over the old one
+    watchFd = inotify_init1(IN_CLOEXEC);
+    if (watchFd < 0 || inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0
+        || pipe(wakeFds) != 0) {
+        std::cout << "ERROR::SHADER: Could not watch " << directory << " for changes" << std::endl;
+        if (watchFd >= 0) { close(watchFd); }
+        watchFd = -1;
+        return;
+    }
+    watcher = std::thread(&ShaderManager::watchLoop, this);
+#else
+    std::cout << "ERROR::SHADER: Watching " << directory << " needs inotify (Linux only)" << std::endl;
+#endif
+}
+
+void ShaderManager::watchLoop() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{watchFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        if (fds[1].revents) { break; }
+        ssize_t length = read(watchFd, buffer, sizeof(buffer));
+        if (length <= 0) { continue; }
+
+        // One save can raise several events; each shader is read once per batch
+        std::vector<std::string> names;
+        for (char *event = buffer; event < buffer + length;) {
+            const auto *info = reinterpret_cast<const inotify_event *>(event);
+            if (info->len) { names.emplace_back(info->name); }
+            event += sizeof(inotify_event) + info->len;
+        }
+        std::vector<std::pair<std::string, ShaderFiles>> affected;
+        {
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            for (const auto &[name, paths] : files) {
+                for (const std::string &file : paths.dependencies) {
+                    std::string filename = std::filesystem::path(file).filename().string();
+                    if (!file.empty() && std::find(names.begin(), names.end(), filename) != names.end()) {
+                        affected.emplace_back(name, paths);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The disk is only touched here, never on the render thread
+        for (const auto &[name, paths] : affected) {
+            ShaderSources sources;
+            if (!readSources(paths, sources)) { continue; }
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            // An edit can add or drop an include
+            files[name].dependencies = dependencies(sources);
+            changed[name] = std::move(sources);
+            changedPending = true;
+        }
+    }
+#endif
+}
+
+std::vector<std::string> ShaderManager::applyReloads() {
+    std::vector<std::string> swapped;
+
+    // Programs submitted earlier have had at least a frame to compile and link
+    for (auto build = linking.begin(); build != linking.end();) {
+        if (!Shader::isCompileDone(build->pending)) {
+            ++build;
+            continue;
+        }
+        if (finishCompile(*build)) {
+            std::cout << "Reloaded shader " << build->variant << std::endl;
+            swapped.push_back(build->name);
+        } else {
+            std::cout << "ERROR::SHADER: Keeping the previous " << build->name << " program" << std::endl;
+        }
+        build = linking.erase(build);
+    }
+
+    if (changedPending.exchange(false)) {
+        std::map<std::string, ShaderSources> ready;
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        ready.swap(changed);
+        for (auto &[name, sources] : ready) {
+            Build build{name, variantName(name, files[name].defines), std::move(sources), {}};
+            build.pending = startCompile(build.sources);
+            linking.push_back(std::move(build));
+        }
+    }
+    return swapped;
+}
@@ -2,9 +2,14 @@
 #define GRAPHICS_SHADERMANAGER_H
 
 #include "shader.h"
+#include "shaderSource.h"
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -14,37 +19,136 @@ public:
     /// @brief Default constructor
     ShaderManager() = default;
     /// @brief Default destructor
-    /// @details Clears the shaders map
+    /// @details Stops the file watcher and deletes the programs (so it must go before the context does)
     ~ShaderManager();
 
+    ShaderManager(const ShaderManager &) = delete;
+    ShaderManager &operator=(const ShaderManager &) = delete;
 
-    /// @brief Calls loadShaderFromFile() and stores the shader in the shaders map
+    /// @brief Compiles a shader right away and stores it in the shaders map
+    /// @details The shader keeps its place in the map, so references to it stay valid (and see reloads).
+    /// Loading several shaders is faster with addShader() and compileAll().
     /// @param vShaderFile The vertex shader file
     /// @param fShaderFile The fragment shader file
     /// @param gShaderFile The geometry shader file (optional)
     /// @param name Name used for the shader in the shaders map
+    /// @param defines The variant to build (see preprocessShader())
     /// @return The shader that was loaded
-    Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+    Shader &loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name,
+                       const std::vector<std::string> &defines = {});
+
+    /// @brief Queues a shader for the next compileAll()
+    /// @details The files are preprocessed (see preprocessShader()), so the same files can be added under several
+    /// names with different defines, one variant each. The shader is in the map (with no program) right away.
+    /// @param vShaderFile The vertex shader file
+    /// @param fShaderFile The fragment shader file
+    /// @param gShaderFile The geometry shader file (optional)
+    /// @param name Name used for the shader in the shaders map
+    /// @param defines The variant to build
+    void addShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name,
+                   const std::vector<std::string> &defines = {});
+
+    /**
+     * @brief Compiles every queued shader, and prints how long each variant took
+     * @details All the programs are submitted before any status is asked for, since asking blocks until the
+     * driver is done. With GL_KHR_parallel_shader_compile the driver compiles them on its own threads and
+     * each one is checked as soon as it reports completion; without it, checking the first program waits
+     * for it while the driver may carry on with the rest.
+     *
+     * @return false if a shader failed to compile or link (the errors are printed)
+     */
+    bool compileAll();
 
     /// @brief Returns a reference to the shader with the given name in the shaders map
     /// @param name The name of the shader
     /// @return The shader with the given name
     Shader& getShader(std::string name);
 
-     /// @brief Clears the shaders map
+    /// @brief Deletes every shader's program (requires the context that created them)
+    /// @details The shaders stay in the map, without a program, so references to them stay valid.
     void clear();
 
+    /**
+     * @brief Reloads shaders when their files change (Linux only, with inotify)
+     * @details A watcher thread waits for files in the directory to be written (or renamed into it, as
+     * editors do when saving) and reads the sources of every shader that uses them, so the render thread
+     * never waits on the disk. applyReloads() then swaps the new programs in.
+     *
+     * @param directory The directory the shader files are in
+     */
+    void watch(const std::string &directory);
+
+    /**
+     * @brief Swaps in reloaded shaders; call at the start of a frame on the render thread
+     * @details Sources read since the last call are submitted to the driver, and programs submitted by earlier
+     * calls are checked and swapped in, so compiling and linking overlap a frame instead of stalling one. With
+     * GL_KHR_parallel_shader_compile a program the driver hasn't finished waits for a later frame. A program
+     * that fails to compile or link is dropped and the previous one kept.
+     *
+     * @return Names of the shaders whose program changed: their uniforms have to be set again
+     */
+    std::vector<std::string> applyReloads();
+
 private:
     /// @brief A map of shaders, with the key being the name of the shader
     std::map<std::string, Shader> shaders;
 
-     /// @brief Loads and compiles a shader from a file
-     /// @details This function is private because we only want to load shaders from within this class
-     /// @param vShaderFile The vertex shader file
-     /// @param fShaderFile The fragment shader file
-     /// @param gShaderFile The geometry shader file (optional)
-     /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);
+    /// @brief The files each shader was loaded from, and their contents
+    struct ShaderFiles {
+        std::string vertex, fragment, geometry;
+        std::vector<std::string> defines;
+        /// @brief Every file the last build read, includes too: a change to any of them reloads the shader
+        std::vector<std::string> dependencies;
+    };
+    struct ShaderSources {
+        ShaderSource vertex, fragment, geometry;
+        bool hasGeometry = false;
+    };
+    std::map<std::string, ShaderFiles> files;
+    /// @brief Shaders added since the last compileAll()
+    std::vector<std::string> queued;
+
+    // Hot reload: the watcher thread fills changed, the render thread empties it
+    std::thread watcher;
+    int watchFd = -1;
+    /// @brief Written to wake the watcher up when it should stop
+    int wakeFds[2] = {-1, -1};
+    std::mutex reloadMutex;
+    std::map<std::string, ShaderSources> changed;
+    std::atomic<bool> changedPending{false};
+    /// @brief A program submitted to the driver, and what it was built from
+    struct Build {
+        std::string name;
+        /// @brief The name and defines, for messages (see variantName())
+        std::string variant;
+        ShaderSources sources;
+        PendingProgram pending;
+    };
+    /// @brief Programs submitted by applyReloads() that haven't been checked yet
+    std::vector<Build> linking;
+
+    /// @brief Loop run by the watcher thread: wait for file events, read the shaders that use the files
+    void watchLoop();
+
+    /// @brief Compiles the queued shaders (see compileAll())
+    /// @param report Whether to print the time each variant took
+    bool compileQueued(bool report);
+
+    /// @brief Reads and preprocesses the sources of a shader
+    /// @return false (after printing an error) if a file can't be read
+    static bool readSources(const ShaderFiles &paths, ShaderSources &sources);
+
+    /// @brief The files a build of a shader read, each once
+    static std::vector<std::string> dependencies(const ShaderSources &sources);
+
+    /// @brief Name and defines of a shader, e.g. "rect [INSTANCED]"
+    static std::string variantName(const std::string &name, const std::vector<std::string> &defines);
+
+    /// @brief Submits a shader's sources to the driver (see Shader::startCompile())
+    static PendingProgram startCompile(const ShaderSources &sources);
+
+    /// @brief Checks a submitted program and swaps it into its shader; prints which file is which if it failed
+    bool finishCompile(const Build &build);
 };
 
 #endif //GRAPHICS_SHADERMANAGER_H
@@ -0,0 +1,74 @@
+#include "shaderSource.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+/// @brief Returns the file named by an `#include "file"` line, or an empty string for any other line
+std::string includedFile(const std::string &line) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line.compare(start, 8, "#include") != 0) { return ""; }
+    size_t open = line.find('"', start + 8), close = line.find('"', open + 1);
+    if (open == std::string::npos || close == std::string::npos) { return ""; }
+    return line.substr(open + 1, close - open - 1);
+}
+
+/// @brief The #define lines of a variant; "NAME=VALUE" is taken as "NAME VALUE"
+std::string defineLines(const std::vector<std::string> &defines) {
+    std::string lines;
+    for (std::string define : defines) {
+        size_t equals = define.find('=');
+        if (equals != std::string::npos) { define[equals] = ' '; }
+        lines += "#define " + define + "\n";
+    }
+    return lines;
+}
+
+bool expand(const std::filesystem::path &path, const std::vector<std::string> &defines, ShaderSource &source) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "ERROR::SHADER: Failed to read shader file " << path.string() << std::endl;
+        return false;
+    }
+    const std::string index = std::to_string(source.files.size());
+    const bool root = source.files.empty();
+    source.files.push_back(path.string());
+    if (!root) { source.code += "#line 1 " + index + "\n"; }
+
+    bool definesPending = root && !defines.empty();
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+        if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+        std::string include = includedFile(line);
+        if (include.empty()) {
+            source.code += line;
+            source.code += '\n';
+        } else {
+            std::filesystem::path target = (path.parent_path() / include).lexically_normal();
+            if (std::find(source.files.begin(), source.files.end(), target.string()) == source.files.end()) {
+                if (!expand(target, {}, source)) { return false; }
+                source.code += "#line " + std::to_string(number + 1) + " " + index + "\n";
+            } else {
+                // Already included: keep the line so the numbering still matches
+                source.code += '\n';
+            }
+        }
+
+        // The variant's defines follow #version, which has to come first
+        if (definesPending && line.compare(0, 8, "#version") == 0) {
+            source.code += defineLines(defines) + "#line " + std::to_string(number + 1) + " 0\n";
+            definesPending = false;
+        }
+    }
+    if (definesPending) { source.code = defineLines(defines) + "#line 1 0\n" + source.code; }
+    return true;
+}
+}
+
+bool preprocessShader(const std::string &path, const std::vector<std::string> &defines, ShaderSource &source) {
+    source = ShaderSource{};
+    return expand(std::filesystem::path(path).lexically_normal(), defines, source);
+}
@@ -0,0 +1,30 @@
+#ifndef GRAPHICS_SHADERSOURCE_H
+#define GRAPHICS_SHADERSOURCE_H
+
+#include <string>
+#include <vector>
+
+/// @brief One shader stage after preprocessing
+struct ShaderSource {
+    /// @brief The GLSL to compile
+    std::string code;
+    /// @brief The files it was built from: file i is source string i in the #line directives, so an error
+    /// reported at "1:12" in the driver's log is on line 12 of files[1]
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Reads a shader file, expands its includes and adds the defines of a variant
+ * @details A line `#include "file"` is replaced by that file (relative to the including one), and each
+ * file is only included once per stage. `#line` directives keep the line numbers in the driver's error log
+ * pointing into the original files. The defines ("NAME", "NAME VALUE" or "NAME=VALUE") go right after the
+ * `#version` line, so one file can hold several variants behind `#ifdef`.
+ *
+ * @param path The shader file
+ * @param defines The defines of the variant
+ * @param source Receives the code and the files it came from
+ * @return false (after printing an error) if a file can't be read
+ */
+bool preprocessShader(const std::string &path, const std::vector<std::string> &defines, ShaderSource &source);
+
+#endif //GRAPHICS_SHADERSOURCE_H
@@ -0,0 +1,84 @@
+#include "skylinePacker.h"
+
+#include <algorithm>
+#include <climits>
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height) {
+    skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::fits(size_t index, int rectWidth, int rectHeight, int &y, int &wasted) const {
+    const int x = skyline[index].x;
+    if (x + rectWidth > width) { return false; }
+
+    // The rectangle rests on the highest segment under it; the gaps below it are wasted
+    y = 0;
+    for (size_t ii = index; ii < skyline.size() && skyline[ii].x < x + rectWidth; ii++) {
+        y = std::max(y, skyline[ii].y);
+    }
+    if (y + rectHeight > height) { return false; }
+    wasted = 0;
+    for (size_t ii = index; ii < skyline.size() && skyline[ii].x < x + rectWidth; ii++) {
+        int covered = std::min(skyline[ii].x + skyline[ii].width, x + rectWidth) - skyline[ii].x;
+        wasted += (y - skyline[ii].y) * covered;
+    }
+    return true;
+}
+
+bool SkylinePacker::pack(int rectWidth, int rectHeight, int &x, int &y) {
+    if (rectWidth <= 0 || rectHeight <= 0) { return false; }
+
+    // Lowest top edge wins, then the least waste
+    size_t best = skyline.size();
+    int bestTop = INT_MAX, bestWasted = INT_MAX, bestY = 0;
+    for (size_t ii = 0; ii < skyline.size(); ii++) {
+        int restY, wasted;
+        if (!fits(ii, rectWidth, rectHeight, restY, wasted)) { continue; }
+        if (restY + rectHeight < bestTop || (restY + rectHeight == bestTop && wasted < bestWasted)) {
+            best = ii;
+            bestTop = restY + rectHeight;
+            bestWasted = wasted;
+            bestY = restY;
+        }
+    }
+    if (best == skyline.size()) { return false; }
+    x = skyline[best].x;
+    y = bestY;
+
+    // The new segment replaces (or cuts into) the segments it covers
+    const int right = x + rectWidth;
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best), Segment{x, bestTop, rectWidth});
+    size_t next = best + 1;
+    while (next < skyline.size() && skyline[next].x < right) {
+        Segment &segment = skyline[next];
+        if (segment.x + segment.width <= right) {
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(next));
+        } else {
+            segment.width -= right - segment.x;
+            segment.x = right;
+            break;
+        }
+    }
+
+    // Neighbours at the same height become one segment
+    for (size_t ii = 0; ii + 1 < skyline.size();) {
+        if (skyline[ii].y == skyline[ii + 1].y) {
+            skyline[ii].width += skyline[ii + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(ii + 1));
+        } else {
+            ii++;
+        }
+    }
+    usedArea += static_cast<size_t>(rectWidth) * rectHeight;
+    return true;
+}
+
+float SkylinePacker::getOccupancy() const {
+    return static_cast<float>(usedArea) / (static_cast<float>(width) * static_cast<float>(height));
+}
+
+int SkylinePacker::getUsedHeight() const {
+    int used = 0;
+    for (const Segment &segment : skyline) { used = std::max(used, segment.y); }
+    return used;
+}
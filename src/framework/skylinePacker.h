@@ -0,0 +1,51 @@
+#ifndef GRAPHICS_SKYLINEPACKER_H
+#define GRAPHICS_SKYLINEPACKER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Places rectangles in a fixed-size page (an atlas), bottom-left first.
+ * @details Keeps only the skyline: the top edge of everything placed so far, as a list of horizontal
+ * segments. A rectangle goes wherever it would end lowest (then where it leaves the least space under it),
+ * resting on the segments below it. Space under an overhang is never used again, which costs little when
+ * rectangles are added tallest first.
+ */
+class SkylinePacker {
+public:
+    /// @brief Starts an empty page
+    SkylinePacker(int width, int height);
+
+    /**
+     * @brief Finds room for a rectangle and marks it used
+     *
+     * @param width Width of the rectangle
+     * @param height Height of the rectangle
+     * @param x Receives the left edge
+     * @param y Receives the bottom edge
+     * @return false if it doesn't fit anywhere (nothing changes)
+     */
+    bool pack(int width, int height, int &x, int &y);
+
+    /// @brief Fraction of the page covered by rectangles
+    float getOccupancy() const;
+
+    /// @brief Height of the tallest column: nothing above it is used
+    int getUsedHeight() const;
+
+private:
+    /// @brief A stretch of the skyline: [x, x + width) is used up to y
+    struct Segment {
+        int x, y, width;
+    };
+
+    int width, height;
+    size_t usedArea = 0;
+    std::vector<Segment> skyline;
+
+    /// @brief Where a rectangle starting at segment index would rest
+    /// @return false if it would stick out of the page
+    bool fits(size_t index, int width, int height, int &y, int &wasted) const;
+};
+
+#endif //GRAPHICS_SKYLINEPACKER_H
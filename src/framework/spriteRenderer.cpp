@@ -0,0 +1,61 @@
+#include "spriteRenderer.h"
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstring>
+
+SpriteRenderer::SpriteRenderer(Shader &shader, StreamBuffer &stream) : shader(shader), stream(stream) {
+    this->initRenderData();
+}
+
+void SpriteRenderer::initRenderData() {
+    // No vertex buffer: the quad's corners come from gl_VertexID
+    this->VAO.create("SpriteRenderer");
+    GLState::get().bindVertexArray(this->VAO);
+
+    // Per-instance rect, texture corners and tint; flush() points them at the frame's allocation
+    for (GLuint attribute = 0; attribute < 3; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+
+    GLState::get().bindVertexArray(0);
+}
+
+void SpriteRenderer::add(const Sprite &sprite, vec2 center, vec2 size, uint32_t color) {
+    if (sprite.texture == 0) { return; }
+    instances.push_back({center.x, center.y, size.x, size.y, sprite.uv.x, sprite.uv.y, sprite.uv.z, sprite.uv.w, color});
+    if (!runs.empty() && runs.back().texture == sprite.texture) {
+        runs.back().count++;
+    } else {
+        runs.push_back({sprite.texture, 1});
+    }
+}
+
+void SpriteRenderer::flush() {
+    if (instances.empty()) { return; }
+
+    GLintptr offset;
+    void *mapped = stream.map(instances.size() * sizeof(Instance), alignof(Instance), offset);
+    if (mapped) {
+        memcpy(mapped, instances.data(), instances.size() * sizeof(Instance));
+        stream.unmap();
+
+        this->shader.use();
+        GLState::get().bindVertexArray(this->VAO);
+        GLState::get().bindBuffer(GL_ARRAY_BUFFER, stream.getId());
+        GLState::get().activeTexture(GL_TEXTURE0);
+
+        // GL 3.3 has no base instance, so each run moves the attribute pointers to its first instance
+        for (const Run &run : runs) {
+            GLState::get().bindTexture(GL_TEXTURE_2D, run.texture);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, x)));
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, u0)));
+            glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)(offset + offsetof(Instance, color)));
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, run.count);
+            offset += static_cast<GLintptr>(run.count) * sizeof(Instance);
+        }
+    }
+    instances.clear();
+    runs.clear();
+}
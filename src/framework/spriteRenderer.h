@@ -0,0 +1,75 @@
+#ifndef GRAPHICS_SPRITERENDERER_H
+#define GRAPHICS_SPRITERENDERER_H
+
+#include <cstdint>
+#include <vector>
+#include "shader.h"
+#include "streamBuffer.h"
+#include "glResources.h"
+#include "textureManager.h"
+
+using glm::vec2;
+
+/**
+ * @brief Draws batches of textured quads, one instanced draw call per texture.
+ * @details Sprites are queued with add() and drawn in that order by flush(). Each run of sprites from the
+ * same texture is one draw call, so sprites from one atlas page (see TextureManager) cost a single
+ * texture bind and a single draw however many there are. An instance is the quad's center and size, its
+ * corners in the texture and a packed tint (36 bytes); the corners come from gl_VertexID.
+ */
+class SpriteRenderer {
+public:
+    /**
+     * @brief Construct a new Sprite Renderer object
+     * @details The shader must be the instanced variant of the sprite shader (res/shaders/sprite.vert with
+     * INSTANCED), with its projection set and its "image" sampler on texture unit 0.
+     *
+     * @param shader The shader to use
+     * @param stream Buffer the instance data is streamed through
+     */
+    SpriteRenderer(Shader &shader, StreamBuffer &stream);
+
+    /**
+     * @brief Queues a sprite
+     *
+     * @param sprite The image to draw (sprites without a texture are skipped)
+     * @param center Center of the quad
+     * @param size Size of the quad
+     * @param color Packed RGBA8 tint the texture is multiplied by (see packColor())
+     */
+    void add(const Sprite &sprite, vec2 center, vec2 size, uint32_t color);
+
+    /// @brief Uploads and draws the queued sprites, then empties the queue
+    void flush();
+
+private:
+    /// @brief Layout of one instance in the instance buffer
+    struct Instance {
+        float x, y, width, height;
+        float u0, v0, u1, v1;
+        uint32_t color;
+    };
+
+    /// @brief Consecutive instances that use the same texture
+    struct Run {
+        unsigned int texture;
+        GLsizei count;
+    };
+
+    Shader &shader;
+    StreamBuffer &stream;
+
+    /// @brief The VAO (its instance attributes point into the stream buffer)
+    GLVertexArray VAO;
+
+    /// @brief The queue; cleared but never shrunk, so steady frames don't allocate
+    std::vector<Instance> instances;
+    std::vector<Run> runs;
+
+    /**
+     * @brief Initializes and configures the vertex attributes
+     */
+    void initRenderData();
+};
+
+#endif //GRAPHICS_SPRITERENDERER_H
@@ -0,0 +1,80 @@
+#include "streamBuffer.h"
+#include "glState.h"
+
+#include <cstring>
+
+StreamBuffer::StreamBuffer(size_t frameBytes) : buffer("StreamBuffer"), frameBytes(frameBytes) {
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(FRAMES * frameBytes), nullptr, GL_STREAM_DRAW);
+    buffer.setBytes(FRAMES * frameBytes);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync &fence : fences) {
+        if (fence) { glDeleteSync(fence); }
+    }
+}
+
+void StreamBuffer::beginFrame() {
+    frame = (frame + 1) % FRAMES;
+    head = frame * frameBytes;
+
+    // The region was last written FRAMES - 1 frames ago; with vsync the GPU is done with it by now
+    GLsync &fence = fences[frame];
+    if (fence) {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void StreamBuffer::endFrame() {
+    GLsync &fence = fences[frame];
+    if (fence) { glDeleteSync(fence); }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void *StreamBuffer::map(size_t bytes, size_t alignment, GLintptr &offset) {
+    size_t start = (head + alignment - 1) / alignment * alignment;
+    if (start + bytes > (frame + 1) * frameBytes) {
+        grow(2 * (start + bytes - frame * frameBytes));
+        start = (head + alignment - 1) / alignment * alignment;
+    }
+    head = start + bytes;
+    offset = static_cast<GLintptr>(start);
+
+    // Unsynchronized: the fences already guarantee that the GPU isn't reading this range
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, buffer);
+    return glMapBufferRange(GL_ARRAY_BUFFER, offset, static_cast<GLsizeiptr>(bytes),
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::unmap() {
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+GLintptr StreamBuffer::upload(const void *data, size_t bytes, size_t alignment) {
+    GLintptr offset;
+    void *target = map(bytes, alignment, offset);
+    if (!target) { return -1; }
+    memcpy(target, data, bytes);
+    unmap();
+    return offset;
+}
+
+void StreamBuffer::grow(size_t minFrameBytes) {
+    // Draws already issued keep the old storage alive, so nothing has to be waited for
+    while (frameBytes < minFrameBytes) {
+        frameBytes *= 2;
+    }
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(FRAMES * frameBytes), nullptr, GL_STREAM_DRAW);
+    buffer.setBytes(FRAMES * frameBytes);
+
+    for (GLsync &fence : fences) {
+        if (fence) { glDeleteSync(fence); }
+        fence = nullptr;
+    }
+    head = frame * frameBytes;
+}
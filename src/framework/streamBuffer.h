@@ -0,0 +1,69 @@
+#ifndef GRAPHICS_STREAMBUFFER_H
+#define GRAPHICS_STREAMBUFFER_H
+
+#include <cstddef>
+#include <glad/glad.h>
+#include "glResources.h"
+
+/**
+ * @brief A vertex buffer for data that is rewritten every frame.
+ * @details The buffer is split into one region per frame in flight. Each frame sub-allocates from
+ * its own region and maps just the allocated range with GL_MAP_UNSYNCHRONIZED_BIT, so the driver
+ * never has to wait for the GPU or shadow-copy the buffer. Instead, a fence placed at the end of
+ * each frame tells beginFrame() when a region is safe to write again (normally long before it comes
+ * around). Persistent mapping would avoid the map/unmap per allocation, but requires GL 4.4.
+ *
+ * If a frame needs more than a region holds, the buffer grows by orphaning its storage, which
+ * also makes every pending fence irrelevant.
+ */
+class StreamBuffer {
+public:
+    /// @brief Creates the buffer (requires a current OpenGL context)
+    /// @param frameBytes Initial size of each frame's region
+    explicit StreamBuffer(size_t frameBytes = 1 << 20);
+
+    /// @brief Deletes the buffer and any pending fences
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    /// @brief Moves on to the next region, waiting (rarely) until the GPU is done reading it
+    void beginFrame();
+
+    /// @brief Fences the current region so it isn't reused while the GPU still reads from it
+    void endFrame();
+
+    /// @brief Allocates and maps space for this frame's data; must be followed by unmap() before drawing
+    /// @param bytes Number of bytes to write
+    /// @param alignment Alignment of the allocation (e.g. the vertex size, so offset / size is a vertex index)
+    /// @param offset Receives the byte offset of the allocation within the buffer
+    /// @return Pointer to write to, or nullptr if the mapping failed
+    void *map(size_t bytes, size_t alignment, GLintptr &offset);
+
+    /// @brief Unmaps the last allocation (the buffer is left bound to GL_ARRAY_BUFFER)
+    void unmap();
+
+    /// @brief Copies data into a new allocation
+    /// @return The byte offset of the data within the buffer, or -1 if the mapping failed
+    GLintptr upload(const void *data, size_t bytes, size_t alignment);
+
+    /// @brief Returns the OpenGL buffer name (bind it to GL_ARRAY_BUFFER when setting attribute pointers)
+    GLuint getId() const { return buffer; }
+
+private:
+    static const int FRAMES = 3;
+
+    GLBuffer buffer;
+    size_t frameBytes;
+    GLsync fences[FRAMES] = {};
+    int frame = 0;
+
+    /// @brief Next free byte of the current region, relative to the start of the buffer
+    size_t head = 0;
+
+    /// @brief Reallocates the buffer with larger regions (orphaning the old storage)
+    void grow(size_t minFrameBytes);
+};
+
+#endif //GRAPHICS_STREAMBUFFER_H
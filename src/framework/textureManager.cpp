@@ -0,0 +1,223 @@
+#include "textureManager.h"
+#include "glState.h"
+#include "skylinePacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <glad/glad.h>
+
+namespace {
+/// @brief Mip levels an atlas can have before the padding between sprites is less than a texel
+int atlasMipLevels() {
+    int levels = 0;
+    for (int padding = TextureManager::ATLAS_PADDING; padding > 1; padding /= 2) { levels++; }
+    return levels;
+}
+
+int roundUp(int value, int multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+int nextPowerOfTwo(int value) {
+    int power = 1;
+    while (power < value) { power *= 2; }
+    return power;
+}
+
+/// @brief Hashes an image's size and pixels, 8 bytes at a time
+uint64_t hashImage(const Image &image) {
+    auto mix = [](uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    };
+    uint64_t hash = mix((static_cast<uint64_t>(image.width) << 32) | static_cast<uint32_t>(image.height));
+    const uint8_t *bytes = image.pixels.data();
+    const size_t size = image.pixels.size();
+    size_t ii = 0;
+    for (; ii + 8 <= size; ii += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + ii, 8);
+        hash = mix(hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    }
+    for (; ii < size; ii++) { hash = mix(hash ^ bytes[ii]); }
+    return hash;
+}
+
+/// @brief Copies an image into a page at (x, y), surrounded by padding copies of its edge pixels
+void blitPadded(std::vector<uint8_t> &page, int pageWidth, const Image &image, int x, int y, int padding) {
+    for (int row = -padding; row < image.height + padding; row++) {
+        const uint8_t *source = &image.pixels[static_cast<size_t>(std::clamp(row, 0, image.height - 1)) * image.width * 4];
+        uint8_t *target = &page[(static_cast<size_t>(y + row) * pageWidth + x) * 4];
+        for (int column = -padding; column < 0; column++) { memcpy(target + column * 4, source, 4); }
+        memcpy(target, source, static_cast<size_t>(image.width) * 4);
+        const uint8_t *last = source + (image.width - 1) * 4;
+        for (int column = image.width; column < image.width + padding; column++) { memcpy(target + column * 4, last, 4); }
+    }
+}
+}
+
+TextureManager::TextureManager(unsigned int threads) : pool(threads) { }
+
+SpriteHandle TextureManager::load(const std::string &path) {
+    auto known = byPath.find(path);
+    if (known != byPath.end()) { return known->second; }
+
+    auto handle = static_cast<SpriteHandle>(sprites.size());
+    sprites.emplace_back();
+    byPath[path] = handle;
+    requests.push_back(std::make_unique<Request>());
+    Request *request = requests.back().get();
+    request->handle = handle;
+    request->path = path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        decoding++;
+    }
+    pool.submit([this, request]() {
+        request->loaded = loadImage(request->image, request->path);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--decoding == 0) { decoded.notify_all(); }
+    });
+    return handle;
+}
+
+bool TextureManager::finishLoading() {
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        decoded.wait(lock, [this]() { return decoding == 0; });
+    }
+    stats = Stats{};
+    stats.images = requests.size();
+
+    // 1. images earlier in this batch under another name are shared; the hash only finds candidates, so a
+    // collision can't hand out the wrong image (earlier batches' pixels are gone, so they are not searched)
+    bool success = true;
+    std::multimap<uint64_t, const Request *> byContent;
+    std::vector<std::pair<Request *, SpriteHandle>> copies;
+    std::vector<Request *> atlased, large;
+    for (const auto &request : requests) {
+        if (!request->loaded || request->image.width <= 0 || request->image.height <= 0) {
+            success = false;
+            continue;
+        }
+        const Image &image = request->image;
+        uint64_t hash = hashImage(image);
+        auto [first, last] = byContent.equal_range(hash);
+        auto same = std::find_if(first, last, [&](const auto &entry) {
+            const Image &other = entry.second->image;
+            return other.width == image.width && other.height == image.height && other.pixels == image.pixels;
+        });
+        if (same != last) {
+            copies.emplace_back(request.get(), same->second->handle);
+            continue;
+        }
+        byContent.emplace(hash, request.get());
+        sprites[request->handle].width = image.width;
+        sprites[request->handle].height = image.height;
+        stats.unique++;
+        bool small = image.width <= MAX_ATLAS_SPRITE && image.height <= MAX_ATLAS_SPRITE;
+        (small ? atlased : large).push_back(request.get());
+    }
+
+    // 2. small images share atlas pages, big ones get a texture each
+    packAtlases(atlased);
+    for (Request *request : large) {
+        Sprite &sprite = sprites[request->handle];
+        sprite.texture = upload(request->image.pixels.data(), sprite.width, sprite.height, -1);
+        stats.ownTextures++;
+    }
+    for (const auto &[request, original] : copies) { sprites[request->handle] = sprites[original]; }
+
+    requests.clear();
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return success;
+}
+
+void TextureManager::packAtlases(const std::vector<Request *> &images) {
+    if (images.empty()) { return; }
+
+    // Tallest first leaves the fewest holes under the skyline
+    std::vector<Request *> order = images;
+    std::stable_sort(order.begin(), order.end(), [](const Request *a, const Request *b) {
+        return a->image.height > b->image.height;
+    });
+
+    // Each sprite's cell (image plus padding) starts and ends on a multiple of the padding, so down to the
+    // last mip level a texel never covers two cells
+    struct Placement {
+        Request *request;
+        int x, y;
+    };
+    std::vector<std::vector<Placement>> pages;
+    std::vector<SkylinePacker> packers;
+    size_t usedArea = 0;
+    for (Request *request : order) {
+        int cellWidth = roundUp(request->image.width + 2 * ATLAS_PADDING, ATLAS_PADDING);
+        int cellHeight = roundUp(request->image.height + 2 * ATLAS_PADDING, ATLAS_PADDING);
+        int x = 0, y = 0;
+        size_t page = 0;
+        while (page < packers.size() && !packers[page].pack(cellWidth, cellHeight, x, y)) { page++; }
+        if (page == packers.size()) {
+            packers.emplace_back(ATLAS_SIZE, ATLAS_SIZE);
+            pages.emplace_back();
+            packers.back().pack(cellWidth, cellHeight, x, y);
+        }
+        pages[page].push_back({request, x, y});
+        usedArea += static_cast<size_t>(cellWidth) * cellHeight;
+    }
+
+    const int levels = atlasMipLevels();
+    size_t pageArea = 0;
+    std::vector<uint8_t> pixels;
+    for (const std::vector<Placement> &page : pages) {
+        // Pages are trimmed to what they use
+        int width = 0, height = 0;
+        for (const Placement &placement : page) {
+            width = std::max(width, placement.x + placement.request->image.width + 2 * ATLAS_PADDING);
+            height = std::max(height, placement.y + placement.request->image.height + 2 * ATLAS_PADDING);
+        }
+        width = nextPowerOfTwo(width);
+        height = nextPowerOfTwo(height);
+        pageArea += static_cast<size_t>(width) * height;
+
+        pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+        for (const Placement &placement : page) {
+            const Image &image = placement.request->image;
+            const int x = placement.x + ATLAS_PADDING, y = placement.y + ATLAS_PADDING;
+            blitPadded(pixels, width, image, x, y, ATLAS_PADDING);
+            Sprite &sprite = sprites[placement.request->handle];
+            sprite.uv = glm::vec4(static_cast<float>(x) / width, static_cast<float>(y) / height,
+                                  static_cast<float>(x + image.width) / width,
+                                  static_cast<float>(y + image.height) / height);
+        }
+        unsigned int texture = upload(pixels.data(), width, height, levels);
+        for (const Placement &placement : page) { sprites[placement.request->handle].texture = texture; }
+    }
+    stats.pages = pages.size();
+    stats.occupancy = static_cast<float>(usedArea) / static_cast<float>(pageArea);
+}
+
+unsigned int TextureManager::upload(const uint8_t *pixels, int width, int height, int maxLevel) {
+    GLTexture &texture = textures.emplace_back("TextureManager");
+    GLState::get().activeTexture(GL_TEXTURE0);
+    GLState::get().bindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    if (maxLevel >= 0) { glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel); }
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    const size_t bytes = GLResources::textureBytes(width, height, 4, maxLevel);
+    texture.setBytes(bytes);
+    stats.textureBytes += bytes;
+    return texture.get();
+}
@@ -0,0 +1,121 @@
+#ifndef GRAPHICS_TEXTUREMANAGER_H
+#define GRAPHICS_TEXTUREMANAGER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "glResources.h"
+#include "image.h"
+#include "threadPool.h"
+
+/// @brief Where an image ended up on the GPU
+struct Sprite {
+    /// @brief The texture holding it: an atlas page shared with other sprites, or its own (0 until loaded)
+    unsigned int texture = 0;
+    /// @brief Its corners in the texture: (u0, v0) bottom left, (u1, v1) top right
+    glm::vec4 uv{0, 0, 1, 1};
+    int width = 0, height = 0;
+};
+
+/// @brief Index of a sprite in a TextureManager
+using SpriteHandle = uint32_t;
+
+/**
+ * @brief Loads images into textures, packing the small ones together into atlases.
+ * @details load() hands the file to a worker thread to read and decode (stb_image), so decoding overlaps
+ * with whatever the caller does until finishLoading(). That one then runs on the thread with the context:
+ * - Images of one batch with the same size and pixels share one sprite, whatever their paths (a 64-bit
+ *   hash finds candidates, the pixels are compared before sharing), and a path is only loaded once.
+ * - Images up to MAX_ATLAS_SPRITE on a side are packed, tallest first, into ATLAS_SIZE pages with a
+ *   SkylinePacker; a page is uploaded trimmed to the power-of-two size it uses. Bigger images get a
+ *   texture of their own.
+ * - Every texture gets mipmaps. In an atlas each sprite is surrounded by ATLAS_PADDING copies of its edge
+ *   pixels and starts on a multiple of ATLAS_PADDING, and the mip chain stops when the padding is one
+ *   texel wide, so a minified sprite never picks up its neighbours.
+ *
+ * Sprites drawn from the same page need no texture change in between (see SpriteRenderer).
+ */
+class TextureManager {
+public:
+    /// @brief Largest side of an image that goes into an atlas
+    static constexpr int MAX_ATLAS_SPRITE = 256;
+    /// @brief Side of an atlas page before trimming
+    static constexpr int ATLAS_SIZE = 2048;
+    /// @brief Edge pixels repeated around each sprite in an atlas (a power of two)
+    static constexpr int ATLAS_PADDING = 4;
+
+    /// @brief What the last finishLoading() did
+    struct Stats {
+        size_t images = 0;       // Loads, counting each path once
+        size_t unique = 0;       // Images with different pixels
+        size_t pages = 0;        // Atlas pages
+        size_t ownTextures = 0;  // Images too big for an atlas
+        size_t textureBytes = 0; // GPU memory of the new textures, mipmaps included
+        float occupancy = 0;     // Share of the atlas pages covered by sprites (padding included)
+        double milliseconds = 0; // Time spent waiting for the decoders, packing and uploading
+    };
+
+    /// @brief Starts the decoding threads
+    /// @param threads Number of decoding threads (0 picks one per hardware thread)
+    explicit TextureManager(unsigned int threads = 0);
+
+    /// @brief Deletes every texture (requires the context that created them)
+    ~TextureManager() = default;
+
+    TextureManager(const TextureManager &) = delete;
+    TextureManager &operator=(const TextureManager &) = delete;
+
+    /// @brief Starts decoding an image on a worker thread
+    /// @details The sprite is empty (no texture) until finishLoading(). Loading a path again returns the same handle.
+    /// @param path The image file (anything stb_image reads)
+    /// @return The sprite the image will end up in
+    SpriteHandle load(const std::string &path);
+
+    /// @brief Waits for the images loaded since the last call, then packs and uploads them (context thread only)
+    /// @return false if an image couldn't be read (its sprite stays empty; the error is printed)
+    bool finishLoading();
+
+    /// @brief Returns where a loaded image is (the reference is only good until the next load())
+    const Sprite &getSprite(SpriteHandle handle) const { return sprites[handle]; }
+
+    const Stats &getStats() const { return stats; }
+
+private:
+    /// @brief An image being decoded by a worker
+    struct Request {
+        SpriteHandle handle;
+        std::string path;
+        Image image;
+        bool loaded = false;
+    };
+
+    std::vector<Sprite> sprites;
+    std::map<std::string, SpriteHandle> byPath;
+    std::vector<GLTexture> textures;
+    Stats stats;
+
+    // Requests since the last finishLoading(); workers only touch their own request
+    std::vector<std::unique_ptr<Request>> requests;
+    std::mutex mutex;
+    std::condition_variable decoded;
+    size_t decoding = 0;
+
+    /// @brief Declared last so the workers stop before anything they write to is destroyed
+    ThreadPool pool;
+
+    /// @brief Packs images into as many atlas pages as they need and uploads the pages
+    void packAtlases(const std::vector<Request *> &images);
+
+    /// @brief Creates a texture with mipmaps up to maxLevel (-1 for the whole chain)
+    unsigned int upload(const uint8_t *pixels, int width, int height, int maxLevel);
+};
+
+#endif //GRAPHICS_TEXTUREMANAGER_H
@@ -0,0 +1,89 @@
+#include "threadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) { threads = 1; }
+    }
+    for (unsigned int ii = 0; ii < threads; ii++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+    if (count == 0) { return; }
+
+    // Every participant (workers and the caller) claims indices from a shared counter
+    // until they run out; the caller then waits for the helpers still running.
+    // The state is shared so a helper that only starts after the loop is done can still
+    // find the counter exhausted and leave without touching this stack frame.
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable allDone;
+    };
+    auto state = std::make_shared<State>();
+
+    auto run = [state, count, &task]() {
+        size_t finished = 0;
+        for (size_t ii = state->next++; ii < count; ii = state->next++) {
+            task(ii);
+            finished++;
+        }
+        if (finished > 0 && state->done.fetch_add(finished) + finished == count) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->allDone.notify_all();
+        }
+    };
+
+    size_t helpers = std::min<size_t>(workers.size(), count - 1);
+    for (size_t ii = 0; ii < helpers; ii++) {
+        submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->allDone.wait(lock, [&]() { return state->done.load() == count; });
+}
+
+unsigned int ThreadPool::size() const {
+    return static_cast<unsigned int>(workers.size());
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) { return; }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef GRAPHICS_THREADPOOL_H
+#define GRAPHICS_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads that run queued tasks.
+ * @details Workers are started once and reused, so splitting a frame's work across cores
+ * doesn't pay for thread creation every frame.
+ */
+class ThreadPool {
+public:
+    /// @brief Starts the workers
+    /// @param threads Number of workers (0 picks one per hardware thread)
+    explicit ThreadPool(unsigned int threads = 0);
+
+    /// @brief Finishes the queued tasks and joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief Queues a task to run on a worker
+    void submit(std::function<void()> task);
+
+    /// @brief Runs task(0) ... task(count - 1) across the workers and the calling thread
+    /// @details Blocks until every index has been processed.
+    void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    /// @brief Returns the number of worker threads
+    unsigned int size() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    /// @brief Loop run by every worker: pop a task, run it, repeat
+    void workerLoop();
+};
+
+#endif //GRAPHICS_THREADPOOL_H
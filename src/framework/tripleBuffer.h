@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_TRIPLEBUFFER_H
+#define GRAPHICS_TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @brief Lock-free single-producer/single-consumer handoff of whole values.
+ * @details The producer always owns one buffer and the consumer another; the third sits in the middle.
+ * publish() swaps the producer's buffer with the middle one and flags it as new; update() swaps the
+ * consumer's buffer with the middle one if it is new. Neither side ever waits, neither side can see
+ * a buffer the other is writing, and the consumer always gets the most recently published value.
+ *
+ * @tparam T The value type (buffers are reused, so containers inside T keep their capacity)
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    /// @brief The buffer the producer fills before calling publish()
+    /// @note It holds whatever was published two swaps ago, so overwrite every field.
+    T &writeBuffer() { return buffers[writeIndex]; }
+
+    /// @brief Hands the write buffer to the consumer (producer thread only)
+    void publish() {
+        unsigned int previous = middle.exchange(writeIndex | NEW_FLAG, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    /// @brief Picks up the latest published buffer if there is one (consumer thread only)
+    /// @return true if readBuffer() changed
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & NEW_FLAG)) { return false; }
+        unsigned int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    /// @brief The buffer the consumer reads (valid until its next update())
+    const T &readBuffer() const { return buffers[readIndex]; }
+
+private:
+    static constexpr unsigned int INDEX_MASK = 0x3;
+    static constexpr unsigned int NEW_FLAG = 0x4;
+
+    T buffers[3];
+    std::atomic<unsigned int> middle{1};
+    unsigned int writeIndex = 0; // Only touched by the producer
+    unsigned int readIndex = 2;  // Only touched by the consumer
+};
+
+#endif //GRAPHICS_TRIPLEBUFFER_H
@@ -0,0 +1,58 @@
+#include "agent.h"
+
+bool RandomAgent::choose(const Board &board, Move &move) {
+    move.x = static_cast<int>(random() % board.getWidth());
+    move.y = static_cast<int>(random() % board.getHeight());
+    return true;
+}
+
+bool GreedyAgent::choose(const Board &board, Move &move) {
+    // A press flips up to five lights: the change in lights on is (flipped) - 2 * (flipped that were on)
+    const int width = board.getWidth(), height = board.getHeight();
+    int best = 0, ties = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int flipped = 1, wereOn = board.isLit(x, y);
+            if (x > 0)          { flipped++; wereOn += board.isLit(x - 1, y); }
+            if (x < width - 1)  { flipped++; wereOn += board.isLit(x + 1, y); }
+            if (y > 0)          { flipped++; wereOn += board.isLit(x, y - 1); }
+            if (y < height - 1) { flipped++; wereOn += board.isLit(x, y + 1); }
+            int change = flipped - 2 * wereOn;
+
+            // Reservoir sampling keeps a uniformly random one of the best presses
+            if (ties == 0 || change < best) {
+                best = change;
+                ties = 1;
+                move = {x, y};
+            } else if (change == best && random() % ++ties == 0) {
+                move = {x, y};
+            }
+        }
+    }
+    return ties > 0;
+}
+
+void OptimalAgent::reset(const Board &board) {
+    plan.clear();
+    next = 0;
+    Board presses;
+    if (!solver.solve(board, presses)) { return; }
+    for (int y = 0; y < board.getHeight(); y++) {
+        for (int x = 0; x < board.getWidth(); x++) {
+            if (presses.isLit(x, y)) { plan.push_back({x, y}); }
+        }
+    }
+}
+
+bool OptimalAgent::choose(const Board &/*board*/, Move &move) {
+    if (next >= plan.size()) { return false; }
+    move = plan[next++];
+    return true;
+}
+
+std::unique_ptr<Agent> makeAgent(const std::string &name, uint32_t seed, const Solver &solver) {
+    if (name == "random")  { return std::make_unique<RandomAgent>(seed); }
+    if (name == "greedy")  { return std::make_unique<GreedyAgent>(seed); }
+    if (name == "optimal") { return std::make_unique<OptimalAgent>(solver); }
+    return nullptr;
+}
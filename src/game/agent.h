@@ -0,0 +1,86 @@
+#ifndef GRAPHICS_AGENT_H
+#define GRAPHICS_AGENT_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "solver.h"
+
+using std::vector;
+
+/// @brief A light to press
+struct Move {
+    int x = 0, y = 0;
+};
+
+/**
+ * @brief Something that plays Lights Out: it looks at the board and picks the next light to press.
+ * @details One agent plays one game at a time (reset() starts a new one); use an agent per thread.
+ */
+class Agent {
+public:
+    virtual ~Agent() = default;
+
+    /// @brief Name used in reports
+    virtual const char *getName() const = 0;
+
+    /// @brief Starts a new game on this board
+    virtual void reset(const Board &/*board*/) {}
+
+    /// @brief Picks the next light to press
+    /// @return false to give up
+    virtual bool choose(const Board &board, Move &move) = 0;
+};
+
+/// @brief Presses lights at random
+class RandomAgent : public Agent {
+public:
+    explicit RandomAgent(uint32_t seed) : random(seed) {}
+    const char *getName() const override { return "random"; }
+    bool choose(const Board &board, Move &move) override;
+
+private:
+    std::mt19937 random;
+};
+
+/// @brief Presses whichever light turns off the most lights right now (ties broken at random)
+/// @details Gets stuck in cycles on most boards; the harness's move limit ends those games.
+class GreedyAgent : public Agent {
+public:
+    explicit GreedyAgent(uint32_t seed) : random(seed) {}
+    const char *getName() const override { return "greedy"; }
+    bool choose(const Board &board, Move &move) override;
+
+private:
+    std::mt19937 random;
+};
+
+/// @brief Solves the board when the game starts, then plays the shortest solution
+class OptimalAgent : public Agent {
+public:
+    /// @param solver Solver for the size of the boards played (shared between threads; solving is const)
+    explicit OptimalAgent(const Solver &solver) : solver(solver) {}
+    const char *getName() const override { return "optimal"; }
+    void reset(const Board &board) override;
+    bool choose(const Board &board, Move &move) override;
+
+private:
+    const Solver &solver;
+    vector<Move> plan;
+    size_t next = 0;
+};
+
+/**
+ * @brief Creates an agent by name ("random", "greedy" or "optimal")
+ *
+ * @param name The agent's getName()
+ * @param seed Seed of the agent's random choices
+ * @param solver Solver for the board size (only used by the optimal agent)
+ * @return The agent, or nullptr for an unknown name
+ */
+std::unique_ptr<Agent> makeAgent(const std::string &name, uint32_t seed, const Solver &solver);
+
+#endif //GRAPHICS_AGENT_H
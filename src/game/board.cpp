@@ -0,0 +1,184 @@
+#include "board.h"
+
+#include <bitset>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// AVX2 kernels are compiled with a function-level target attribute and only used if the CPU supports them
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BOARD_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+/**
+ * XORs one row of presses into a row of lights: the row's own presses, the same shifted one column
+ * either way (carrying across words), and the presses of the rows above and below (either may be null).
+ * Bits past the last column are left for the caller to mask.
+ */
+typedef void (*SpreadKernel)(uint64_t *out, const uint64_t *above, const uint64_t *center, const uint64_t *below,
+                             size_t words);
+
+inline uint64_t spreadWord(const uint64_t *above, const uint64_t *center, const uint64_t *below, size_t w,
+                           size_t words) {
+    uint64_t c = center[w];
+    uint64_t left = c << 1 | (w > 0 ? center[w - 1] >> 63 : 0);          // Press at x lights x + 1
+    uint64_t right = c >> 1 | (w + 1 < words ? center[w + 1] << 63 : 0); // Press at x lights x - 1
+    uint64_t spread = c ^ left ^ right;
+    if (above) { spread ^= above[w]; }
+    if (below) { spread ^= below[w]; }
+    return spread;
+}
+
+void spreadRowScalar(uint64_t *out, const uint64_t *above, const uint64_t *center, const uint64_t *below,
+                     size_t words) {
+    for (size_t w = 0; w < words; w++) {
+        out[w] ^= spreadWord(above, center, below, w, words);
+    }
+}
+
+#ifdef BOARD_AVX2
+AVX2_TARGET void spreadRowAVX2(uint64_t *out, const uint64_t *above, const uint64_t *center, const uint64_t *below,
+                               size_t words) {
+    // The vector loop reads one word either side of its four, so the first and last words are done alone
+    if (words < 6) {
+        spreadRowScalar(out, above, center, below, words);
+        return;
+    }
+    out[0] ^= spreadWord(above, center, below, 0, words);
+    size_t w = 1;
+    for (; w + 4 < words; w += 4) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(center + w));
+        __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(center + w - 1));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(center + w + 1));
+        __m256i left = _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(previous, 63));
+        __m256i right = _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(next, 63));
+        __m256i spread = _mm256_xor_si256(c, _mm256_xor_si256(left, right));
+        if (above) { spread = _mm256_xor_si256(spread, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + w))); }
+        if (below) { spread = _mm256_xor_si256(spread, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + w))); }
+
+        auto *target = reinterpret_cast<__m256i *>(out + w);
+        _mm256_storeu_si256(target, _mm256_xor_si256(_mm256_loadu_si256(target), spread));
+    }
+    for (; w < words; w++) {
+        out[w] ^= spreadWord(above, center, below, w, words);
+    }
+}
+#endif
+
+/// @brief The kernel used by applyPresses(), picked once from the CPU's features
+struct Kernels {
+    SpreadKernel spreadRow = spreadRowScalar;
+    const char *name = "scalar";
+
+    Kernels() {
+#ifdef BOARD_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            spreadRow = spreadRowAVX2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+const Kernels &kernels() {
+    static const Kernels selected;
+    return selected;
+}
+
+} // namespace
+
+Board::Board(int width, int height) : width(width), height(height), stride((width + 63) / 64) {
+    words.resize(static_cast<size_t>(stride) * height);
+    fill(true);
+}
+
+void Board::press(int x, int y) {
+    toggle(x, y);
+    if (x > 0)          { toggle(x - 1, y); }
+    if (x < width - 1)  { toggle(x + 1, y); }
+    if (y > 0)          { toggle(x, y - 1); }
+    if (y < height - 1) { toggle(x, y + 1); }
+}
+
+void Board::toggle(int x, int y) {
+    row(y)[x >> 6] ^= uint64_t(1) << (x & 63);
+}
+
+void Board::applyPresses(const Board &presses) {
+    // Each output row only reads the presses, so a board can't be its own presses
+    if (&presses == this) {
+        Board copy = presses;
+        applyPresses(copy);
+        return;
+    }
+    const SpreadKernel spreadRow = kernels().spreadRow;
+    for (int y = 0; y < height; y++) {
+        spreadRow(row(y), y > 0 ? presses.row(y - 1) : nullptr, presses.row(y),
+                  y < height - 1 ? presses.row(y + 1) : nullptr, stride);
+        // Only the last word can spill past the last column
+        row(y)[stride - 1] &= wordMask(stride - 1);
+    }
+}
+
+bool Board::allOff() const {
+    for (uint64_t word : words) {
+        if (word) { return false; }
+    }
+    return true;
+}
+
+size_t Board::litCount() const {
+    size_t count = 0;
+    for (uint64_t word : words) {
+        count += std::bitset<64>(word).count();
+    }
+    return count;
+}
+
+bool Board::isLit(int x, int y) const {
+    return (row(y)[x >> 6] >> (x & 63)) & 1;
+}
+
+uint64_t Board::wordMask(int w) const {
+    int bits = width - w * 64;
+    return bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+}
+
+void Board::setLit(int x, int y, bool lit) {
+    uint64_t bit = uint64_t(1) << (x & 63);
+    if (lit) { row(y)[x >> 6] |= bit; }
+    else { row(y)[x >> 6] &= ~bit; }
+}
+
+void Board::fill(bool lit) {
+    for (int y = 0; y < height; y++) {
+        for (int w = 0; w < stride; w++) {
+            row(y)[w] = lit ? wordMask(w) : 0;
+        }
+    }
+}
+
+void Board::scramble(uint32_t seed) {
+    // 64 random presses per word, applied in one pass
+    std::mt19937_64 random(seed);
+    Board presses(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int w = 0; w < stride; w++) {
+            presses.row(y)[w] = random() & wordMask(w);
+        }
+    }
+    applyPresses(presses);
+}
+
+bool Board::operator==(const Board &other) const {
+    return width == other.width && height == other.height && words == other.words;
+}
+
+const char *boardKernelName() {
+    return kernels().name;
+}
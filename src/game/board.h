@@ -0,0 +1,90 @@
+#ifndef GRAPHICS_BOARD_H
+#define GRAPHICS_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The state of a Lights Out board.
+ * @details Each light is one bit. Rows are stored as whole 64-bit words (bit x of a row is column x),
+ * and bits past the last column are always zero, so whole-row operations don't need masking.
+ */
+class Board {
+public:
+    /// @brief Construct a new Board with every light on
+    /// @param width Number of columns
+    /// @param height Number of rows
+    Board(int width = 5, int height = 5);
+
+    // --------------------------------------------------------
+    // Game rules
+    // --------------------------------------------------------
+
+    /// @brief Toggles the light at (x, y) and the (up to) four lights it borders
+    void press(int x, int y);
+
+    /// @brief Toggles a single light
+    void toggle(int x, int y);
+
+    /**
+     * @brief Presses every lit light of another board at once
+     * @details Same as calling press() for each lit light of presses, but a whole word at a time: each row
+     * is XORed with its presses, the presses shifted left and right by one column, and the presses of the
+     * rows above and below (with AVX2 when the CPU has it, four words per step).
+     *
+     * @param presses The lights to press (same size as this board)
+     */
+    void applyPresses(const Board &presses);
+
+    /// @brief Returns true if every light is off (the game is won)
+    bool allOff() const;
+
+    /// @brief Returns the number of lights that are on
+    size_t litCount() const;
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+    int getWidth() const  { return width; }
+    int getHeight() const { return height; }
+    int getCellCount() const { return width * height; }
+    bool isLit(int x, int y) const;
+
+    /// @brief Number of 64-bit words used by each row
+    int getStride() const { return stride; }
+
+    /// @brief Pointer to the words of row y
+    uint64_t *row(int y)             { return &words[static_cast<size_t>(y) * stride]; }
+    const uint64_t *row(int y) const { return &words[static_cast<size_t>(y) * stride]; }
+
+    /// @brief Mask of the bits that are inside the board for word w of a row
+    uint64_t wordMask(int w) const;
+
+    // --------------------------------------------------------
+    // Setters
+    // --------------------------------------------------------
+    void setLit(int x, int y, bool lit);
+
+    /// @brief Turns every light on or off
+    void fill(bool lit);
+
+    /// @brief Presses each light with probability 1/2 (from all off, this gives a random solvable board)
+    /// @param seed Same seed, same presses
+    void scramble(uint32_t seed);
+
+    bool operator==(const Board &other) const;
+    bool operator!=(const Board &other) const { return !(*this == other); }
+
+private:
+    int width, height;
+    int stride;
+    vector<uint64_t> words;
+};
+
+/// @brief Name of the kernel applyPresses() picked for this CPU ("scalar" or "avx2")
+const char *boardKernelName();
+
+#endif //GRAPHICS_BOARD_H
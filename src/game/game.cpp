@@ -0,0 +1,370 @@
+#include "game.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+BoardLayout BoardLayout::fit(int width, int height, vec2 corner, float extent) {
+    // Same proportions as the original 5x5 layout: 140 px lights, 155 px outlines, 160 px apart
+    BoardLayout layout;
+    layout.pitch = extent / static_cast<float>(std::max(width, height));
+    layout.cellSize = layout.pitch * 0.875f;
+    layout.outlineSize = layout.pitch * 0.96875f;
+    layout.origin = corner + vec2(layout.pitch / 2, layout.pitch / 2);
+    return layout;
+}
+
+int BoardLayout::cellAt(vec2 pos, vec2 size, int width, int height) const {
+    int x = static_cast<int>(std::floor((pos.x - origin.x) / pitch + 0.5f));
+    int y = static_cast<int>(std::floor((pos.y - origin.y) / pitch + 0.5f));
+    if (x < 0 || y < 0 || x >= width || y >= height) { return -1; }
+
+    // Same test as the hitboxes: the box has to touch the light itself, not the gap around it
+    vec2 offset = pos - cellCenter(x, y);
+    float reachX = (cellSize + size.x) / 2, reachY = (cellSize + size.y) / 2;
+    if (std::abs(offset.x) > reachX || std::abs(offset.y) > reachY) { return -1; }
+    return y * width + x;
+}
+
+CellRange BoardLayout::cellsIn(vec2 min, vec2 max, int width, int height) const {
+    // A light at column x covers [center - cellSize / 2, center + cellSize / 2]
+    auto first = [&](float edge, float start) {
+        return static_cast<int>(std::ceil((edge - start - cellSize / 2) / pitch));
+    };
+    auto last = [&](float edge, float start) {
+        return static_cast<int>(std::floor((edge - start + cellSize / 2) / pitch)) + 1;
+    };
+    CellRange range;
+    range.x0 = std::clamp(first(min.x, origin.x), 0, width);
+    range.y0 = std::clamp(first(min.y, origin.y), 0, height);
+    range.x1 = std::clamp(last(max.x, origin.x), 0, width);
+    range.y1 = std::clamp(last(max.y, origin.y), 0, height);
+    return range;
+}
+
+Game::Game(vec2 screenSize, int boardWidth, int boardHeight, int states)
+    : screenSize(screenSize), layout(BoardLayout::fit(boardWidth, boardHeight, vec2(80, 80), 800)),
+      board(boardWidth, boardHeight), states(std::max(states, 2)),
+      cells(this->states > 2 ? boardWidth : 0, this->states > 2 ? boardHeight : 0, this->states),
+      camera(screenSize) {
+    // "All on" is often unsolvable with more states; random presses from all off always have a solution
+    // (a fixed seed keeps recordings and golden images reproducible)
+    if (this->states > 2) {
+        for (uint32_t seed = 1; cells.allOff(); seed++) { cells.scramble(seed); }
+        syncAllLights();
+        cellHistory.reset(cells);
+    } else {
+        history.reset(board);
+    }
+    rowGenerations.assign(boardHeight, 0);
+    touchAll();
+
+    // Zoom out to half the board, and in until a light is about 400 pixels wide
+    camera.setZoomLimits(0.5f, std::max(4.0f, 400.0f / layout.pitch));
+
+    // Hitboxes are created in board order so a handle is also the light's board index.
+    // Huge boards use BoardLayout::cellAt instead: a shape per light would take gigabytes.
+    if (!isHugeBoard(board)) {
+        lightBoxes.reserve(board.getCellCount());
+        for (int y = 0; y < board.getHeight(); y++) {
+            for (int x = 0; x < board.getWidth(); x++) {
+                lightBoxes.create(layout.cellCenter(x, y), vec2(layout.cellSize, layout.cellSize), YELLOW);
+            }
+        }
+    }
+
+    // Particles bounce around the whole window; collisions are resolved on every core
+    particles = std::make_unique<ParticleSystem>(screenSize, std::thread::hardware_concurrency());
+}
+
+void Game::processInput(const InputState &input) {
+    if (input.keyQuit) { quit = true; }
+
+    // Mouse position saved to check for collisions (in world units, so it lines up with the lights at any zoom)
+    if (screen == Screen::play || screen == Screen::over) {
+        moveCamera(input);
+    }
+    lastMouse = input.mouse;
+    cursor = camera.screenToWorld(input.mouse);
+
+    // History keys act once per press; remembered on every screen so a key held while starting doesn't fire
+    bool undoKey = input.keyUndo && !undoKeyLastStep, redoKey = input.keyRedo && !redoKeyLastStep;
+    bool branchKey = input.keyBranch && !branchKeyLastStep;
+    undoKeyLastStep = input.keyUndo;
+    redoKeyLastStep = input.keyRedo;
+    branchKeyLastStep = input.keyBranch;
+    bool levelsKey = input.keyLevels && !levelsKeyLastStep, randomKey = input.keyRandomLevel && !randomKeyLastStep;
+    levelsKeyLastStep = input.keyLevels;
+    randomKeyLastStep = input.keyRandomLevel;
+    // Arrows step through the levels once per press: left/right by one, down/up by a hundred
+    int64_t levelStep = (input.panKeys.x != panKeysLastStep.x ? static_cast<int64_t>(input.panKeys.x) : 0)
+                        + (input.panKeys.y != panKeysLastStep.y ? static_cast<int64_t>(input.panKeys.y) * 100 : 0);
+    panKeysLastStep = input.panKeys;
+
+    switch (screen) {
+        case Screen::start: {
+            if (input.keyStart) { screen = Screen::play; }
+            else if (input.keyInstructions) { screen = Screen::instructions; }
+            else if (levelsKey && pack.isOpen()) { screen = Screen::levels; }
+            break;
+        }
+        case Screen::levels: {
+            if (input.keyStart) { startLevel(level); }
+            else if (randomKey) { browseLevel(static_cast<int64_t>(levelRandom() % pack.getCount())); }
+            else if (levelStep != 0) { browseLevel(levelStep); }
+            break;
+        }
+        case Screen::instructions: {
+            if (input.keyStart) { screen = Screen::play; }
+            break;
+        }
+        case Screen::play: {
+            // Find the light under the cursor (a point), and press it when the mouse button goes down over it
+            const vec2 cursorSize(0, 0);
+            if (isHugeBoard(board)) {
+                hoverIndex = layout.cellAt(cursor, cursorSize, board.getWidth(), board.getHeight());
+            } else {
+                hoverIndex = lightBoxes.findOverlapping(cursor, cursorSize, 0,
+                                                        static_cast<ShapeHandle>(lightBoxes.size()));
+            }
+            if (hoverIndex >= 0 && input.mouseLeft && !mousePressedLastStep) {
+                press(hoverIndex % board.getWidth(), hoverIndex / board.getWidth());
+            }
+            // Save the status of the mouse press
+            mousePressedLastStep = input.mouseLeft;
+
+            if (undoKey) { undo(); }
+            if (redoKey) { redo(); }
+            if (branchKey) { nextBranch(); }
+            break;
+        }
+        case Screen::over: {
+            // On to the next level of the pack
+            if (levelsKey && pack.isOpen()) {
+                particles->clear();
+                screen = Screen::levels;
+                browseLevel(1);
+            }
+            break;
+        }
+    }
+}
+
+bool Game::openPack(const std::string &path) {
+    if (!pack.open(path)) { return false; }
+    if (pack.getWidth() != board.getWidth() || pack.getHeight() != board.getHeight() || states != 2
+        || pack.getCount() == 0) {
+        std::cout << "ERROR::GAME: The puzzles of " << path << " don't fit a " << board.getWidth() << "x"
+                  << board.getHeight() << " board with two states" << std::endl;
+        pack.close();
+        return false;
+    }
+    level = 0;
+    browseLevel(0);
+    history.reset(board);
+    return true;
+}
+
+void Game::browseLevel(int64_t offset) {
+    const int64_t count = static_cast<int64_t>(pack.getCount());
+    level = static_cast<size_t>(((static_cast<int64_t>(level) + offset) % count + count) % count);
+    board = pack.get(level);
+    touchAll();
+    hoverIndex = -1;
+}
+
+void Game::startLevel(size_t index) {
+    if (!pack.isOpen()) { return; }
+    level = index % pack.getCount();
+    board = pack.get(level);
+    touchAll();
+    history.reset(board);
+    moveCount = 0;
+    elapsedSeconds = 0;
+    hoverIndex = -1;
+    mousePressedLastStep = false;
+    screen = Screen::play;
+}
+
+void Game::press(int x, int y) {
+    const uint32_t cell = static_cast<uint32_t>(y) * board.getWidth() + x;
+    touchRows(y - 1, y + 1);
+    if (states == 2) {
+        board.press(x, y);
+        history.record(board, cell);
+        moveCount = static_cast<int>(history.getDepth());
+        return;
+    }
+    cells.press(x, y);
+    syncLights(x, y);
+    cellHistory.record(cells, cell);
+    moveCount = static_cast<int>(cellHistory.getDepth());
+}
+
+void Game::undo() {
+    uint32_t cell;
+    if (states == 2) {
+        if (!history.undo(board, &cell)) { return; }
+        moveCount = static_cast<int>(history.getDepth());
+    } else if (cellHistory.undo(cells, &cell)) {
+        syncLights(cell % board.getWidth(), cell / board.getWidth());
+        moveCount = static_cast<int>(cellHistory.getDepth());
+    } else {
+        return;
+    }
+    const int y = static_cast<int>(cell / board.getWidth());
+    touchRows(y - 1, y + 1);
+}
+
+void Game::redo() {
+    uint32_t cell;
+    if (states == 2) {
+        if (!history.redo(board, &cell)) { return; }
+        moveCount = static_cast<int>(history.getDepth());
+    } else if (cellHistory.redo(cells, &cell)) {
+        syncLights(cell % board.getWidth(), cell / board.getWidth());
+        moveCount = static_cast<int>(cellHistory.getDepth());
+    } else {
+        return;
+    }
+    const int y = static_cast<int>(cell / board.getWidth());
+    touchRows(y - 1, y + 1);
+}
+
+void Game::nextBranch() {
+    if (states == 2) {
+        history.selectBranch((history.getBranch() + 1) % history.getBranchCount(), board);
+        moveCount = static_cast<int>(history.getDepth());
+    } else {
+        cellHistory.selectBranch((cellHistory.getBranch() + 1) % cellHistory.getBranchCount(), cells);
+        syncAllLights();
+        moveCount = static_cast<int>(cellHistory.getDepth());
+    }
+    touchAll();
+}
+
+void Game::touchRows(int first, int last) {
+    generation++;
+    first = std::max(first, 0);
+    last = std::min(last, board.getHeight() - 1);
+    for (int y = first; y <= last; y++) { rowGenerations[y] = generation; }
+}
+
+void Game::touchAll() {
+    touchRows(0, board.getHeight() - 1);
+}
+
+void Game::syncLights(int x, int y) {
+    auto sync = [this](int x, int y) { board.setLit(x, y, cells.get(x, y) != 0); };
+    sync(x, y);
+    if (x > 0)                     { sync(x - 1, y); }
+    if (x < board.getWidth() - 1)  { sync(x + 1, y); }
+    if (y > 0)                     { sync(x, y - 1); }
+    if (y < board.getHeight() - 1) { sync(x, y + 1); }
+}
+
+void Game::syncAllLights() {
+    for (int y = 0; y < board.getHeight(); y++) {
+        for (int x = 0; x < board.getWidth(); x++) { board.setLit(x, y, cells.get(x, y) != 0); }
+    }
+}
+
+bool Game::saveHistory(const std::string &path) const {
+    return states == 2 ? history.save(path) : cellHistory.save(path);
+}
+
+bool Game::loadHistory(const std::string &path) {
+    if (states == 2) {
+        if (!history.load(path, board)) { return false; }
+        moveCount = static_cast<int>(history.getDepth());
+    } else {
+        if (!cellHistory.load(path, cells)) { return false; }
+        syncAllLights();
+        moveCount = static_cast<int>(cellHistory.getDepth());
+    }
+    touchAll();
+    return true;
+}
+
+void Game::moveCamera(const InputState &input) {
+    const float PAN_SPEED = 8;      // Pixels per step
+    const float ZOOM_STEP = 1.02f;  // Per step while [=] or [-] is held
+    const float WHEEL_STEP = 1.1f;  // Per wheel click
+
+    if (input.keyResetView) {
+        camera.reset();
+        return;
+    }
+    if (input.mouseRight) {
+        camera.pan(input.mouse - lastMouse);
+    }
+    camera.pan(-input.panKeys * PAN_SPEED);
+    if (input.scroll != 0) {
+        camera.zoomAt(input.mouse, std::pow(WHEEL_STEP, input.scroll));
+    }
+    if (input.zoomKeys != 0) {
+        camera.zoomAt(screenSize * 0.5f, std::pow(ZOOM_STEP, input.zoomKeys));
+    }
+}
+
+void Game::update(float deltaTime) {
+    tick++;
+
+    // If we're playing and all the lights are off, change screen to over (end the game)
+    if (screen == Screen::play) {
+        elapsedSeconds += deltaTime;
+        if (board.allOff()) {
+            hoverIndex = -1;
+            screen = Screen::over;
+
+            // Celebrate with a few bursts spread across the window
+            const int bursts = 5;
+            for (int ii = 0; ii < bursts; ii++) {
+                particles->burst(vec2(screenSize.x * (ii + 1) / (bursts + 1), screenSize.y / 2),
+                                 PARTICLE_COUNT / bursts, 100, 700, 2.0f, {YELLOW, RED, WHITE});
+            }
+        }
+    }
+
+    // Keep the step bounded so a stalled frame doesn't tunnel particles through each other
+    if (screen == Screen::over) {
+        particles->update(std::min(deltaTime, 1.0f / 30.0f));
+    }
+}
+
+void Game::writeSnapshot(GameSnapshot &snapshot) const {
+    snapshot.tick = tick;
+    snapshot.screen = screen;
+    if (snapshot.generation == 0 || snapshot.states != states || snapshot.board.getWidth() != board.getWidth() ||
+        snapshot.board.getHeight() != board.getHeight()) {
+        // Copy-assignment reuses the snapshot's existing storage, so this only allocates for a new board size
+        snapshot.board = board;
+        snapshot.states = states;
+        if (states > 2) { snapshot.cells = cells; }
+        snapshot.rowGenerations = rowGenerations;
+    } else if (snapshot.generation != generation) {
+        // The snapshot already holds the board as it was at its generation: only newer rows are copied
+        // (a press touches three, so a huge board isn't copied whole every step)
+        const size_t rowBytes = board.getStride() * sizeof(uint64_t);
+        for (int y = 0; y < board.getHeight(); y++) {
+            if (rowGenerations[y] <= snapshot.generation) { continue; }
+            memcpy(snapshot.board.row(y), board.row(y), rowBytes);
+            if (states > 2) { memcpy(snapshot.cells.row(y), cells.row(y), cells.getStride()); }
+            snapshot.rowGenerations[y] = rowGenerations[y];
+        }
+    }
+    snapshot.generation = generation;
+    snapshot.hoverIndex = hoverIndex;
+    snapshot.moveCount = moveCount;
+    snapshot.elapsedSeconds = elapsedSeconds;
+    snapshot.level = level;
+    snapshot.levelCount = pack.getCount();
+    snapshot.par = pack.isOpen() ? pack.getPar(level) : -1;
+    snapshot.cursor = cursor;
+    snapshot.camera = camera;
+    snapshot.particlePositions = particles->getPositions();
+    snapshot.particleRadii = particles->getRadii();
+    snapshot.particleColors = particles->getColors();
+}
@@ -0,0 +1,203 @@
+#ifndef GRAPHICS_GAME_H
+#define GRAPHICS_GAME_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include "board.h"
+#include "modBoard.h"
+#include "moveHistory.h"
+#include "puzzlePack.h"
+#include "gameSnapshot.h"
+#include "../shapes/shapeStore.h"
+#include "../physics/particleSystem.h"
+#include "../framework/camera.h"
+
+using std::unique_ptr;
+
+/// @brief The input the game reacts to, sampled once per simulation step
+struct InputState {
+    /// @brief Cursor position in window coordinates (origin at the bottom left)
+    vec2 mouse{0, 0};
+    bool mouseLeft = false;
+    bool keyStart = false;        // [s]
+    bool keyInstructions = false; // [i]
+    bool keyQuit = false;         // [Esc]
+
+    // Camera controls
+    bool mouseRight = false;      // Drag to pan
+    float scroll = 0;             // Wheel clicks since the last step (positive zooms in)
+    vec2 panKeys{0, 0};           // Arrow keys, -1..1 per axis
+    float zoomKeys = 0;           // [=] / [-], -1..1
+    bool keyResetView = false;    // [0]
+
+    // Move history (acted on when pressed, not while held)
+    bool keyUndo = false;         // [z]
+    bool keyRedo = false;         // [y]
+    bool keyBranch = false;       // [b] Next branch
+
+    // Level select (with a puzzle pack); the arrows browse, acted on when pressed
+    bool keyLevels = false;       // [l]
+    bool keyRandomLevel = false;  // [r]
+};
+
+/// @brief A rectangle of lights: columns [x0, x1) of rows [y0, y1)
+struct CellRange {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+};
+
+/// @brief Where the lights are drawn on screen
+struct BoardLayout {
+    vec2 origin{160, 160};    // Center of light (0, 0)
+    float pitch = 160;        // Distance between the centers of neighboring lights
+    float cellSize = 140;     // Size of a light
+    float outlineSize = 155;  // Size of the hover outline
+
+    vec2 cellCenter(int x, int y) const { return origin + vec2(x * pitch, y * pitch); }
+
+    /// @brief Scales the lights so a board fits into a square area (a 5x5 board gets the default layout)
+    /// @param width Number of columns
+    /// @param height Number of rows
+    /// @param corner Bottom left corner of the area
+    /// @param extent Width and height of the area
+    static BoardLayout fit(int width, int height, vec2 corner, float extent);
+
+    /// @brief Returns the index (y * width + x) of the light overlapped by a box, or -1
+    /// @details Lights are on a regular grid, so this is arithmetic instead of a search (picks the light under the box's center).
+    int cellAt(vec2 pos, vec2 size, int width, int height) const;
+
+    /// @brief Returns the lights that overlap a world-space rectangle (e.g. the camera's view)
+    CellRange cellsIn(vec2 min, vec2 max, int width, int height) const;
+};
+
+/// @brief Boards with more lights than this skip per-light shapes and hitboxes (see BoardRenderer)
+const int HUGE_BOARD_CELLS = 64 * 64;
+
+inline bool isHugeBoard(const Board &board) { return board.getCellCount() > HUGE_BOARD_CELLS; }
+
+/**
+ * @brief The game rules and state, independent of any window or OpenGL context.
+ * @details The Engine feeds it input and fixed time steps on the simulation thread,
+ * and copies its state into snapshots for the render thread.
+ */
+class Game {
+public:
+    /// @brief Construct a new Game
+    /// @param screenSize Size of the window (bounds of the win screen particles)
+    /// @param boardWidth Number of columns of lights
+    /// @param boardHeight Number of rows of lights
+    /// @param states Number of states each light cycles through (2 is the classic game; more start scrambled)
+    Game(vec2 screenSize, int boardWidth = 5, int boardHeight = 5, int states = 2);
+
+    /// @brief Reacts to the input of this step (screen changes, presses, hover)
+    void processInput(const InputState &input);
+
+    /// @brief Advances timers, win detection and particles
+    /// @param deltaTime Length of the step (seconds)
+    void update(float deltaTime);
+
+    /// @brief Copies the state the renderer needs into a snapshot
+    void writeSnapshot(GameSnapshot &snapshot) const;
+
+    /// @brief Saves the move history (every branch and the current position)
+    bool saveHistory(const std::string &path) const;
+
+    /// @brief Replaces the move history with a saved one and goes to its position
+    /// @return false if the file can't be read or was saved for a different puzzle (start board)
+    bool loadHistory(const std::string &path);
+
+    /**
+     * @brief Opens a puzzle pack for the level select screen and shows its first level
+     * @details Only the header is read; each level is decoded from the (memory-mapped) file when it is shown.
+     * @return false if the file isn't a valid pack or its puzzles aren't the size of this board
+     */
+    bool openPack(const std::string &path);
+
+    /// @brief Starts playing a level of the open pack (from no moves and no time)
+    void startLevel(size_t index);
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+    Screen getScreen() const              { return screen; }
+    const Board &getBoard() const         { return board; }
+    int getStates() const                 { return states; }
+    const ModBoard &getCells() const      { return cells; }
+    const BoardLayout &getLayout() const  { return layout; }
+    const Camera &getCamera() const       { return camera; }
+    int getMoveCount() const              { return moveCount; }
+    bool shouldQuit() const               { return quit; }
+
+private:
+    vec2 screenSize;
+    BoardLayout layout;
+    /// @brief Which lights are on; with more than two states, kept in step with cells
+    Board board;
+    int states;
+    /// @brief State of each light when there are more than two (empty otherwise)
+    ModBoard cells;
+
+    /// @brief Hitboxes of the lights, in board order (y * width + x); empty for huge boards
+    ShapeStore lightBoxes;
+
+    Camera camera;
+    vec2 lastMouse{0, 0};
+
+    /// @brief Pans and zooms the camera
+    void moveCamera(const InputState &input);
+
+    /// @brief Presses a light (on cells too if there are more than two states) and records the move
+    void press(int x, int y);
+
+    /// @brief Moves through the history: undo, redo, or the next branch (wrapping around)
+    void undo();
+    void redo();
+    void nextBranch();
+
+    /// @brief Updates the lit mask at (x, y) and its neighbors from cells
+    void syncLights(int x, int y);
+    /// @brief Same for every light
+    void syncAllLights();
+
+    /// @brief Counts changes to the board: each one gets a new generation, stored for the rows it touched,
+    /// so writeSnapshot() copies only the rows that changed since a snapshot's generation
+    uint64_t generation = 0;
+    vector<uint64_t> rowGenerations;
+    /// @brief Marks rows [first, last] (clamped to the board) as changed
+    void touchRows(int first, int last);
+    /// @brief Marks every row as changed
+    void touchAll();
+
+    /// @brief Moves played so far; history (two states) or cellHistory (more) is used, not both
+    MoveHistory<Board> history{Board(0, 0)};
+    MoveHistory<ModBoard> cellHistory{ModBoard(0, 0)};
+    bool undoKeyLastStep = false, redoKeyLastStep = false, branchKeyLastStep = false;
+
+    /// @brief Levels for the level select screen (closed if none were given)
+    PuzzlePack pack;
+    size_t level = 0;
+    std::mt19937_64 levelRandom{1};
+    bool levelsKeyLastStep = false, randomKeyLastStep = false;
+    vec2 panKeysLastStep{0, 0};
+
+    /// @brief Shows a level on the level select screen (wrapping around the pack)
+    void browseLevel(int64_t offset);
+
+    Screen screen = Screen::start;
+    int hoverIndex = -1;
+    int moveCount = 0;
+    double elapsedSeconds = 0;
+    uint64_t tick = 0;
+    /// @brief Cursor position in world units
+    vec2 cursor{0, 0};
+    bool mousePressedLastStep = false;
+    bool quit = false;
+
+    /// @brief Celebration particles shown on the "Winner!" screen
+    unique_ptr<ParticleSystem> particles;
+    const int PARTICLE_COUNT = 50000;
+};
+
+#endif //GRAPHICS_GAME_H
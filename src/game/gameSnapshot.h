@@ -0,0 +1,61 @@
+#ifndef GRAPHICS_GAMESNAPSHOT_H
+#define GRAPHICS_GAMESNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+#include "board.h"
+#include "modBoard.h"
+#include "../framework/camera.h"
+
+using std::vector, glm::vec2;
+
+/// @brief The screens of the game
+enum class Screen { start, instructions, levels, play, over };
+
+/**
+ * @brief Everything the renderer needs to draw one frame.
+ * @details Written by the simulation thread and handed to the render thread through a TripleBuffer,
+ * so the renderer never reads state that is being modified.
+ */
+struct GameSnapshot {
+    /// @brief Number of simulation steps taken when the snapshot was written
+    uint64_t tick = 0;
+
+    Screen screen = Screen::start;
+    /// @brief Which lights are on (not at state 0)
+    Board board;
+    /// @brief Number of states of the lights, and for more than two, the state of each light
+    int states = 2;
+    ModBoard cells{0, 0};
+    /// @brief Generation of the board (0 before the first write), and of each row: when the row last changed
+    /// @details Game::writeSnapshot() copies only rows newer than the snapshot, and BoardRenderer uploads only
+    /// rows whose generation differs from the one in its texture.
+    uint64_t generation = 0;
+    vector<uint64_t> rowGenerations;
+
+    /// @brief Index (y * width + x) of the light under the cursor, or -1
+    int hoverIndex = -1;
+    int moveCount = 0;
+    /// @brief Seconds spent on the play screen
+    double elapsedSeconds = 0;
+    /// @brief Puzzle pack: the level being browsed or played, the number of levels (0 without a pack),
+    /// and the level's par (-1 if the pack has none)
+    size_t level = 0, levelCount = 0;
+    int par = -1;
+    /// @brief Cursor position in world units
+    vec2 cursor{0, 0};
+    Camera camera;
+
+    /// @brief Latency instrumentation, filled in by the engine: the newest input event (click or key press)
+    /// this snapshot reflects, numbered so the renderer can tell when a new one first reaches the screen
+    uint32_t inputSerial = 0;
+    double inputTime = 0;
+
+    // Win screen particles
+    vector<vec2> particlePositions;
+    vector<float> particleRadii;
+    vector<uint32_t> particleColors;
+};
+
+#endif //GRAPHICS_GAMESNAPSHOT_H
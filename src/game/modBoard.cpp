@@ -0,0 +1,203 @@
+#include "modBoard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MODBOARD_SSE2 1
+#include <immintrin.h>
+#endif
+
+// AVX2 kernels are compiled with a function-level target attribute and only used if the CPU supports them
+#if defined(MODBOARD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define MODBOARD_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+/**
+ * Adds a row of presses to three rows of lights, modulo k:
+ *   row[x]   += a[x - 1] + a[x] + a[x + 1]
+ *   above[x] += a[x], below[x] += a[x]   (either may be null)
+ * a[-1] and a[count] must be readable (and zero). count is a multiple of 32.
+ */
+typedef void (*RowKernel)(uint8_t *above, uint8_t *row, uint8_t *below, const uint8_t *a, size_t count, uint8_t k);
+
+// Both operands are below k <= 128, so the sum fits in a byte; subtracting k wraps around exactly when the
+// sum was already below k, and the unsigned minimum picks whichever of the two is the reduced value
+inline uint8_t addMod(uint8_t x, uint8_t y, uint8_t k) {
+    uint8_t sum = x + y;
+    return std::min<uint8_t>(sum, static_cast<uint8_t>(sum - k));
+}
+
+void pressRowScalar(uint8_t *above, uint8_t *row, uint8_t *below, const uint8_t *a, size_t count, uint8_t k) {
+    for (size_t x = 0; x < count; x++) {
+        row[x] = addMod(row[x], addMod(addMod(a[x - 1], a[x], k), a[x + 1], k), k);
+        if (above) { above[x] = addMod(above[x], a[x], k); }
+        if (below) { below[x] = addMod(below[x], a[x], k); }
+    }
+}
+
+#ifdef MODBOARD_SSE2
+inline __m128i addModSSE2(__m128i x, __m128i y, __m128i k) {
+    __m128i sum = _mm_add_epi8(x, y);
+    return _mm_min_epu8(sum, _mm_sub_epi8(sum, k));
+}
+
+void pressRowSSE2(uint8_t *above, uint8_t *row, uint8_t *below, const uint8_t *a, size_t count, uint8_t k) {
+    const __m128i mod = _mm_set1_epi8(static_cast<char>(k));
+    for (size_t x = 0; x < count; x += 16) {
+        __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x));
+        __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x - 1));
+        __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x + 1));
+        __m128i sum = addModSSE2(addModSSE2(left, center, mod), right, mod);
+
+        auto *out = reinterpret_cast<__m128i *>(row + x);
+        _mm_storeu_si128(out, addModSSE2(_mm_loadu_si128(out), sum, mod));
+        if (above) {
+            out = reinterpret_cast<__m128i *>(above + x);
+            _mm_storeu_si128(out, addModSSE2(_mm_loadu_si128(out), center, mod));
+        }
+        if (below) {
+            out = reinterpret_cast<__m128i *>(below + x);
+            _mm_storeu_si128(out, addModSSE2(_mm_loadu_si128(out), center, mod));
+        }
+    }
+}
+#endif
+
+#ifdef MODBOARD_AVX2
+AVX2_TARGET inline __m256i addModAVX2(__m256i x, __m256i y, __m256i k) {
+    __m256i sum = _mm256_add_epi8(x, y);
+    return _mm256_min_epu8(sum, _mm256_sub_epi8(sum, k));
+}
+
+AVX2_TARGET void pressRowAVX2(uint8_t *above, uint8_t *row, uint8_t *below, const uint8_t *a, size_t count, uint8_t k) {
+    const __m256i mod = _mm256_set1_epi8(static_cast<char>(k));
+    for (size_t x = 0; x < count; x += 32) {
+        __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + x));
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + x - 1));
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + x + 1));
+        __m256i sum = addModAVX2(addModAVX2(left, center, mod), right, mod);
+
+        auto *out = reinterpret_cast<__m256i *>(row + x);
+        _mm256_storeu_si256(out, addModAVX2(_mm256_loadu_si256(out), sum, mod));
+        if (above) {
+            out = reinterpret_cast<__m256i *>(above + x);
+            _mm256_storeu_si256(out, addModAVX2(_mm256_loadu_si256(out), center, mod));
+        }
+        if (below) {
+            out = reinterpret_cast<__m256i *>(below + x);
+            _mm256_storeu_si256(out, addModAVX2(_mm256_loadu_si256(out), center, mod));
+        }
+    }
+}
+#endif
+
+/// @brief The kernel used by pressRow(), picked once from the CPU's features
+struct Kernels {
+    RowKernel pressRow = pressRowScalar;
+    const char *name = "scalar";
+
+    Kernels() {
+#ifdef MODBOARD_SSE2
+        pressRow = pressRowSSE2;
+        name = "sse2";
+#endif
+#ifdef MODBOARD_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            pressRow = pressRowAVX2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+const Kernels &kernels() {
+    static const Kernels selected;
+    return selected;
+}
+
+} // namespace
+
+ModBoard::ModBoard(int width, int height, int states)
+    : width(width), height(height), states(std::clamp(states, 2, MAX_STATES)), stride((width + 31) / 32 * 32) {
+    cells.resize(static_cast<size_t>(stride) * height);
+    padded.resize(stride + 2);
+}
+
+void ModBoard::press(int x, int y) {
+    auto bump = [this](int x, int y) {
+        uint8_t &cell = row(y)[x];
+        cell = cell + 1 == states ? 0 : cell + 1;
+    };
+    bump(x, y);
+    if (x > 0)          { bump(x - 1, y); }
+    if (x < width - 1)  { bump(x + 1, y); }
+    if (y > 0)          { bump(x, y - 1); }
+    if (y < height - 1) { bump(x, y + 1); }
+}
+
+void ModBoard::pressRow(int y, const uint8_t *amounts) {
+    // The kernels work on whole padded rows; zeros around and after the presses keep the padding at zero,
+    // except for the light right of the last one, which gets the last press as its left neighbor
+    memcpy(&padded[1], amounts, width);
+    kernels().pressRow(y > 0 ? row(y - 1) : nullptr, row(y), y < height - 1 ? row(y + 1) : nullptr,
+                        &padded[1], stride, static_cast<uint8_t>(states));
+    if (width < stride) { row(y)[width] = 0; }
+}
+
+void ModBoard::applyPresses(const ModBoard &presses) {
+    // Pressing a row changes the rows above and below it, which would still be read as presses
+    if (&presses == this) {
+        ModBoard copy = presses;
+        applyPresses(copy);
+        return;
+    }
+    if (presses.width != width || presses.height != height || presses.states != states) {
+        std::cout << "ERROR::MODBOARD: Presses for a " << presses.width << "x" << presses.height << " board with "
+                  << presses.states << " states applied to a " << width << "x" << height << " board with "
+                  << states << " states" << std::endl;
+        return;
+    }
+    for (int y = 0; y < height; y++) {
+        pressRow(y, presses.row(y));
+    }
+}
+
+bool ModBoard::allOff() const {
+    for (uint8_t cell : cells) {
+        if (cell) { return false; }
+    }
+    return true;
+}
+
+void ModBoard::scramble(uint32_t seed) {
+    std::mt19937 random(seed);
+    vector<uint8_t> amounts(width);
+    for (int y = 0; y < height; y++) {
+        for (uint8_t &amount : amounts) { amount = static_cast<uint8_t>(random() % states); }
+        pressRow(y, amounts.data());
+    }
+}
+
+void ModBoard::set(int x, int y, int state) {
+    row(y)[x] = static_cast<uint8_t>(((state % states) + states) % states);
+}
+
+void ModBoard::fill(int state) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) { set(x, y, state); }
+    }
+}
+
+bool ModBoard::operator==(const ModBoard &other) const {
+    return width == other.width && height == other.height && states == other.states && cells == other.cells;
+}
+
+const char *modBoardKernelName() {
+    return kernels().name;
+}
@@ -0,0 +1,98 @@
+#ifndef GRAPHICS_MODBOARD_H
+#define GRAPHICS_MODBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief A board whose lights cycle through k states instead of two (e.g. 3 for "Lights Out 2000").
+ * @details Pressing a light advances it and its (up to) four neighbors by one state, modulo k; the
+ * board is won when every light is back at state 0. Each light is one byte. Rows are padded to a
+ * multiple of 32 bytes and the padding is always zero, so whole rows can be processed 16 or 32 lights
+ * at a time: pressRow() adds a row of presses with SIMD add-modulo-k (SSE2, or AVX2 when the CPU has it).
+ */
+class ModBoard {
+public:
+    /// @brief Largest number of states (keeps sums of two states within a byte)
+    static constexpr int MAX_STATES = 128;
+
+    /// @brief Construct a new ModBoard with every light at state 0
+    /// @param width Number of columns
+    /// @param height Number of rows
+    /// @param states Number of states k (2 to MAX_STATES)
+    ModBoard(int width = 5, int height = 5, int states = 3);
+
+    // --------------------------------------------------------
+    // Game rules
+    // --------------------------------------------------------
+
+    /// @brief Advances the light at (x, y) and its neighbors by one state
+    void press(int x, int y);
+
+    /**
+     * @brief Presses every light of a row at once
+     *
+     * @param y The row
+     * @param amounts How many times to press each light of the row (width values, each below the number of states)
+     */
+    void pressRow(int y, const uint8_t *amounts);
+
+    /**
+     * @brief Applies a whole board of presses (each light of presses says how often to press that light)
+     *
+     * @param presses The presses (same size and number of states as this board; may be this board)
+     */
+    void applyPresses(const ModBoard &presses);
+
+    /// @brief Returns true if every light is at state 0
+    bool allOff() const;
+
+    /// @brief Presses each light a random number of times (from all off, this gives a random solvable board)
+    /// @param seed Same seed, same presses
+    void scramble(uint32_t seed);
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+    int getWidth() const  { return width; }
+    int getHeight() const { return height; }
+    int getStates() const { return states; }
+    int getCellCount() const { return width * height; }
+    int get(int x, int y) const { return row(y)[x]; }
+
+    /// @brief Bytes used by each row (width rounded up to 32)
+    int getStride() const { return stride; }
+
+    /// @brief Pointer to the lights of row y
+    uint8_t *row(int y)             { return &cells[static_cast<size_t>(y) * stride]; }
+    const uint8_t *row(int y) const { return &cells[static_cast<size_t>(y) * stride]; }
+
+    // --------------------------------------------------------
+    // Setters
+    // --------------------------------------------------------
+
+    /// @brief Sets a light's state (taken modulo the number of states)
+    void set(int x, int y, int state);
+
+    /// @brief Sets every light to the same state
+    void fill(int state);
+
+    bool operator==(const ModBoard &other) const;
+    bool operator!=(const ModBoard &other) const { return !(*this == other); }
+
+private:
+    int width, height, states;
+    int stride;
+    vector<uint8_t> cells;
+
+    /// @brief Row of presses with a zero on either side, so kernels can read each light's left and right neighbor
+    vector<uint8_t> padded;
+};
+
+/// @brief Name of the row kernel picked for this CPU ("scalar", "sse2" or "avx2")
+const char *modBoardKernelName();
+
+#endif //GRAPHICS_MODBOARD_H
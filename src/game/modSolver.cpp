@@ -0,0 +1,174 @@
+#include "modSolver.h"
+
+#include <algorithm>
+
+namespace {
+/// @brief Number of times p divides a (a > 0)
+int valuation(int a, int p) {
+    int v = 0;
+    for (; a % p == 0; a /= p) { v++; }
+    return v;
+}
+
+/// @brief Inverse of a unit modulo m
+int inverse(int a, int m) {
+    // Extended Euclid; a and m are coprime
+    int r0 = m, r1 = a % m, t0 = 0, t1 = 1;
+    while (r1) {
+        int q = r0 / r1, r2 = r0 - q * r1, t2 = t0 - q * t1;
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+    }
+    return ((t0 % m) + m) % m;
+}
+}
+
+ModSolver::ModSolver(int width, int height, int states)
+    : width(width), height(height), states(std::clamp(states, 2, ModBoard::MAX_STATES)) {
+    // Column j of the map is the last row left on by pressing first-row light j once
+    vector<int> map(width * width);
+    vector<uint8_t> unit(width);
+    for (int j = 0; j < width; j++) {
+        ModBoard lights(width, height, this->states);
+        std::fill(unit.begin(), unit.end(), 0);
+        unit[j] = 1;
+        chase(lights, unit.data(), nullptr);
+        for (int i = 0; i < width; i++) { map[i * width + j] = lights.get(i, height - 1); }
+    }
+
+    int rest = this->states;
+    for (int p = 2; rest > 1; p++) {
+        if (rest % p) { continue; }
+        Factor factor;
+        factor.prime = p;
+        factor.modulus = 1;
+        for (; rest % p == 0; rest /= p) { factor.modulus *= p; }
+        eliminate(map, factor);
+        factors.push_back(std::move(factor));
+    }
+}
+
+void ModSolver::eliminate(const vector<int> &map, Factor &factor) const {
+    const int q = factor.modulus, p = factor.prime;
+    vector<int> &m = factor.reduced, &t = factor.transform;
+    m.resize(width * width);
+    t.assign(width * width, 0);
+    for (int ii = 0; ii < width * width; ii++) { m[ii] = map[ii] % q; }
+    for (int i = 0; i < width; i++) { t[i * width + i] = 1; }
+
+    auto swapRows = [&](vector<int> &v, int a, int b) {
+        std::swap_ranges(v.begin() + a * width, v.begin() + (a + 1) * width, v.begin() + b * width);
+    };
+    auto scaleRow = [&](vector<int> &v, int r, int factor) {
+        for (int c = 0; c < width; c++) { v[r * width + c] = v[r * width + c] * factor % q; }
+    };
+    // to -= f * from
+    auto subtractRow = [&](vector<int> &v, int to, int from, int f) {
+        for (int c = 0; c < width; c++) {
+            v[to * width + c] = ((v[to * width + c] - f * v[from * width + c]) % q + q) % q;
+        }
+    };
+
+    vector<bool> used(width, false);
+    for (int &rank = factor.rank; rank < width; rank++) {
+        // Pivot on the entry with the fewest factors of p: it divides every other entry left
+        int bestRow = -1, bestCol = -1, bestPower = 0;
+        for (int r = rank; r < width; r++) {
+            for (int c = 0; c < width; c++) {
+                int a = m[r * width + c];
+                if (used[c] || !a) { continue; }
+                int v = valuation(a, p);
+                if (bestRow < 0 || v < bestPower) { bestRow = r; bestCol = c; bestPower = v; }
+            }
+        }
+        if (bestRow < 0) { break; }
+
+        swapRows(m, bestRow, rank);
+        swapRows(t, bestRow, rank);
+        used[bestCol] = true;
+
+        // Scale the pivot to exactly p^v
+        int power = 1;
+        for (int ii = 0; ii < bestPower; ii++) { power *= p; }
+        int unitInverse = inverse(m[rank * width + bestCol] / power, q);
+        scaleRow(m, rank, unitInverse);
+        scaleRow(t, rank, unitInverse);
+
+        for (int r = rank + 1; r < width; r++) {
+            int a = m[r * width + bestCol];
+            if (!a) { continue; }
+            subtractRow(m, r, rank, a / power);
+            subtractRow(t, r, rank, a / power);
+        }
+        factor.columns.push_back(bestCol);
+        factor.pivots.push_back(power);
+    }
+}
+
+bool ModSolver::solveFactor(const Factor &factor, const uint8_t *residue, vector<int> &firstRow) const {
+    const int q = factor.modulus;
+
+    // The first row must cancel the residue: map * firstRow = -residue
+    vector<int> rhs(width, 0);
+    for (int i = 0; i < width; i++) {
+        int sum = 0;
+        for (int j = 0; j < width; j++) { sum += factor.transform[i * width + j] * ((states - residue[j]) % q); }
+        rhs[i] = sum % q;
+    }
+    for (int i = factor.rank; i < width; i++) {
+        if (rhs[i]) { return false; }
+    }
+
+    // Back substitution; free columns are left unpressed
+    std::fill(firstRow.begin(), firstRow.end(), 0);
+    for (int r = factor.rank - 1; r >= 0; r--) {
+        int sum = rhs[r];
+        for (int s = r + 1; s < factor.rank; s++) {
+            int c = factor.columns[s];
+            sum -= factor.reduced[r * width + c] * firstRow[c];
+        }
+        sum = (sum % q + q) % q;
+        // p^v * x = sum (mod q) needs p^v to divide sum, and then fixes x modulo q / p^v
+        if (sum % factor.pivots[r]) { return false; }
+        firstRow[factor.columns[r]] = sum / factor.pivots[r];
+    }
+    return true;
+}
+
+void ModSolver::chase(ModBoard &lights, const uint8_t *firstRow, ModBoard *presses) const {
+    vector<uint8_t> amounts(firstRow, firstRow + width);
+    for (int y = 0; y < height; y++) {
+        if (y > 0) {
+            // Press each light under one that is still on until the one above is back at 0
+            const uint8_t *above = lights.row(y - 1);
+            for (int x = 0; x < width; x++) { amounts[x] = above[x] ? static_cast<uint8_t>(states - above[x]) : 0; }
+        }
+        lights.pressRow(y, amounts.data());
+        if (presses) { std::copy(amounts.begin(), amounts.end(), presses->row(y)); }
+    }
+}
+
+bool ModSolver::solve(const ModBoard &board, ModBoard &presses) const {
+    ModBoard lights = board;
+    vector<uint8_t> zero(width, 0);
+    chase(lights, zero.data(), nullptr);
+    const uint8_t *residue = lights.row(height - 1);
+
+    // Solve modulo each prime power, then join the first rows: x = sum of x_i * (k / q_i) * ((k / q_i)^-1 mod q_i)
+    vector<int> solution(width), combined(width, 0);
+    for (const Factor &factor : factors) {
+        if (!solveFactor(factor, residue, solution)) { return false; }
+        int rest = states / factor.modulus;
+        int weight = rest * inverse(rest % factor.modulus, factor.modulus) % states;
+        for (int x = 0; x < width; x++) { combined[x] = (combined[x] + solution[x] * weight) % states; }
+    }
+
+    vector<uint8_t> firstRow(width);
+    for (int x = 0; x < width; x++) { firstRow[x] = static_cast<uint8_t>(combined[x]); }
+    presses = ModBoard(width, height, states);
+    lights = board;
+    chase(lights, firstRow.data(), &presses);
+    return lights.allOff();
+}
@@ -0,0 +1,71 @@
+#ifndef GRAPHICS_MODSOLVER_H
+#define GRAPHICS_MODSOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "modBoard.h"
+
+using std::vector;
+
+/**
+ * @brief Finds how often to press each light to turn a k-state board off.
+ * @details The same light chasing as Solver, over Z_k instead of GF(2): with the first row of presses
+ * chosen, each later press is forced (k minus the state of the light above), and the last row left over
+ * depends linearly on the first row. Z_k is only a field when k is prime, so k is split into prime powers
+ * p^e; the map is eliminated modulo each of them (pivoting on the entry with the fewest factors of p,
+ * which is a unit times a power of p), and the first rows found for each are joined with the Chinese
+ * remainder theorem.
+ *
+ * Solutions are not minimized; any press pattern that turns the board off is returned.
+ */
+class ModSolver {
+public:
+    /// @brief Prepares the solver for boards of one size and number of states
+    ModSolver(int width, int height, int states);
+
+    /**
+     * @brief Solves a board
+     *
+     * @param board The board (must have the size and states given to the constructor)
+     * @param presses Receives how often to press each light (a board of the same size and states)
+     * @return false if the board can't be turned off
+     */
+    bool solve(const ModBoard &board, ModBoard &presses) const;
+
+    int getWidth() const  { return width; }
+    int getHeight() const { return height; }
+    int getStates() const { return states; }
+
+private:
+    int width, height, states;
+
+    /// @brief The map from first-row presses to last-row residue, modulo one prime power of the states
+    struct Factor {
+        int prime = 0, modulus = 0;
+        /// @brief Eliminated map: width rows of width entries, upper triangular in the order of columns
+        vector<int> reduced;
+        /// @brief Row operations of the elimination, applied to a residue before back substitution
+        vector<int> transform;
+        /// @brief Column of the pivot of each of the first rank rows, and its power of the prime
+        vector<int> columns, pivots;
+        int rank = 0;
+    };
+    vector<Factor> factors;
+
+    /// @brief Eliminates the map (entries modulo k) modulo one factor
+    void eliminate(const vector<int> &map, Factor &factor) const;
+
+    /// @brief Solves the first row modulo one factor
+    bool solveFactor(const Factor &factor, const uint8_t *residue, vector<int> &firstRow) const;
+
+    /**
+     * @brief Presses firstRow on the first row, then chases the lights down
+     *
+     * @param lights Starting lights; receives the lights left on (only the last row can be lit)
+     * @param firstRow width first-row presses
+     * @param presses If not null, receives the presses of every row
+     */
+    void chase(ModBoard &lights, const uint8_t *firstRow, ModBoard *presses) const;
+};
+
+#endif //GRAPHICS_MODSOLVER_H
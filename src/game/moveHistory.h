@@ -0,0 +1,494 @@
+#ifndef GRAPHICS_MOVEHISTORY_H
+#define GRAPHICS_MOVEHISTORY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "modBoard.h"
+
+using std::vector;
+
+/// @brief What MoveHistory needs to know about a kind of board
+template <typename BoardType>
+struct BoardTraits;
+
+template <>
+struct BoardTraits<Board> {
+    static int states(const Board &) { return 2; }
+    static size_t bytes(const Board &board) { return sizeof(uint64_t) * board.getStride() * board.getHeight(); }
+    static int get(const Board &board, int x, int y) { return board.isLit(x, y); }
+    /// @brief A press is its own inverse
+    static void unpress(Board &board, int x, int y) { board.press(x, y); }
+};
+
+template <>
+struct BoardTraits<ModBoard> {
+    static int states(const ModBoard &board) { return board.getStates(); }
+    static size_t bytes(const ModBoard &board) { return static_cast<size_t>(board.getStride()) * board.getHeight(); }
+    static int get(const ModBoard &board, int x, int y) { return board.get(x, y); }
+    /// @brief With k states, k - 1 more presses bring the lights back around
+    static void unpress(ModBoard &board, int x, int y) {
+        for (int ii = 1; ii < board.getStates(); ii++) { board.press(x, y); }
+    }
+};
+
+/**
+ * @brief Light indices packed at a fixed number of bits each (e.g. 5 for a 5x5 board, 26 for 8192x8192)
+ * @details Storage grows by an eighth at a time rather than doubling, so little of it sits unused.
+ */
+class PackedMoves {
+public:
+    /// @param bits Bits per move (1 to 32)
+    explicit PackedMoves(int bits = 32) : bits(bits) { }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int getBits() const { return bits; }
+
+    uint32_t operator[](size_t index) const {
+        const uint64_t bit = static_cast<uint64_t>(index) * bits;
+        const int shift = static_cast<int>(bit & 63);
+        uint64_t value = words[bit >> 6] >> shift;
+        if (shift + bits > 64) { value |= words[(bit >> 6) + 1] << (64 - shift); }
+        return static_cast<uint32_t>(value & mask());
+    }
+
+    void push_back(uint32_t move) {
+        const uint64_t bit = static_cast<uint64_t>(count) * bits;
+        const int shift = static_cast<int>(bit & 63);
+        if ((bit + bits + 63) / 64 > words.size()) {
+            if (words.size() == words.capacity()) { words.reserve(words.size() + words.size() / 8 + 8); }
+            words.push_back(0);
+        }
+        words[bit >> 6] |= (move & mask()) << shift;
+        if (shift + bits > 64) { words[(bit >> 6) + 1] |= (move & mask()) >> (64 - shift); }
+        count++;
+    }
+
+    void clear() {
+        words.clear();
+        count = 0;
+    }
+
+    /// @brief The packed words, ((size() * bits + 63) / 64 of them), for saving
+    const vector<uint64_t> &getWords() const { return words; }
+
+    /// @brief Replaces the moves with count packed ones (bits past the last move must be zero)
+    void assign(vector<uint64_t> packed, size_t count) {
+        words = std::move(packed);
+        this->count = count;
+    }
+
+    static size_t wordCount(size_t count, int bits) { return (static_cast<uint64_t>(count) * bits + 63) / 64; }
+
+private:
+    vector<uint64_t> words;
+    size_t count = 0;
+    int bits;
+
+    uint64_t mask() const { return bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1; }
+};
+
+/**
+ * @brief The moves of a game, for undo, redo and resuming later.
+ * @details Moves are stored as light indices (y * width + x) packed at the fewest bits that hold any index
+ * (see getMoveBits()). Undo presses the light again (or k - 1 more times with k states), so the history never
+ * has to store boards for it. Making a different move after an undo starts a branch instead of discarding the
+ * moves that were undone; each branch only stores its own moves and the point where it left its parent.
+ *
+ * Every getSnapshotInterval() moves a copy of the board is kept, and jumpTo() starts from whichever is
+ * closest: the current position, the last snapshot before the target or the first one after it (undoing
+ * back to the target). Snapshots are paid for with the bits a move doesn't use out of 4 bytes, so a move
+ * never costs more than 4 bytes: a 5x5 board (5 bits per move) keeps a snapshot every couple of dozen
+ * moves, an 8192x8192 one (26 bits, and 8 MB per snapshot) one every 11 million or so. A jump replays at
+ * most half an interval of presses (or the distance jumped); each press is a few word operations.
+ *
+ * @tparam BoardType Board or ModBoard
+ */
+template <typename BoardType>
+class MoveHistory {
+public:
+    /// @param start The board before the first move
+    explicit MoveHistory(const BoardType &start) { reset(start); }
+
+    /// @brief Forgets every move and starts over from a new board
+    void reset(const BoardType &start) {
+        this->start = start;
+        const uint64_t cells = static_cast<uint64_t>(start.getWidth()) * start.getHeight();
+        moveBits = 1;
+        while (moveBits < 32 && (uint64_t(1) << moveBits) < cells) { moveBits++; }
+        // A snapshot costs its bits, spread over the moves up to the next one out of what each move leaves
+        // of MOVE_BUDGET_BITS
+        const uint64_t snapshotBits = 8 * (BoardTraits<BoardType>::bytes(start) + sizeof(Snapshot));
+        const int spareBits = MOVE_BUDGET_BITS - moveBits;
+        interval = spareBits > 0 ? static_cast<size_t>((snapshotBits + spareBits - 1) / spareBits) : SIZE_MAX;
+        branches.assign(1, {-1, 0, PackedMoves(moveBits), {}});
+        branch = 0;
+        depth = 0;
+    }
+
+    /**
+     * @brief Adds a move that was just played
+     * @details Replaying the move that was undone is a redo; any other move after an undo starts a
+     * branch (or follows the branch that already plays it from here, which may be the one it left).
+     *
+     * @param board The board after the move (kept if a snapshot is due)
+     * @param cell Index of the light pressed (y * width + x)
+     */
+    void record(const BoardType &board, uint32_t cell) {
+        if (depth < length(branch)) {
+            if (moveAt(branch, depth + 1) == cell) {
+                depth++;
+                return;
+            }
+            int sibling = findBranch(cell);
+            if (sibling >= 0) {
+                branch = sibling;
+                depth++;
+                return;
+            }
+            branches.push_back({branch, depth, PackedMoves(moveBits), {}});
+            branch = static_cast<int>(branches.size()) - 1;
+        }
+        Branch &current = branches[branch];
+        current.moves.push_back(cell);
+        depth++;
+        if (depth % interval == 0) { current.snapshots.push_back({depth, board}); }
+    }
+
+    /// @brief Takes back the last move
+    /// @param cell If not null, receives the light that was pressed
+    /// @return false if there is nothing to undo
+    bool undo(BoardType &board, uint32_t *cell = nullptr) {
+        if (depth == 0) { return false; }
+        uint32_t move = moveAt(branch, depth--);
+        BoardTraits<BoardType>::unpress(board, move % board.getWidth(), move / board.getWidth());
+        if (cell) { *cell = move; }
+        return true;
+    }
+
+    /// @brief Plays the last move undone on this branch again
+    /// @param cell If not null, receives the light that was pressed
+    /// @return false if there is nothing to redo
+    bool redo(BoardType &board, uint32_t *cell = nullptr) {
+        if (depth >= length(branch)) { return false; }
+        uint32_t move = moveAt(branch, ++depth);
+        board.press(move % board.getWidth(), move / board.getWidth());
+        if (cell) { *cell = move; }
+        return true;
+    }
+
+    /// @brief Moves to a point on the current branch (0 is the start, getLength() the last move)
+    void jumpTo(size_t target, BoardType &board) {
+        target = std::min(target, length(branch));
+        const Snapshot *before = lastSnapshot(branch, target);
+        const Snapshot *after = nextSnapshot(branch, target);
+        const size_t beforeDepth = before ? before->depth : 0;
+        size_t distance = depth > target ? depth - target : target - depth;
+        if (target - beforeDepth < distance) {
+            board = before ? before->board : start;
+            depth = beforeDepth;
+            distance = target - beforeDepth;
+        }
+        if (after && after->depth - target < distance) {
+            board = after->board;
+            depth = after->depth;
+        }
+        while (depth < target) { redo(board); }
+        while (depth > target) { undo(board); }
+    }
+
+    /// @brief Switches to another branch, at its last move
+    void selectBranch(int index, BoardType &board) {
+        if (index < 0 || index >= getBranchCount() || index == branch) { return; }
+        // Back up to where the two branches part, then follow the new one
+        jumpTo(commonDepth(branch, depth, index, length(index)), board);
+        branch = index;
+        jumpTo(length(index), board);
+    }
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+
+    /// @brief Number of moves played to reach the current board
+    size_t getDepth() const { return depth; }
+    /// @brief Number of moves on the current branch, including any that were undone
+    size_t getLength() const { return length(branch); }
+    int getBranch() const { return branch; }
+    int getBranchCount() const { return static_cast<int>(branches.size()); }
+    size_t getSnapshotInterval() const { return interval; }
+    /// @brief Bits each stored move takes (enough for any light index of the board)
+    int getMoveBits() const { return moveBits; }
+    /// @brief Number of board copies kept for jumps
+    size_t getSnapshotCount() const {
+        size_t count = 0;
+        for (const Branch &stored : branches) { count += stored.snapshots.size(); }
+        return count;
+    }
+
+    /// @brief Number of moves stored over all branches
+    size_t getStoredMoves() const {
+        size_t count = 0;
+        for (const Branch &stored : branches) { count += stored.moves.size(); }
+        return count;
+    }
+
+    // --------------------------------------------------------
+    // Saving
+    // --------------------------------------------------------
+
+    /// @brief Writes the start board, the moves of every branch and the current position to a file
+    /// (snapshots are rebuilt on load)
+    bool save(const std::string &path) const {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cout << "ERROR::HISTORY: Could not open " << path << " for writing" << std::endl;
+            return false;
+        }
+        Header header{MAGIC, VERSION, static_cast<uint32_t>(start.getWidth()), static_cast<uint32_t>(start.getHeight()),
+                      static_cast<uint32_t>(BoardTraits<BoardType>::states(start)),
+                      static_cast<uint32_t>(branches.size()), branch, 0, depth};
+        const vector<uint8_t> startBits = packStart();
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+                  && fwrite(startBits.data(), 1, startBits.size(), file) == startBits.size();
+        for (const Branch &stored : branches) {
+            BranchHeader info{stored.parent, 0, stored.fork, stored.moves.size()};
+            const vector<uint64_t> &words = stored.moves.getWords();
+            ok = ok && fwrite(&info, sizeof(info), 1, file) == 1;
+            ok = ok && fwrite(words.data(), sizeof(uint64_t), words.size(), file) == words.size();
+        }
+        ok = fclose(file) == 0 && ok;
+        if (!ok) { std::cout << "ERROR::HISTORY: Could not write " << path << std::endl; }
+        return ok;
+    }
+
+    /**
+     * @brief Replaces the history with one saved by save()
+     *
+     * @param path The file
+     * @param board Set to the saved position
+     * @return false (and the history and board unchanged) if the file can't be read or was saved for another
+     * start board (a different size, number of states or puzzle)
+     */
+    bool load(const std::string &path, BoardType &board) {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (!file) {
+            std::cout << "ERROR::HISTORY: Could not open " << path << std::endl;
+            return false;
+        }
+        Header header{};
+        vector<Branch> loaded;
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.magic == MAGIC && header.version == VERSION;
+        ok = ok && header.width == static_cast<uint32_t>(start.getWidth())
+                && header.height == static_cast<uint32_t>(start.getHeight())
+                && header.states == static_cast<uint32_t>(BoardTraits<BoardType>::states(start))
+                && header.branchCount > 0;
+        vector<uint8_t> startBits(ok ? packedBytes() : 0);
+        ok = ok && fread(startBits.data(), 1, startBits.size(), file) == startBits.size();
+        if (ok && startBits != packStart()) {
+            fclose(file);
+            std::cout << "ERROR::HISTORY: " << path << " was saved for a different puzzle" << std::endl;
+            return false;
+        }
+        const uint64_t cells = static_cast<uint64_t>(start.getWidth()) * start.getHeight();
+        for (uint32_t ii = 0; ok && ii < header.branchCount; ii++) {
+            // Parents come before their branches, and each branch leaves its parent at a move it has
+            BranchHeader info{};
+            ok = fread(&info, sizeof(info), 1, file) == 1;
+            ok = ok && (ii == 0 ? info.parent == -1 && info.fork == 0
+                                : info.parent >= 0 && info.parent < static_cast<int32_t>(ii)
+                                  && info.fork <= loaded[info.parent].fork + loaded[info.parent].moves.size());
+            if (!ok) { break; }
+            // Moves are packed as in memory; anything past the last one is zero
+            ok = info.count <= UINT64_MAX / 64;
+            vector<uint64_t> words(ok ? PackedMoves::wordCount(static_cast<size_t>(info.count), moveBits) : 0);
+            ok = ok && fread(words.data(), sizeof(uint64_t), words.size(), file) == words.size();
+            const uint64_t usedBits = info.count * moveBits;
+            ok = ok && (usedBits % 64 == 0 || (words.back() >> (usedBits % 64)) == 0);
+            Branch stored{info.parent, static_cast<size_t>(info.fork), PackedMoves(moveBits), {}};
+            if (ok) { stored.moves.assign(std::move(words), static_cast<size_t>(info.count)); }
+            for (size_t move = 0; ok && move < stored.moves.size(); move++) { ok = stored.moves[move] < cells; }
+            loaded.push_back(std::move(stored));
+        }
+        fclose(file);
+        ok = ok && header.branch >= 0 && header.branch < static_cast<int32_t>(loaded.size())
+                && header.depth <= loaded[header.branch].fork + loaded[header.branch].moves.size();
+        if (!ok) {
+            std::cout << "ERROR::HISTORY: " << path << " is not a history of this board" << std::endl;
+            return false;
+        }
+
+        // Replay each branch from where it leaves its parent to rebuild its snapshots
+        branches = std::move(loaded);
+        BoardType scratch = start;
+        for (int ii = 0; ii < getBranchCount(); ii++) {
+            Branch &stored = branches[ii];
+            PackedMoves moves = std::move(stored.moves);
+            stored.moves = PackedMoves(moveBits);
+            branch = ii;
+            scratch = start;
+            depth = 0;
+            jumpTo(stored.fork, scratch);
+            for (size_t move = 0; move < moves.size(); move++) {
+                const uint32_t cell = moves[move];
+                scratch.press(cell % scratch.getWidth(), cell / scratch.getWidth());
+                stored.moves.push_back(cell);
+                depth++;
+                if (depth % interval == 0) { stored.snapshots.push_back({depth, scratch}); }
+            }
+        }
+        branch = header.branch;
+        board = start;
+        depth = 0;
+        jumpTo(header.depth, board);
+        return true;
+    }
+
+private:
+    /// @brief Most a move may cost, snapshots included
+    static constexpr int MOVE_BUDGET_BITS = 32;
+    static constexpr uint32_t MAGIC = 0x49484f4c; // "LOHI"
+    static constexpr uint32_t VERSION = 3;
+
+    struct Snapshot {
+        size_t depth;
+        BoardType board;
+    };
+
+    struct Branch {
+        /// @brief Branch this one left (-1 for the first), and after how many of its moves
+        int parent;
+        size_t fork;
+        /// @brief Moves after the fork: moves[i] is move number fork + i + 1
+        PackedMoves moves;
+        /// @brief Boards after every interval-th move of this branch, in order
+        vector<Snapshot> snapshots;
+    };
+
+    // File layout: a Header, the start board (bitsPerCell() bits per light in row order, like the records of a
+    // puzzle pack, padded to whole bytes), then a BranchHeader and its moves for each branch (packed as in
+    // memory, padded to whole 64-bit words)
+    struct Header {
+        uint32_t magic, version, width, height, states, branchCount;
+        int32_t branch, reserved;
+        uint64_t depth;
+    };
+    struct BranchHeader {
+        int32_t parent, reserved;
+        uint64_t fork, count;
+    };
+
+    BoardType start;
+    vector<Branch> branches;
+    int branch = 0;
+    size_t depth = 0;
+    int moveBits = 32;
+    size_t interval = SIZE_MAX;
+
+    /// @brief Bits that hold the state of a light in a saved start board
+    int bitsPerCell() const {
+        int bits = 1;
+        while ((1 << bits) < BoardTraits<BoardType>::states(start)) { bits++; }
+        return bits;
+    }
+
+    size_t packedBytes() const {
+        return (static_cast<size_t>(start.getWidth()) * start.getHeight() * bitsPerCell() + 7) / 8;
+    }
+
+    /// @brief The start board as it is saved
+    vector<uint8_t> packStart() const {
+        vector<uint8_t> bytes(packedBytes(), 0);
+        const int bits = bitsPerCell();
+        size_t bit = 0;
+        for (int y = 0; y < start.getHeight(); y++) {
+            for (int x = 0; x < start.getWidth(); x++, bit += bits) {
+                // A state takes at most 7 bits (ModBoard::MAX_STATES), so it spans one byte or two
+                const unsigned state = static_cast<unsigned>(BoardTraits<BoardType>::get(start, x, y));
+                const int shift = static_cast<int>(bit & 7);
+                bytes[bit >> 3] |= static_cast<uint8_t>(state << shift);
+                if (shift + bits > 8) { bytes[(bit >> 3) + 1] |= static_cast<uint8_t>(state >> (8 - shift)); }
+            }
+        }
+        return bytes;
+    }
+
+    size_t length(int index) const { return branches[index].fork + branches[index].moves.size(); }
+
+    /// @brief The branch holding move number n (1-based) of a branch's path
+    int owner(int index, size_t n) const {
+        while (n <= branches[index].fork) { index = branches[index].parent; }
+        return index;
+    }
+
+    /// @brief Move number n (1-based) of a branch's path
+    uint32_t moveAt(int index, size_t n) const {
+        index = owner(index, n);
+        return branches[index].moves[n - branches[index].fork - 1];
+    }
+
+    /// @brief A branch that shares the current path up to here and then plays cell, or -1
+    /// @details Only the branch that stores the next move of a path is checked for it, but every branch is
+    /// one: a sibling that starts here, or an ancestor (the first branch included) that passes through.
+    int findBranch(uint32_t cell) const {
+        int here = depth > 0 ? owner(branch, depth) : -1;
+        for (int ii = 0; ii < getBranchCount(); ii++) {
+            const Branch &other = branches[ii];
+            if (other.fork <= depth && depth < length(ii) && other.moves[depth - other.fork] == cell
+                && (depth == 0 || owner(ii, depth) == here)) {
+                return ii;
+            }
+        }
+        return -1;
+    }
+
+    /// @brief The last snapshot at or before move n of a branch's path, or nullptr if there is none
+    const Snapshot *lastSnapshot(int index, size_t n) const {
+        // A branch's own snapshots are all past its fork, so the first branch up the chain with one wins
+        for (; index >= 0; index = branches[index].parent) {
+            const vector<Snapshot> &snapshots = branches[index].snapshots;
+            auto after = std::upper_bound(snapshots.begin(), snapshots.end(), n,
+                                          [](size_t n, const Snapshot &snapshot) { return n < snapshot.depth; });
+            if (after != snapshots.begin()) { return &*(after - 1); }
+            n = std::min(n, branches[index].fork);
+        }
+        return nullptr;
+    }
+
+    /// @brief The first snapshot after move n of a branch's path (up to its last move), or nullptr if there is none
+    const Snapshot *nextSnapshot(int index, size_t n) const {
+        // Each branch up the chain holds an earlier stretch of the path, so the last one with a snapshot
+        // past n in its stretch has the first
+        const Snapshot *found = nullptr;
+        for (size_t end = length(index); index >= 0 && end > n; index = branches[index].parent) {
+            const vector<Snapshot> &snapshots = branches[index].snapshots;
+            auto after = std::upper_bound(snapshots.begin(), snapshots.end(), n,
+                                          [](size_t n, const Snapshot &snapshot) { return n < snapshot.depth; });
+            if (after != snapshots.end() && after->depth <= end) { found = &*after; }
+            end = std::min(end, branches[index].fork);
+        }
+        return found;
+    }
+
+    /// @brief Number of moves two paths (the first lengthA moves of a, lengthB of b) have in common
+    size_t commonDepth(int a, size_t lengthA, int b, size_t lengthB) const {
+        // How far b's path follows each of its ancestors; the first of a's ancestors in it is where they meet
+        vector<size_t> reach(branches.size(), SIZE_MAX);
+        for (size_t n = lengthB; b >= 0; b = branches[b].parent) {
+            reach[b] = n;
+            n = std::min(n, branches[b].fork);
+        }
+        for (size_t n = lengthA; a >= 0; a = branches[a].parent) {
+            if (reach[a] != SIZE_MAX) { return std::min(n, reach[a]); }
+            n = std::min(n, branches[a].fork);
+        }
+        return 0;
+    }
+};
+
+#endif //GRAPHICS_MOVEHISTORY_H
@@ -0,0 +1,324 @@
+#include "puzzlePack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+/// @brief Largest board side a pack may hold (same as the game's)
+const uint32_t MAX_PACK_SIDE = 8192;
+
+/// @brief Bytes of padding after the bit stream, so every record can be read with 64-bit loads
+const size_t PADDING = 8;
+
+size_t streamBytes(uint64_t count, uint32_t recordBits) {
+    return static_cast<size_t>((count * recordBits + 7) / 8) + PADDING;
+}
+
+/// @brief Reads n bits (at most 57) starting at a bit offset
+uint64_t readBits(const uint8_t *stream, uint64_t bit, int n) {
+    uint64_t word;
+    memcpy(&word, stream + (bit >> 3), sizeof(word));
+    word >>= bit & 7;
+    return n == 64 ? word : word & ((uint64_t(1) << n) - 1);
+}
+
+/// @brief Writes the low n bits of value starting at a bit offset, a byte at a time
+void writeBits(uint8_t *stream, uint64_t bit, uint64_t value, int n) {
+    while (n > 0) {
+        int shift = static_cast<int>(bit & 7), take = std::min(8 - shift, n);
+        uint8_t mask = static_cast<uint8_t>(((1u << take) - 1) << shift);
+        uint8_t &byte = stream[bit >> 3];
+        byte = static_cast<uint8_t>((byte & ~mask) | ((value << shift) & mask));
+        value >>= take;
+        bit += take;
+        n -= take;
+    }
+}
+}
+
+// --------------------------------------------------------
+// PuzzlePack
+// --------------------------------------------------------
+
+PuzzlePack::~PuzzlePack() {
+    close();
+}
+
+bool PuzzlePack::open(const std::string &path) {
+    close();
+#ifdef _WIN32
+    file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "ERROR::PACK: Could not open " << path << std::endl;
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    size = static_cast<size_t>(ftell(file));
+    headerBytes.resize(sizeof(PackHeader));
+    readAt(0, headerBytes.data(), headerBytes.size());
+    data = headerBytes.data();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info {};
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        std::cout << "ERROR::PACK: Could not open " << path << std::endl;
+        if (fd >= 0) { ::close(fd); }
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void *mapped = size >= sizeof(PackHeader) ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cout << "ERROR::PACK: Could not map " << path << std::endl;
+        return false;
+    }
+    // Level select jumps around the pack; read-ahead would only pull in puzzles nobody asked for
+    madvise(mapped, size, MADV_RANDOM);
+    data = static_cast<const uint8_t *>(mapped);
+#endif
+
+    memcpy(&header, data, sizeof(header));
+    bool valid = size >= sizeof(PackHeader) && header.magic == PACK_MAGIC && header.version == PACK_VERSION
+                 && header.width >= 1 && header.width <= MAX_PACK_SIDE
+                 && header.height >= 1 && header.height <= MAX_PACK_SIDE
+                 && (header.flags & ~PACK_PAR) == 0
+                 && header.recordBits == header.width * header.height
+                 && header.count <= size * uint64_t(8)
+                 && header.dataOffset <= size && header.dataBytes <= size - header.dataOffset
+                 && header.dataBytes >= streamBytes(header.count, header.recordBits);
+    if (valid && (header.flags & PACK_PAR)) {
+        valid = header.indexOffset <= size && header.count <= size - header.indexOffset;
+    }
+    if (!valid) {
+        std::cout << "ERROR::PACK: " << path << " is not a valid puzzle pack" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PuzzlePack::close() {
+#ifdef _WIN32
+    if (file) { fclose(file); }
+    file = nullptr;
+#else
+    if (data) { munmap(const_cast<uint8_t *>(data), size); }
+#endif
+    data = nullptr;
+    size = 0;
+    header = PackHeader{};
+}
+
+Board PuzzlePack::get(size_t index) const {
+    Board board(getWidth(), getHeight());
+    get(index, board);
+    return board;
+}
+
+void PuzzlePack::get(size_t index, Board &board) const {
+    const int width = getWidth(), height = getHeight();
+    if (index >= getCount()) {
+        board.fill(false);
+        return;
+    }
+
+    const uint64_t first = static_cast<uint64_t>(index) * header.recordBits;
+#ifdef _WIN32
+    vector<uint8_t> record((header.recordBits + 7) / 8 + 1 + PADDING);
+    readAt(header.dataOffset + (first >> 3), record.data(), record.size());
+    const uint8_t *stream = record.data();
+    uint64_t bit = first & 7;
+#else
+    const uint8_t *stream = data + header.dataOffset;
+    uint64_t bit = first;
+#endif
+
+    // Rows are stored back to back, so each word of a row is one or two reads
+    for (int y = 0; y < height; y++) {
+        uint64_t *words = board.row(y);
+        for (int w = 0; w < board.getStride(); w++) {
+            int n = std::min(64, width - w * 64);
+            int low = std::min(n, 32);
+            uint64_t value = readBits(stream, bit, low);
+            if (n > low) { value |= readBits(stream, bit + low, n - low) << low; }
+            words[w] = value;
+            bit += n;
+        }
+    }
+}
+
+int PuzzlePack::getPar(size_t index) const {
+    if (!(header.flags & PACK_PAR) || index >= getCount()) { return -1; }
+#ifdef _WIN32
+    uint8_t par = 0;
+    readAt(header.indexOffset + index, &par, 1);
+    return par;
+#else
+    return data[header.indexOffset + index];
+#endif
+}
+
+#ifdef _WIN32
+void PuzzlePack::readAt(uint64_t offset, void *out, size_t bytes) const {
+    memset(out, 0, bytes);
+    if (offset >= size) { return; }
+    _fseeki64(file, static_cast<long long>(offset), SEEK_SET);
+    fread(out, 1, std::min<uint64_t>(bytes, size - offset), file);
+}
+#endif
+
+// --------------------------------------------------------
+// PuzzlePackWriter
+// --------------------------------------------------------
+
+PuzzlePackWriter::PuzzlePackWriter(int width, int height, size_t count, uint32_t flags) {
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.count = count;
+    header.flags = flags;
+    header.recordBits = static_cast<uint32_t>(width * height);
+
+    if (flags & PACK_PAR) { index.resize(count); }
+    bits.resize(streamBytes(count, header.recordBits));
+    header.indexOffset = flags & PACK_PAR ? sizeof(PackHeader) : 0;
+    header.dataOffset = sizeof(PackHeader) + index.size();
+    header.dataBytes = bits.size();
+}
+
+void PuzzlePackWriter::set(size_t i, const Board &puzzle, int par) {
+    const int width = puzzle.getWidth();
+    uint64_t bit = static_cast<uint64_t>(i) * header.recordBits;
+    for (int y = 0; y < puzzle.getHeight(); y++) {
+        const uint64_t *words = puzzle.row(y);
+        for (int w = 0; w < puzzle.getStride(); w++) {
+            int n = std::min(64, width - w * 64);
+            writeBits(bits.data(), bit, words[w], n);
+            bit += n;
+        }
+    }
+    if (header.flags & PACK_PAR) { index[i] = static_cast<uint8_t>(std::clamp(par, 0, 255)); }
+}
+
+bool PuzzlePackWriter::save(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::PACK: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+              && (index.empty() || fwrite(index.data(), 1, index.size(), file) == index.size())
+              && fwrite(bits.data(), 1, bits.size(), file) == bits.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok) { std::cout << "ERROR::PACK: Could not write " << path << std::endl; }
+    return ok;
+}
+
+// --------------------------------------------------------
+// PuzzlePackStreamWriter
+// --------------------------------------------------------
+
+namespace {
+/// @brief Bytes collected before they are written to the file
+const size_t STREAM_BUFFER_BYTES = 1 << 16;
+}
+
+PuzzlePackStreamWriter::~PuzzlePackStreamWriter() {
+    if (file) { fclose(file); }
+    if (pars) { fclose(pars); }
+}
+
+bool PuzzlePackStreamWriter::open(const std::string &path, int width, int height, uint32_t flags) {
+    header = PackHeader{};
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.flags = flags;
+    header.recordBits = static_cast<uint32_t>(width * height);
+    header.dataOffset = sizeof(PackHeader);
+    pending = 0;
+    pendingBits = 0;
+    failed = false;
+    buffer.clear();
+    buffer.reserve(STREAM_BUFFER_BYTES);
+
+    // The header is written last; until then the magic is zero, so an unfinished pack won't open
+    PackHeader placeholder{};
+    file = fopen(path.c_str(), "wb");
+    pars = flags & PACK_PAR ? tmpfile() : nullptr;
+    if (!file || ((flags & PACK_PAR) && !pars) || fwrite(&placeholder, sizeof(placeholder), 1, file) != 1) {
+        std::cout << "ERROR::PACK: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void PuzzlePackStreamWriter::putBits(uint64_t value, int bits) {
+    pending |= value << pendingBits;
+    if (pendingBits + bits < 64) {
+        pendingBits += bits;
+        return;
+    }
+    for (int ii = 0; ii < 8; ii++) { buffer.push_back(static_cast<uint8_t>(pending >> (8 * ii))); }
+    pending = pendingBits ? value >> (64 - pendingBits) : 0;
+    pendingBits += bits - 64;
+    if (buffer.size() >= STREAM_BUFFER_BYTES) { flush(); }
+}
+
+void PuzzlePackStreamWriter::flush() {
+    failed = fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || failed;
+    header.dataBytes += buffer.size();
+    buffer.clear();
+}
+
+void PuzzlePackStreamWriter::add(const Board &puzzle, int par) {
+    const int width = puzzle.getWidth();
+    for (int y = 0; y < puzzle.getHeight(); y++) {
+        const uint64_t *words = puzzle.row(y);
+        for (int w = 0; w < puzzle.getStride(); w++) { putBits(words[w], std::min(64, width - w * 64)); }
+    }
+    if (pars) { failed = fputc(std::clamp(par, 0, 255), pars) == EOF || failed; }
+    header.count++;
+}
+
+bool PuzzlePackStreamWriter::finish() {
+    if (!file) { return false; }
+    // The last partial word, then the padding
+    for (int ii = 0; ii * 8 < pendingBits; ii++) { buffer.push_back(static_cast<uint8_t>(pending >> (8 * ii))); }
+    buffer.insert(buffer.end(), PADDING, 0);
+    flush();
+    pending = 0;
+    pendingBits = 0;
+
+    bool ok = !failed;
+    if (pars) {
+        header.indexOffset = header.dataOffset + header.dataBytes;
+        ok = fflush(pars) == 0 && ok;
+        rewind(pars);
+        uint8_t chunk[STREAM_BUFFER_BYTES];
+        uint64_t copied = 0;
+        for (size_t read; (read = fread(chunk, 1, sizeof(chunk), pars)) > 0; copied += read) {
+            ok = fwrite(chunk, 1, read, file) == read && ok;
+        }
+        ok = !ferror(pars) && copied == header.count && ok;
+        fclose(pars);
+        pars = nullptr;
+    }
+    // Without the header the pack won't open, so a short write anywhere leaves it unusable rather than truncated
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) { std::cout << "ERROR::PACK: Could not write the pack" << std::endl; }
+    return ok;
+}
@@ -0,0 +1,172 @@
+#ifndef GRAPHICS_PUZZLEPACK_H
+#define GRAPHICS_PUZZLEPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "board.h"
+
+using std::vector;
+
+/**
+ * @brief Layout of a puzzle pack file (.lop).
+ * @details A 64-byte header, then the index (one byte per puzzle: the fewest presses that solve it, if
+ * PACK_PAR is set) and the puzzles, at the offsets the header gives (PuzzlePackWriter puts the index first,
+ * PuzzlePackStreamWriter last). The puzzles are one bit stream: puzzle i is the recordBits bits starting at bit
+ * i * recordBits, lights in row order (bit y * width + x). The bit stream is followed by 8 zero bytes so
+ * any record can be read with whole 64-bit loads. A 7x7 puzzle takes 49 bits, plus a byte of par:
+ * 10 million of them fit in 71 MB. Rotations and reflections of a puzzle are left to packtool dedup
+ * (see symmetry.h) rather than stored per record, which would only add bits.
+ */
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width, height;
+    uint64_t count;
+    uint32_t recordBits;
+    uint32_t flags;
+    uint64_t indexOffset;   // 0 without PACK_PAR
+    uint64_t dataOffset;
+    uint64_t dataBytes;     // Including the 8 bytes of padding
+    uint64_t reserved;
+};
+
+const uint32_t PACK_MAGIC = 0x4b504f4c; // "LOPK"
+const uint32_t PACK_VERSION = 1;
+const uint32_t PACK_PAR = 1;            // The index holds each puzzle's par
+
+/**
+ * @brief Read-only access to a puzzle pack.
+ * @details The file is memory-mapped, so opening it only reads the header, and get() only touches
+ * the pages that hold the one puzzle (and its index byte). Safe to read from several threads.
+ */
+class PuzzlePack {
+public:
+    PuzzlePack() = default;
+    ~PuzzlePack();
+
+    PuzzlePack(const PuzzlePack &) = delete;
+    PuzzlePack &operator=(const PuzzlePack &) = delete;
+
+    /// @brief Opens a pack (closing any open one)
+    /// @return false if the file can't be opened or isn't a valid pack
+    bool open(const std::string &path);
+
+    void close();
+
+    /// @brief Decodes puzzle i (0 to getCount() - 1)
+    Board get(size_t index) const;
+
+    /// @brief Same, into a board of the pack's size (reusing its storage)
+    void get(size_t index, Board &board) const;
+
+    /// @brief Fewest presses that solve puzzle i, or -1 if the pack has no index
+    int getPar(size_t index) const;
+
+    bool isOpen() const      { return data != nullptr; }
+    size_t getCount() const  { return isOpen() ? header.count : 0; }
+    int getWidth() const     { return static_cast<int>(header.width); }
+    int getHeight() const    { return static_cast<int>(header.height); }
+    uint32_t getFlags() const { return header.flags; }
+
+private:
+    PackHeader header{};
+    /// @brief The whole file (mapped), or just the header (if mapping isn't available)
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    /// @brief Without mmap, records are read from the file on demand
+    mutable FILE *file = nullptr;
+    vector<uint8_t> headerBytes;
+
+    /// @brief Reads bytes at an offset of the file (zero-filled past its end)
+    void readAt(uint64_t offset, void *out, size_t bytes) const;
+#endif
+};
+
+/**
+ * @brief Builds a puzzle pack in memory and saves it.
+ * @details Records are written into one preallocated bit stream, so set() can be called from several
+ * threads as long as each one writes whole bytes: give each thread a range of indexes starting at a
+ * multiple of 8 (8 records always end on a byte boundary).
+ */
+class PuzzlePackWriter {
+public:
+    /**
+     * @param width Number of columns of every puzzle
+     * @param height Number of rows of every puzzle
+     * @param count Number of puzzles
+     * @param flags PACK_PAR or 0
+     */
+    PuzzlePackWriter(int width, int height, size_t count, uint32_t flags);
+
+    /**
+     * @brief Stores puzzle i
+     *
+     * @param index 0 to count - 1
+     * @param puzzle The board
+     * @param par Fewest presses that solve it (capped at 255; ignored without PACK_PAR)
+     */
+    void set(size_t index, const Board &puzzle, int par = 0);
+
+    /// @brief Writes the pack to a file
+    bool save(const std::string &path) const;
+
+    /// @brief Size of the file save() writes
+    size_t getFileSize() const { return sizeof(PackHeader) + index.size() + bits.size(); }
+
+private:
+    PackHeader header{};
+    vector<uint8_t> index;
+    vector<uint8_t> bits;
+};
+
+/**
+ * @brief Writes a puzzle pack one puzzle at a time, for packs too big to build in memory.
+ * @details Puzzles go straight to the file and pars to a temporary file, which finish() appends as the
+ * index before filling in the header. Only a small write buffer is kept in memory.
+ */
+class PuzzlePackStreamWriter {
+public:
+    PuzzlePackStreamWriter() = default;
+    /// @brief Closes the file; a pack that wasn't finished is left invalid
+    ~PuzzlePackStreamWriter();
+
+    PuzzlePackStreamWriter(const PuzzlePackStreamWriter &) = delete;
+    PuzzlePackStreamWriter &operator=(const PuzzlePackStreamWriter &) = delete;
+
+    /**
+     * @brief Creates the file
+     *
+     * @param path Where to write the pack
+     * @param width Number of columns of every puzzle
+     * @param height Number of rows of every puzzle
+     * @param flags PACK_PAR or 0
+     */
+    bool open(const std::string &path, int width, int height, uint32_t flags);
+
+    /// @brief Appends a puzzle (see PuzzlePackWriter::set)
+    void add(const Board &puzzle, int par = 0);
+
+    /// @brief Writes the padding, the index and the header, and closes the file
+    bool finish();
+
+    uint64_t getCount() const { return header.count; }
+
+private:
+    PackHeader header{};
+    FILE *file = nullptr;
+    FILE *pars = nullptr;
+    /// @brief Whole bytes waiting to be written, and the bits after them (the low pendingBits of pending)
+    vector<uint8_t> buffer;
+    uint64_t pending = 0;
+    int pendingBits = 0;
+    bool failed = false;
+
+    void putBits(uint64_t value, int bits);
+    void flush();
+};
+
+#endif //GRAPHICS_PUZZLEPACK_H
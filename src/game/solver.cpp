@@ -0,0 +1,145 @@
+#include "solver.h"
+
+#include <algorithm>
+#include <bitset>
+
+/// @brief Number of set bits in n words
+static size_t popcount(const uint64_t *words, size_t n) {
+    size_t count = 0;
+    for (size_t ii = 0; ii < n; ii++) {
+        count += std::bitset<64>(words[ii]).count();
+    }
+    return count;
+}
+
+Solver::Solver(int width, int height) : width(width), height(height), stride((width + 63) / 64) {
+    const size_t rowWords = stride, boardWords = static_cast<size_t>(stride) * height;
+    vector<uint64_t> lights(boardWords), unit(rowWords);
+
+    // Row i of the map holds, for every first-row press j, whether it leaves light i of the last row on
+    reduced.assign(width * rowWords, 0);
+    for (int j = 0; j < width; j++) {
+        std::fill(unit.begin(), unit.end(), 0);
+        unit[j >> 6] = uint64_t(1) << (j & 63);
+        chase(nullptr, unit.data(), lights.data(), nullptr);
+        const uint64_t *residue = &lights[(height - 1) * rowWords];
+        for (int i = 0; i < width; i++) {
+            if ((residue[i >> 6] >> (i & 63)) & 1) {
+                reduced[i * rowWords + (j >> 6)] |= uint64_t(1) << (j & 63);
+            }
+        }
+    }
+
+    // Gauss-Jordan elimination, repeating every row operation on an identity matrix
+    transform.assign(width * rowWords, 0);
+    for (int i = 0; i < width; i++) {
+        transform[i * rowWords + (i >> 6)] |= uint64_t(1) << (i & 63);
+    }
+    auto bit = [&](const vector<uint64_t> &m, int r, int c) { return (m[r * rowWords + (c >> 6)] >> (c & 63)) & 1; };
+    auto addRow = [&](vector<uint64_t> &m, int to, int from) {
+        for (size_t w = 0; w < rowWords; w++) { m[to * rowWords + w] ^= m[from * rowWords + w]; }
+    };
+    auto swapRows = [&](vector<uint64_t> &m, int a, int b) {
+        std::swap_ranges(m.begin() + a * rowWords, m.begin() + (a + 1) * rowWords, m.begin() + b * rowWords);
+    };
+    for (int col = 0; col < width && rank < width; col++) {
+        int pivot = rank;
+        while (pivot < width && !bit(reduced, pivot, col)) { pivot++; }
+        if (pivot == width) { continue; }
+        swapRows(reduced, pivot, rank);
+        swapRows(transform, pivot, rank);
+        for (int r = 0; r < width; r++) {
+            if (r != rank && bit(reduced, r, col)) {
+                addRow(reduced, r, rank);
+                addRow(transform, r, rank);
+            }
+        }
+        pivots.push_back(col);
+        rank++;
+    }
+
+    // One null space vector per free column: the free press, plus the pivot presses that cancel it
+    if (getNullity() <= MAX_SEARCHED_NULLITY) {
+        vector<uint64_t> firstRow(rowWords);
+        nullPresses.resize(getNullity() * boardWords);
+        int found = 0;
+        for (int col = 0, p = 0; col < width; col++) {
+            if (p < rank && pivots[p] == col) { p++; continue; }
+            std::fill(firstRow.begin(), firstRow.end(), 0);
+            firstRow[col >> 6] |= uint64_t(1) << (col & 63);
+            for (int r = 0; r < rank; r++) {
+                if (bit(reduced, r, col)) { firstRow[pivots[r] >> 6] ^= uint64_t(1) << (pivots[r] & 63); }
+            }
+            chase(nullptr, firstRow.data(), lights.data(), &nullPresses[found++ * boardWords]);
+        }
+    }
+}
+
+void Solver::chase(const Board *board, const uint64_t *firstRow, uint64_t *lights, uint64_t *presses) const {
+    const size_t rowWords = stride, boardWords = static_cast<size_t>(stride) * height;
+    if (board) { std::copy(board->row(0), board->row(0) + boardWords, lights); }
+    else { std::fill(lights, lights + boardWords, 0); }
+
+    const uint64_t lastMask = (width & 63) ? (uint64_t(1) << (width & 63)) - 1 : ~uint64_t(0);
+    for (int y = 0; y < height; y++) {
+        // Row 0 gets the chosen presses, every later row presses exactly the lights left on above it
+        uint64_t *row = lights + y * rowWords;
+        for (size_t w = 0; w < rowWords; w++) {
+            uint64_t press = y == 0 ? firstRow[w] : row[w - rowWords];
+            if (presses) { presses[y * rowWords + w] = press; }
+            if (!press) { continue; }
+
+            // A press toggles itself and its left and right neighbors (carrying across words)...
+            row[w] ^= press ^ (press << 1) ^ (press >> 1);
+            if (w > 0)            { row[w - 1] ^= press << 63; }
+            if (w + 1 < rowWords) { row[w + 1] ^= press >> 63; }
+
+            // ...and the lights above and below it
+            if (y > 0)          { row[w - rowWords] ^= press; }
+            if (y < height - 1) { row[w + rowWords] ^= press; }
+        }
+        row[rowWords - 1] &= lastMask;
+    }
+}
+
+bool Solver::solve(const Board &board, Board &presses, bool fewest) const {
+    const size_t rowWords = stride, boardWords = static_cast<size_t>(stride) * height;
+    vector<uint64_t> lights(boardWords), firstRow(rowWords, 0), pattern(boardWords);
+
+    // Whatever the plain chase leaves on the last row has to be cancelled by the first-row presses
+    chase(&board, firstRow.data(), lights.data(), nullptr);
+    const uint64_t *residue = &lights[(height - 1) * rowWords];
+    for (int r = 0; r < width; r++) {
+        uint64_t parity = 0;
+        for (size_t w = 0; w < rowWords; w++) { parity ^= transform[r * rowWords + w] & residue[w]; }
+        bool value = std::bitset<64>(parity).count() & 1;
+        if (r >= rank) {
+            if (value) { return false; }
+        } else if (value) {
+            firstRow[pivots[r] >> 6] |= uint64_t(1) << (pivots[r] & 63);
+        }
+    }
+    chase(&board, firstRow.data(), lights.data(), pattern.data());
+
+    // Walk every combination of null space vectors in Gray code order (one XOR per step), keeping the shortest
+    const int nullity = getNullity();
+    if (fewest && nullity > 0 && !nullPresses.empty()) {
+        vector<uint64_t> current = pattern;
+        size_t best = popcount(pattern.data(), boardWords);
+        for (uint32_t step = 1; step < (uint32_t(1) << nullity); step++) {
+            int flip = 0;
+            while (!((step >> flip) & 1)) { flip++; }
+            const uint64_t *nullVector = &nullPresses[flip * boardWords];
+            for (size_t w = 0; w < boardWords; w++) { current[w] ^= nullVector[w]; }
+            size_t count = popcount(current.data(), boardWords);
+            if (count < best) {
+                best = count;
+                pattern = current;
+            }
+        }
+    }
+
+    presses = Board(width, height);
+    std::copy(pattern.begin(), pattern.end(), presses.row(0));
+    return true;
+}
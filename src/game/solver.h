@@ -0,0 +1,71 @@
+#ifndef GRAPHICS_SOLVER_H
+#define GRAPHICS_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "board.h"
+
+using std::vector;
+
+/**
+ * @brief Finds which lights to press to turn a board off.
+ * @details Light chasing: once the first row of presses is chosen, every later row is forced (press
+ * under each light still on in the row above), and what is left on the last row depends linearly
+ * (over GF(2)) on the first row. The constructor works out that linear map for the board size and
+ * reduces it once with Gaussian elimination, so each solve is two chases plus a matrix-vector product.
+ *
+ * Some sizes (5x5 among them) have boards that can't be solved, and solvable boards have more than
+ * one solution; the null space of the map tells them apart and lets solve() pick the shortest.
+ */
+class Solver {
+public:
+    /// @brief Prepares the solver for boards of one size
+    /// @param width Number of columns
+    /// @param height Number of rows
+    Solver(int width, int height);
+
+    /**
+     * @brief Solves a board
+     *
+     * @param board The board (must have the size given to the constructor)
+     * @param presses Receives the lights to press, one bit per light (lit = press); order doesn't matter
+     * @param fewest Search the null space for the solution with the fewest presses (only if it is small)
+     * @return false if the board can't be turned off
+     */
+    bool solve(const Board &board, Board &presses, bool fewest = true) const;
+
+    /// @brief Returns the dimension of the null space: 2^nullity patterns leave every board unchanged
+    int getNullity() const { return width - rank; }
+
+    int getWidth() const  { return width; }
+    int getHeight() const { return height; }
+
+private:
+    /// @brief solve() only searches null spaces this small (2^nullity candidate solutions)
+    static const int MAX_SEARCHED_NULLITY = 16;
+
+    int width, height, stride;
+
+    /// @brief Eliminated map from first-row presses to last-row residue: width rows of stride words each
+    vector<uint64_t> reduced;
+    /// @brief Row operations of the elimination, applied to a residue to solve for the first row
+    vector<uint64_t> transform;
+    /// @brief Column of the pivot of each of the first rank rows
+    vector<int> pivots;
+    int rank = 0;
+
+    /// @brief Full press patterns (height * stride words each) that change nothing, one per null space dimension
+    vector<uint64_t> nullPresses;
+
+    /**
+     * @brief Presses firstRow on the first row, then chases the lights down
+     *
+     * @param board Starting lights, or nullptr for all off
+     * @param firstRow stride words of first-row presses
+     * @param lights Scratch of height * stride words; receives the lights left on (only the last row can be lit)
+     * @param presses If not null, receives the presses of every row (height * stride words)
+     */
+    void chase(const Board *board, const uint64_t *firstRow, uint64_t *lights, uint64_t *presses) const;
+};
+
+#endif //GRAPHICS_SOLVER_H
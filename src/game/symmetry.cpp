@@ -0,0 +1,199 @@
+#include "symmetry.h"
+
+#include <algorithm>
+
+namespace {
+
+/// @brief Transposes an 8x8 block held as byte r = row r, bit c = column c
+uint64_t transposeBlock(uint64_t x) {
+    uint64_t t = 0x0f0f0f0f00000000ULL & (x ^ (x << 28));
+    x ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (x ^ (x << 14));
+    x ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (x ^ (x << 7));
+    x ^= t ^ (t >> 7);
+    return x;
+}
+
+/// @brief Transposes an 8x8 block about the other diagonal (the transpose of a packed small board)
+uint64_t transposeAntiBlock(uint64_t x) {
+    uint64_t t = x ^ (x << 36);
+    x ^= 0xf0f0f0f00f0f0f0fULL & (t ^ (x >> 36));
+    t = 0xcccc0000cccc0000ULL & (x ^ (x << 18));
+    x ^= t ^ (t >> 18);
+    t = 0xaa00aa00aa00aa00ULL & (x ^ (x << 9));
+    x ^= t ^ (t >> 9);
+    return x;
+}
+
+/// @brief Reverses the bits of each byte
+uint64_t reverseByteBits(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    return x;
+}
+
+/// @brief Reverses the order of the bytes
+uint64_t reverseBytes(uint64_t x) {
+    x = ((x >> 8) & 0x00ff00ff00ff00ffULL) | ((x & 0x00ff00ff00ff00ffULL) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffffULL) | ((x & 0x0000ffff0000ffffULL) << 16);
+    return x >> 32 | x << 32;
+}
+
+// Packed small boards: the lights sit in the high bytes (rows) and low bits (columns)
+uint64_t mirrorSmallX(uint64_t bits, int width)  { return reverseByteBits(bits) >> (SMALL_BOARD_SIDE - width); }
+uint64_t mirrorSmallY(uint64_t bits, int height) { return reverseBytes(bits) << 8 * (SMALL_BOARD_SIDE - height); }
+
+/// @brief Returns the transpose of a board (HxW for a WxH board), an 8x8 block at a time
+Board transposeBoard(const Board &board) {
+    const int width = board.getWidth(), height = board.getHeight();
+    Board image(height, width);
+    image.fill(false);
+    for (int by = 0; by < height; by += 8) {
+        for (int bx = 0; bx < width; bx += 8) {
+            // Byte bx / 8 of rows by to by + 7 (rows past the end read as empty)
+            uint64_t block = 0;
+            for (int r = 0; r < 8 && by + r < height; r++) {
+                block |= ((board.row(by + r)[bx >> 6] >> (bx & 63)) & 0xff) << (8 * r);
+            }
+            block = transposeBlock(block);
+            for (int c = 0; c < 8 && bx + c < width; c++) {
+                image.row(bx + c)[by >> 6] |= ((block >> (8 * c)) & 0xff) << (by & 63);
+            }
+        }
+    }
+    return image;
+}
+
+/// @brief Mirrors the columns of a row in place: reverse the words and their bits, then shift out the padding
+void mirrorRow(uint64_t *row, vector<uint64_t> &scratch, int width) {
+    const size_t words = scratch.size();
+    for (size_t w = 0; w < words; w++) {
+        scratch[w] = reverseBytes(reverseByteBits(row[words - 1 - w]));
+    }
+    const int shift = static_cast<int>(words * 64 - width);
+    for (size_t w = 0; w < words; w++) {
+        row[w] = shift ? scratch[w] >> shift | (w + 1 < words ? scratch[w + 1] << (64 - shift) : 0) : scratch[w];
+    }
+}
+
+} // namespace
+
+Board transformBoard(const Board &board, int symmetry) {
+    const bool transpose = symmetry & SYMMETRY_TRANSPOSE;
+    const int width = board.getWidth(), height = board.getHeight();
+    if (isSmallBoard(width, height)) {
+        Board image(transpose ? height : width, transpose ? width : height);
+        unpackSmallBoard(transformSmallBoard(packSmallBoard(board), width, height, symmetry), image);
+        return image;
+    }
+
+    Board image = transpose ? transposeBoard(board) : board;
+    if (symmetry & SYMMETRY_MIRROR_X) {
+        vector<uint64_t> scratch(image.getStride());
+        for (int y = 0; y < image.getHeight(); y++) { mirrorRow(image.row(y), scratch, image.getWidth()); }
+    }
+    if (symmetry & SYMMETRY_MIRROR_Y) {
+        for (int y = 0, other = image.getHeight() - 1; y < other; y++, other--) {
+            std::swap_ranges(image.row(y), image.row(y) + image.getStride(), image.row(other));
+        }
+    }
+    return image;
+}
+
+int canonicalizeBoard(const Board &board, Board &canonical) {
+    const int width = board.getWidth(), height = board.getHeight();
+    if (isSmallBoard(width, height)) {
+        int symmetry;
+        canonical = Board(width, height);
+        unpackSmallBoard(canonicalizeSmallBoard(packSmallBoard(board), width, height, &symmetry), canonical);
+        return symmetry;
+    }
+
+    const size_t words = static_cast<size_t>(board.getStride()) * height;
+    auto less = [words](const Board &a, const Board &b) {
+        return std::lexicographical_compare(a.row(0), a.row(0) + words, b.row(0), b.row(0) + words);
+    };
+    canonical = board;
+    int best = 0;
+    for (int s = 1; s < symmetryCount(width, height); s++) {
+        Board image = transformBoard(board, s);
+        if (less(image, canonical)) {
+            canonical = image;
+            best = s;
+        }
+    }
+    return inverseSymmetry(best);
+}
+
+uint64_t packSmallBoard(const Board &board) {
+    uint64_t bits = 0;
+    for (int y = 0; y < board.getHeight(); y++) {
+        bits |= board.row(y)[0] << 8 * (SMALL_BOARD_SIDE - 1 - y);
+    }
+    return bits;
+}
+
+void unpackSmallBoard(uint64_t bits, Board &board) {
+    for (int y = 0; y < board.getHeight(); y++) {
+        board.row(y)[0] = (bits >> 8 * (SMALL_BOARD_SIDE - 1 - y)) & 0xff;
+    }
+}
+
+uint64_t transformSmallBoard(uint64_t bits, int width, int height, int symmetry) {
+    if (symmetry & SYMMETRY_TRANSPOSE) {
+        // Lights stay in the top left corner, so the board just becomes HxW
+        bits = transposeAntiBlock(bits);
+        std::swap(width, height);
+    }
+    if (symmetry & SYMMETRY_MIRROR_X) { bits = mirrorSmallX(bits, width); }
+    if (symmetry & SYMMETRY_MIRROR_Y) { bits = mirrorSmallY(bits, height); }
+    return bits;
+}
+
+uint64_t canonicalizeSmallBoard(uint64_t bits, int width, int height, int *symmetry) {
+    // Each image is one mirror away from an earlier one
+    uint64_t images[8];
+    images[0] = bits;
+    images[SYMMETRY_MIRROR_X] = mirrorSmallX(bits, width);
+    images[SYMMETRY_MIRROR_Y] = mirrorSmallY(bits, height);
+    images[SYMMETRY_MIRROR_X | SYMMETRY_MIRROR_Y] = mirrorSmallY(images[SYMMETRY_MIRROR_X], height);
+    const int count = symmetryCount(width, height);
+    if (count == 8) {
+        uint64_t transposed = transposeAntiBlock(bits);
+        images[SYMMETRY_TRANSPOSE] = transposed;
+        images[SYMMETRY_TRANSPOSE | SYMMETRY_MIRROR_X] = mirrorSmallX(transposed, height);
+        images[SYMMETRY_TRANSPOSE | SYMMETRY_MIRROR_Y] = mirrorSmallY(transposed, width);
+        images[7] = mirrorSmallY(images[SYMMETRY_TRANSPOSE | SYMMETRY_MIRROR_X], width);
+    }
+
+    int best = 0;
+    for (int s = 1; s < count; s++) {
+        if (images[s] < images[best]) { best = s; }
+    }
+    if (symmetry) { *symmetry = inverseSymmetry(best); }
+    return images[best];
+}
+
+uint64_t hashBoard(const Board &board) {
+    const int width = board.getWidth(), height = board.getHeight();
+    uint64_t hash = mixHash(static_cast<uint64_t>(width) << 32 | static_cast<uint32_t>(height));
+    if (isSmallBoard(width, height)) { return mixHash(hash ^ packSmallBoard(board)); }
+
+    for (int y = 0; y < height; y++) {
+        for (int w = 0; w < board.getStride(); w++) { hash = mixHash(hash ^ board.row(y)[w]); }
+    }
+    return hash;
+}
+
+uint64_t canonicalHash(const Board &board) {
+    const int width = board.getWidth(), height = board.getHeight();
+    if (isSmallBoard(width, height)) {
+        uint64_t hash = mixHash(static_cast<uint64_t>(width) << 32 | static_cast<uint32_t>(height));
+        return mixHash(hash ^ canonicalizeSmallBoard(packSmallBoard(board), width, height));
+    }
+    Board canonical;
+    canonicalizeBoard(board, canonical);
+    return hashBoard(canonical);
+}
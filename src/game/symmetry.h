@@ -0,0 +1,89 @@
+#ifndef GRAPHICS_SYMMETRY_H
+#define GRAPHICS_SYMMETRY_H
+
+#include <cstdint>
+#include "board.h"
+
+// A symmetry is three bits, applied in this order: SYMMETRY_TRANSPOSE swaps x and y (the image of a WxH
+// board is HxW), SYMMETRY_MIRROR_X mirrors the columns, SYMMETRY_MIRROR_Y mirrors the rows. Together they
+// give the 8 rotations and reflections of a square board; a rectangular one keeps its shape under 4 of
+// them. The rules look the same from every one, so a board and its images take the same number of moves.
+const int SYMMETRY_MIRROR_X = 1;
+const int SYMMETRY_MIRROR_Y = 2;
+const int SYMMETRY_TRANSPOSE = 4;
+
+/// @brief Number of symmetries that keep a board's shape (symmetries 0 to count - 1)
+inline int symmetryCount(int width, int height) { return width == height ? 8 : 4; }
+
+/// @brief The symmetry that undoes another one
+inline int inverseSymmetry(int symmetry) {
+    // Mirroring x after a transpose is mirroring y before it
+    if (!(symmetry & SYMMETRY_TRANSPOSE)) { return symmetry; }
+    return SYMMETRY_TRANSPOSE | (symmetry & SYMMETRY_MIRROR_X ? SYMMETRY_MIRROR_Y : 0)
+                              | (symmetry & SYMMETRY_MIRROR_Y ? SYMMETRY_MIRROR_X : 0);
+}
+
+/**
+ * @brief Returns the image of a board under a symmetry
+ * @details Whole words at a time: rows are mirrored by reversing their bits, and transposed in 8x8 blocks
+ * with three masked swaps per block.
+ */
+Board transformBoard(const Board &board, int symmetry);
+
+/**
+ * @brief Finds the smallest image of a board (comparing its rows in order, each as a number)
+ * @details Boards that are images of each other get the same canonical board. Boards up to 8x8 are
+ * canonicalized as one word (see canonicalizeSmallBoard).
+ *
+ * @param board The board
+ * @param canonical Receives the smallest image
+ * @return The symmetry that turns canonical back into board
+ */
+int canonicalizeBoard(const Board &board, Board &canonical);
+
+// --------------------------------------------------------
+// Boards up to 8x8, as one word
+// --------------------------------------------------------
+
+/// @brief Boards this wide and tall fit in one word: row y is byte 7 - y, column x is bit x of it.
+/// Row 0 is the most significant byte, so comparing words compares the rows in order, like canonicalizeBoard.
+const int SMALL_BOARD_SIDE = 8;
+
+inline bool isSmallBoard(int width, int height) { return width <= SMALL_BOARD_SIDE && height <= SMALL_BOARD_SIDE; }
+
+uint64_t packSmallBoard(const Board &board);
+
+/// @brief Writes a packed board into a board of its size
+void unpackSmallBoard(uint64_t bits, Board &board);
+
+/// @brief transformBoard for a packed WxH board (a handful of shifts and masks)
+uint64_t transformSmallBoard(uint64_t bits, int width, int height, int symmetry);
+
+/**
+ * @brief canonicalizeBoard for a packed board
+ * @param symmetry If not null, receives the symmetry that turns the result back into bits
+ * @return The smallest image
+ */
+uint64_t canonicalizeSmallBoard(uint64_t bits, int width, int height, int *symmetry = nullptr);
+
+// --------------------------------------------------------
+// Hashing
+// --------------------------------------------------------
+
+/// @brief 64-bit hash of a board's size and lights
+uint64_t hashBoard(const Board &board);
+
+/// @brief Hash of a board's canonical image: the same for a board and all its images
+uint64_t canonicalHash(const Board &board);
+
+/// @brief Scrambles the bits of a word (every input bit affects every output bit)
+inline uint64_t mixHash(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+#endif //GRAPHICS_SYMMETRY_H
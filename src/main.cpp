@@ -1,18 +1,156 @@
 #include "framework/engine.h"
+#include "game/puzzlePack.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
+using namespace std;
+
+/// @brief Largest board side accepted on the command line (the board texture has to fit in GL_MAX_TEXTURE_SIZE)
+const int MAX_BOARD_SIZE = 8192;
+
+/// @brief Opens the puzzle pack (if one was given) and starts the requested level (if any)
+/// @return false if the pack can't be used
+bool openLevels(Engine &engine, const char *packPath, long long level) {
+    if (!packPath) { return true; }
+    if (!engine.getGame().openPack(packPath)) { return false; }
+    if (level >= 0) { engine.getGame().startLevel(static_cast<size_t>(level)); }
+    return true;
+}
+
+/// @brief Renders frames offscreen, optionally saving the last one and comparing it to a golden image.
+/// @return The process exit code (1 if the frame doesn't match the golden image)
+int runOffscreen(int argc, char *argv[], int boardWidth, int boardHeight, int states, const char *packPath,
+                 long long level, const char *skinPath) {
+    int frames = 60, tolerance = 2;
+    const char *capturePath = nullptr, *goldenPath = nullptr, *recordPath = nullptr;
+    InputState input;
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--frames") && ii + 1 < argc)         { frames = atoi(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--capture") && ii + 1 < argc)   { capturePath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--golden") && ii + 1 < argc)    { goldenPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--tolerance") && ii + 1 < argc) { tolerance = atoi(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--record") && ii + 1 < argc)    { recordPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--play"))                       { input.keyStart = true; }
+    }
+
+    Engine engine(true, boardWidth, boardHeight, states);
+    if (!openLevels(engine, packPath, level)) { return 1; }
+    if (skinPath) {
+        engine.setSkin(skinPath);
+    }
+    if (recordPath) {
+        engine.record(recordPath);
+    }
+    double msPerFrame = engine.runOffscreen(frames, input);
+    cout << frames << " frames, " << msPerFrame << " ms per frame" << endl;
+    const GLState::Stats &glStats = GLState::get().getLastFrame();
+    cout << "GL state changes in the last frame: " << glStats.issued << " issued, " << glStats.skipped << " skipped" << endl;
+    cout << "Heap allocations in the last frame: " << engine.getFrameAllocations() << endl;
+    GLResources::get().printUsage();
+
+    Image frame = engine.captureFrame();
+    if (capturePath) {
+        saveImage(frame, capturePath);
+    }
+    if (goldenPath) {
+        Image golden;
+        if (!loadImage(golden, goldenPath)) { return 1; }
+        ImageDiff diff = diffImages(frame, golden, tolerance);
+        cout << "Golden image: " << (diff.sameSize ? "" : "size mismatch, ") << diff.differingPixels
+             << " differing pixels (max channel delta " << diff.maxChannelDelta << ")" << endl;
+        return diff.sameSize && diff.differingPixels == 0 ? 0 : 1;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
+    bool offscreen = false;
+    bool lowLatency = false;
+    const char *recordPath = nullptr;
+    const char *historyPath = nullptr;
+    const char *packPath = nullptr;
+    const char *skinPath = nullptr;
+    long long level = -1;
+    int boardWidth = 5, boardHeight = 5;
+    int states = 2;
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--offscreen"))                    { offscreen = true; }
+        else if (!strcmp(argv[ii], "--low-latency"))             { lowLatency = true; }
+        else if (!strcmp(argv[ii], "--record") && ii + 1 < argc) { recordPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--history") && ii + 1 < argc) { historyPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--pack") && ii + 1 < argc)   { packPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--skin") && ii + 1 < argc)   { skinPath = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--level") && ii + 1 < argc)  { level = max(1LL, atoll(argv[++ii])) - 1; }
+        else if (!strcmp(argv[ii], "--states") && ii + 1 < argc) {
+            // Number of states each light cycles through (3 is "Lights Out 2000"); one palette color per state
+            states = max(2, min(atoi(argv[++ii]), PALETTE_SIZE));
+        }
+        else if (!strcmp(argv[ii], "--board") && ii + 1 < argc)  {
+            // WxH, e.g. --board 8192x8192 (boards above 64x64 are drawn from a texture)
+            if (sscanf(argv[++ii], "%dx%d", &boardWidth, &boardHeight) != 2) {
+                cout << "Expected --board WxH, e.g. --board 1000x1000" << endl;
+                return 1;
+            }
+            boardWidth = max(1, min(boardWidth, MAX_BOARD_SIZE));
+            boardHeight = max(1, min(boardHeight, MAX_BOARD_SIZE));
+        }
+    }
+
+    // A puzzle pack decides the board: only its header is read here, the levels are read as they are shown
+    if (packPath) {
+        PuzzlePack pack;
+        if (!pack.open(packPath)) { return 1; }
+        boardWidth = pack.getWidth();
+        boardHeight = pack.getHeight();
+        states = 2;
+    }
+
+#ifdef GLFW_PLATFORM_NULL
+    // Display-less machines (CI): skip the windowing system entirely and render through OSMesa
+    if (offscreen && !getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY")) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
     glfwInit();
-    Engine engine;
 
-    while (!engine.shouldClose()) {
-        engine.processInput();
-        engine.update();
-        engine.render();
+    int result = 0;
+    if (offscreen) {
+        result = runOffscreen(argc, argv, boardWidth, boardHeight, states, packPath, level, skinPath);
+    } else {
+        // Input and simulation run on this thread; rendering runs on a thread started by the engine
+        Engine engine(false, boardWidth, boardHeight, states);
+        if (recordPath) {
+            engine.record(recordPath);
+        }
+        engine.setLowLatency(lowLatency);
+        if (skinPath) {
+            engine.setSkin(skinPath);
+        }
+        if (!openLevels(engine, packPath, level)) {
+            glfwTerminate();
+            return 1;
+        }
+
+        // Resume the moves saved by the last game on the same puzzle, and save them again on exit. A save from
+        // another puzzle isn't replayed here, nor overwritten by this game's moves on exit.
+        if (historyPath && filesystem::exists(historyPath) && !engine.getGame().loadHistory(historyPath)) {
+            cout << "ERROR::HISTORY: Start with the --board, --states, --pack and --level " << historyPath
+                 << " was saved with, or give another --history file" << endl;
+            glfwTerminate();
+            return 1;
+        }
+        engine.run();
+        if (historyPath) {
+            engine.getGame().saveHistory(historyPath);
+        }
     }
 
     glfwTerminate();
-    return 0;
-}
\ No newline at end of file
+    return result;
+}
@@ -0,0 +1,178 @@
+#include "particleSystem.h"
+#include "../shapes/circle.h"
+#include "../shapes/collision.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+ParticleSystem::ParticleSystem(vec2 bounds, unsigned int threads) : bounds(bounds) {
+    if (threads > 0) {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+}
+
+ParticleSystem::~ParticleSystem() = default;
+
+void ParticleSystem::add(vec2 pos, vec2 velocity, float radius, struct color color) {
+    positions.push_back(pos);
+    velocities.push_back(velocity);
+    radii.push_back(radius);
+    colors.push_back(packColor(color));
+    maxRadius = std::max(maxRadius, radius);
+}
+
+void ParticleSystem::add(const Circle &circle) {
+    add(circle.getPos(), circle.getVelocity(), circle.getRadius(), circle.getColor4());
+}
+
+void ParticleSystem::burst(vec2 origin, int count, float minSpeed, float maxSpeed, float radius,
+                           const vector<color> &palette) {
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * 3.1415926f);
+    std::uniform_real_distribution<float> speed(minSpeed, maxSpeed);
+    std::uniform_int_distribution<size_t> pick(0, palette.empty() ? 0 : palette.size() - 1);
+
+    size_t total = positions.size() + count;
+    positions.reserve(total);
+    velocities.reserve(total);
+    radii.reserve(total);
+    colors.reserve(total);
+
+    for (int ii = 0; ii < count; ii++) {
+        float theta = angle(rng);
+        float v = speed(rng);
+        add(origin, vec2(cosf(theta) * v, sinf(theta) * v), radius, palette.empty() ? color(1, 1, 1) : palette[pick(rng)]);
+    }
+}
+
+void ParticleSystem::clear() {
+    positions.clear();
+    velocities.clear();
+    radii.clear();
+    colors.clear();
+    maxRadius = 0;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    if (positions.empty()) { return; }
+
+    integrate(deltaTime);
+    buildGrid();
+
+    if (!pool || gridHeight < 4) {
+        pairTests = resolveRows(0, gridHeight);
+        return;
+    }
+
+    // Split the rows into bands. A band touches its own rows plus the first row of the next band,
+    // so all even bands can run at once, followed by all odd bands.
+    int bandCount = std::min<int>(gridHeight / 2, static_cast<int>(pool->size()) * 2);
+    int bandRows = (gridHeight + bandCount - 1) / bandCount;
+    bandCount = (gridHeight + bandRows - 1) / bandRows;
+
+    std::atomic<size_t> tests{0};
+    for (int parity = 0; parity < 2; parity++) {
+        size_t bandsThisPass = (bandCount - parity + 1) / 2;
+        pool->parallelFor(bandsThisPass, [&](size_t ii) {
+            int band = static_cast<int>(ii) * 2 + parity;
+            int firstRow = band * bandRows;
+            tests += resolveRows(firstRow, std::min(firstRow + bandRows, gridHeight));
+        });
+    }
+    pairTests = tests;
+}
+
+void ParticleSystem::integrate(float deltaTime) {
+    for (size_t ii = 0; ii < positions.size(); ii++) {
+        vec2 &pos = positions[ii];
+        vec2 &vel = velocities[ii];
+        float r = radii[ii];
+
+        vel += gravity * deltaTime;
+        pos += vel * deltaTime;
+
+        // Bounce off the walls, losing some speed each time
+        if (pos.x < r)            { pos.x = r;            vel.x = fabsf(vel.x) * restitution; }
+        if (pos.x > bounds.x - r) { pos.x = bounds.x - r; vel.x = -fabsf(vel.x) * restitution; }
+        if (pos.y < r)            { pos.y = r;            vel.y = fabsf(vel.y) * restitution; }
+        if (pos.y > bounds.y - r) { pos.y = bounds.y - r; vel.y = -fabsf(vel.y) * restitution; }
+    }
+}
+
+void ParticleSystem::buildGrid() {
+    // Cells are as wide as the largest particle, so touching particles are always in neighboring cells
+    cellSize = std::max(2.0f * maxRadius, 1.0f);
+    gridWidth = std::max(1, static_cast<int>(ceilf(bounds.x / cellSize)));
+    gridHeight = std::max(1, static_cast<int>(ceilf(bounds.y / cellSize)));
+    size_t cellCount = static_cast<size_t>(gridWidth) * gridHeight;
+
+    // Counting sort: count particles per cell, prefix-sum into start offsets, then scatter
+    cellStart.assign(cellCount + 1, 0);
+    particleCells.resize(positions.size());
+    for (size_t ii = 0; ii < positions.size(); ii++) {
+        int cx = std::clamp(static_cast<int>(positions[ii].x / cellSize), 0, gridWidth - 1);
+        int cy = std::clamp(static_cast<int>(positions[ii].y / cellSize), 0, gridHeight - 1);
+        particleCells[ii] = static_cast<uint32_t>(cy * gridWidth + cx);
+        cellStart[particleCells[ii] + 1]++;
+    }
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    cellParticles.resize(positions.size());
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t ii = 0; ii < positions.size(); ii++) {
+        cellParticles[cellCursor[particleCells[ii]]++] = static_cast<uint32_t>(ii);
+    }
+
+    // Store the particles in cell order, so the narrow phase walks each cell's particles contiguously
+    reorder(positions, scratchVec2);
+    reorder(velocities, scratchVec2);
+    reorder(radii, scratchFloat);
+    reorder(colors, scratchColor);
+}
+
+template <typename T>
+void ParticleSystem::reorder(vector<T> &values, vector<T> &scratch) const {
+    scratch.resize(values.size());
+    for (size_t ii = 0; ii < values.size(); ii++) {
+        scratch[ii] = values[cellParticles[ii]];
+    }
+    values.swap(scratch);
+}
+
+size_t ParticleSystem::resolveRows(int firstRow, int lastRow) {
+    size_t tests = 0;
+    for (int cy = firstRow; cy < lastRow; cy++) {
+        for (int cx = 0; cx < gridWidth; cx++) {
+            uint32_t cell = static_cast<uint32_t>(cy * gridWidth + cx);
+            // Half of the neighborhood: each pair of neighboring cells is visited exactly once
+            tests += resolveCells(cell, cell);
+            if (cx + 1 < gridWidth) { tests += resolveCells(cell, cell + 1); }
+            if (cy + 1 < gridHeight) {
+                uint32_t above = cell + gridWidth;
+                if (cx > 0) { tests += resolveCells(cell, above - 1); }
+                tests += resolveCells(cell, above);
+                if (cx + 1 < gridWidth) { tests += resolveCells(cell, above + 1); }
+            }
+        }
+    }
+    return tests;
+}
+
+size_t ParticleSystem::resolveCells(uint32_t a, uint32_t b) {
+    size_t tests = 0;
+    // Particles are stored in cell order, so a cell's particles are the range [cellStart[cell], cellStart[cell + 1])
+    for (uint32_t p = cellStart[a]; p < cellStart[a + 1]; p++) {
+        // Within one cell only test each pair once
+        uint32_t first = (a == b) ? p + 1 : cellStart[b];
+        for (uint32_t q = first; q < cellStart[b + 1]; q++) {
+            tests++;
+            // Cheap squared-distance reject before calling the full response
+            vec2 delta = positions[q] - positions[p];
+            float radiusSum = radii[p] + radii[q];
+            if (delta.x * delta.x + delta.y * delta.y >= radiusSum * radiusSum) { continue; }
+            resolveCircleCollision(positions[p], velocities[p], radii[p], positions[q], velocities[q], radii[q]);
+        }
+    }
+    return tests;
+}
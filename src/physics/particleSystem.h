@@ -0,0 +1,123 @@
+#ifndef GRAPHICS_PARTICLESYSTEM_H
+#define GRAPHICS_PARTICLESYSTEM_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "glm/glm.hpp"
+#include "../framework/color.h"
+#include "../framework/threadPool.h"
+
+class Circle;
+
+using std::vector, glm::vec2;
+
+/**
+ * @brief Simulates a large number of colliding circles.
+ * @details Particles are stored as parallel arrays. Every step integrates velocities over deltaTime,
+ * bounces particles off the bounds, then resolves collisions in two phases:
+ * - Broad phase: particles are counting-sorted into a uniform grid whose cells are as wide as the
+ *   largest particle, so only particles in neighboring cells can touch.
+ * - Narrow phase: each candidate pair is resolved with resolveCircleCollision() (the same response as Circle::bounce).
+ * With a thread pool, rows of the grid are split into bands; even and odd bands are resolved in two passes
+ * so no two threads ever touch the same particle.
+ */
+class ParticleSystem {
+public:
+    /// @brief Construct a new Particle System
+    /// @param bounds The size of the area the particles bounce around in (origin at 0, 0)
+    /// @param threads Number of worker threads for collision resolution (0 resolves on the calling thread)
+    explicit ParticleSystem(vec2 bounds, unsigned int threads = 0);
+
+    ~ParticleSystem();
+
+    /// @brief Adds a single particle
+    void add(vec2 pos, vec2 velocity, float radius, color color);
+
+    /// @brief Adds a particle that starts where the circle is, moving at the circle's velocity
+    void add(const Circle &circle);
+
+    /// @brief Adds particles flying out of a point in random directions
+    /// @param origin Where the burst starts
+    /// @param count Number of particles
+    /// @param minSpeed Slowest launch speed (units per second)
+    /// @param maxSpeed Fastest launch speed (units per second)
+    /// @param radius Radius of every particle
+    /// @param palette Colors picked at random for each particle
+    void burst(vec2 origin, int count, float minSpeed, float maxSpeed, float radius, const vector<color> &palette);
+
+    /// @brief Advances the simulation
+    /// @param deltaTime Time since the last update (seconds)
+    void update(float deltaTime);
+
+    /// @brief Removes every particle
+    void clear();
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+    size_t size() const                     { return positions.size(); }
+    const vector<vec2> &getPositions() const  { return positions; }
+    const vector<vec2> &getVelocities() const { return velocities; }
+    const vector<float> &getRadii() const     { return radii; }
+    const vector<uint32_t> &getColors() const { return colors; }
+
+    /// @brief Number of narrow-phase tests in the last update (for profiling)
+    size_t getPairTests() const { return pairTests; }
+
+    // --------------------------------------------------------
+    // Setters
+    // --------------------------------------------------------
+    void setGravity(vec2 gravity)          { this->gravity = gravity; }
+    void setRestitution(float restitution) { this->restitution = restitution; }
+
+private:
+    vec2 bounds;
+    vec2 gravity{0, -500.0f};
+    /// @brief Fraction of speed kept after hitting a wall
+    float restitution = 0.8f;
+
+    // Particle data, indexed by particle
+    vector<vec2> positions;
+    vector<vec2> velocities;
+    vector<float> radii;
+    vector<uint32_t> colors;
+    float maxRadius = 0;
+
+    // Broad phase grid, rebuilt every update
+    float cellSize = 1;
+    int gridWidth = 0, gridHeight = 0;
+    vector<uint32_t> cellStart;     // First entry of each cell in cellParticles (size cells + 1)
+    vector<uint32_t> cellParticles; // Particle indices sorted by cell
+    vector<uint32_t> particleCells; // Cell of each particle
+    vector<uint32_t> cellCursor;    // Write position of each cell while scattering
+
+    // Scratch arrays reused when reordering particles by cell
+    vector<vec2> scratchVec2;
+    vector<float> scratchFloat;
+    vector<uint32_t> scratchColor;
+
+    size_t pairTests = 0;
+    std::unique_ptr<ThreadPool> pool;
+    std::mt19937 rng{std::random_device{}()};
+
+    /// @brief Moves every particle and bounces it off the bounds
+    void integrate(float deltaTime);
+
+    /// @brief Counting-sorts the particles into grid cells and stores them in cell order
+    void buildGrid();
+
+    /// @brief Permutes one particle array into the order given by cellParticles
+    template <typename T>
+    void reorder(vector<T> &values, vector<T> &scratch) const;
+
+    /// @brief Resolves every pair in the given grid rows against its own and the next row
+    /// @return The number of pairs that were tested
+    size_t resolveRows(int firstRow, int lastRow);
+
+    /// @brief Resolves every particle in cell a against every particle in cell b (a == b tests each pair once)
+    size_t resolveCells(uint32_t a, uint32_t b);
+};
+
+#endif //GRAPHICS_PARTICLESYSTEM_H
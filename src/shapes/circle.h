@@ -14,15 +14,14 @@ private:
 
     /// @brief Radius of the circle (half of screen width
     float radius;
-    /// @brief The x and y velocities of the circle
-    vec2 velocity;
 
 public:
     /// @brief Construct a new Circle object
     /// @details This is the main constructor for the Circle class.
     /// @details All other constructors call this constructor.
     Circle(Shader &shader, vec2 pos, vec2 size, vec2 velocity, vec4 color)
-        : Shape(shader, pos, size, color), radius(size.x / 2.0f), velocity(velocity) {
+        : Shape(shader, pos, size, color), radius(size.x / 2.0f) {
+        setVelocity(velocity);
         initVectors();
         initVAO();
         initVBO();
@@ -41,10 +40,6 @@ public:
     // override setUniforms to set the radius uniform
     void setUniforms() const override;
 
-    /// @brief Destroy the Circle object
-    /// @details destroys the VAO and VBO associated with the circle
-    ~Circle() override;
-
     /// @brief Draws the circle
     void draw() const override;
 
@@ -0,0 +1,295 @@
+#include "collision.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define COLLISION_SSE2 1
+#include <immintrin.h>
+#endif
+
+// AVX2 kernels are compiled with a function-level target attribute and only used if the CPU supports them
+#if defined(COLLISION_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define COLLISION_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+typedef size_t (*BoxKernel)(vec2 pos, vec2 size, const AABBArrays &boxes, size_t begin, uint8_t *hits);
+typedef long (*FirstBoxKernel)(vec2 pos, vec2 size, const AABBArrays &boxes);
+typedef size_t (*CircleKernel)(vec2 center, float radius, const CircleArrays &circles, size_t begin, uint8_t *hits);
+
+// --------------------------------------------------------
+// Scalar kernels (also used for the tails of the SIMD loops)
+// --------------------------------------------------------
+
+// Two boxes overlap when twice the distance between their centers is at most the sum of their sizes on both axes
+inline bool boxOverlaps(vec2 pos, vec2 size, const AABBArrays &b, size_t ii) {
+    float dx = b.posX[ii] - pos.x, dy = b.posY[ii] - pos.y;
+    return 2 * (dx < 0 ? -dx : dx) <= b.sizeX[ii] + size.x &&
+           2 * (dy < 0 ? -dy : dy) <= b.sizeY[ii] + size.y;
+}
+
+// Two circles overlap when the squared distance between their centers is below the squared sum of their radii
+inline bool circleOverlaps(vec2 center, float radius, const CircleArrays &c, size_t ii) {
+    float dx = c.posX[ii] - center.x, dy = c.posY[ii] - center.y;
+    float radiusSum = c.radius[ii] + radius;
+    return dx * dx + dy * dy < radiusSum * radiusSum;
+}
+
+size_t overlapAABBsScalar(vec2 pos, vec2 size, const AABBArrays &b, size_t begin, uint8_t *hits) {
+    size_t count = 0;
+    for (size_t ii = begin; ii < b.count; ii++) {
+        hits[ii] = boxOverlaps(pos, size, b, ii);
+        count += hits[ii];
+    }
+    return count;
+}
+
+long firstOverlappingAABBScalar(vec2 pos, vec2 size, const AABBArrays &b) {
+    for (size_t ii = 0; ii < b.count; ii++) {
+        if (boxOverlaps(pos, size, b, ii)) { return static_cast<long>(ii); }
+    }
+    return -1;
+}
+
+size_t overlapCirclesScalar(vec2 center, float radius, const CircleArrays &c, size_t begin, uint8_t *hits) {
+    size_t count = 0;
+    for (size_t ii = begin; ii < c.count; ii++) {
+        hits[ii] = circleOverlaps(center, radius, c, ii);
+        count += hits[ii];
+    }
+    return count;
+}
+
+// Writes the low `lanes` bits of a movemask result out as 0/1 bytes and returns how many were set
+inline size_t expandMask(int mask, int lanes, uint8_t *hits) {
+    size_t count = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        hits[lane] = (mask >> lane) & 1;
+        count += hits[lane];
+    }
+    return count;
+}
+
+#ifdef COLLISION_SSE2
+// --------------------------------------------------------
+// SSE2 kernels (4 shapes per iteration)
+// --------------------------------------------------------
+
+size_t overlapAABBsSSE2(vec2 pos, vec2 size, const AABBArrays &b, size_t, uint8_t *hits) {
+    const __m128 qx = _mm_set1_ps(pos.x), qy = _mm_set1_ps(pos.y);
+    const __m128 qw = _mm_set1_ps(size.x), qh = _mm_set1_ps(size.y);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    size_t ii = 0, count = 0;
+    for (; ii + 4 <= b.count; ii += 4) {
+        __m128 dx = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(b.posX + ii), qx), absMask);
+        __m128 dy = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(b.posY + ii), qy), absMask);
+        __m128 inX = _mm_cmple_ps(_mm_add_ps(dx, dx), _mm_add_ps(_mm_loadu_ps(b.sizeX + ii), qw));
+        __m128 inY = _mm_cmple_ps(_mm_add_ps(dy, dy), _mm_add_ps(_mm_loadu_ps(b.sizeY + ii), qh));
+        count += expandMask(_mm_movemask_ps(_mm_and_ps(inX, inY)), 4, hits + ii);
+    }
+    return count + overlapAABBsScalar(pos, size, b, ii, hits);
+}
+
+long firstOverlappingAABBSSE2(vec2 pos, vec2 size, const AABBArrays &b) {
+    const __m128 qx = _mm_set1_ps(pos.x), qy = _mm_set1_ps(pos.y);
+    const __m128 qw = _mm_set1_ps(size.x), qh = _mm_set1_ps(size.y);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    size_t ii = 0;
+    for (; ii + 4 <= b.count; ii += 4) {
+        __m128 dx = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(b.posX + ii), qx), absMask);
+        __m128 dy = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(b.posY + ii), qy), absMask);
+        __m128 inX = _mm_cmple_ps(_mm_add_ps(dx, dx), _mm_add_ps(_mm_loadu_ps(b.sizeX + ii), qw));
+        __m128 inY = _mm_cmple_ps(_mm_add_ps(dy, dy), _mm_add_ps(_mm_loadu_ps(b.sizeY + ii), qh));
+        int mask = _mm_movemask_ps(_mm_and_ps(inX, inY));
+        if (mask) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) { return static_cast<long>(ii + lane); }
+            }
+        }
+    }
+    for (; ii < b.count; ii++) {
+        if (boxOverlaps(pos, size, b, ii)) { return static_cast<long>(ii); }
+    }
+    return -1;
+}
+
+size_t overlapCirclesSSE2(vec2 center, float radius, const CircleArrays &c, size_t, uint8_t *hits) {
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), r = _mm_set1_ps(radius);
+    size_t ii = 0, count = 0;
+    for (; ii + 4 <= c.count; ii += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(c.posX + ii), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(c.posY + ii), cy);
+        __m128 radiusSum = _mm_add_ps(_mm_loadu_ps(c.radius + ii), r);
+        __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        count += expandMask(_mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(radiusSum, radiusSum))), 4, hits + ii);
+    }
+    return count + overlapCirclesScalar(center, radius, c, ii, hits);
+}
+#endif
+
+#ifdef COLLISION_AVX2
+// --------------------------------------------------------
+// AVX2 kernels (8 shapes per iteration)
+// --------------------------------------------------------
+
+// Spreads the 8 bits of a movemask result into 8 bytes (bit k -> byte k) and stores them in one go.
+// The multiply moves bits 0-6 into place without overlapping carries; bit 7 is placed separately.
+inline void storeMask8(int mask, uint8_t *hits) {
+    uint64_t low = static_cast<uint64_t>(mask & 0x7F) * 0x0002040810204081ULL;
+    uint64_t spread = (low & 0x0101010101010101ULL) | (static_cast<uint64_t>((mask >> 7) & 1) << 56);
+    memcpy(hits, &spread, sizeof(spread));
+}
+
+AVX2_TARGET size_t overlapAABBsAVX2(vec2 pos, vec2 size, const AABBArrays &b, size_t, uint8_t *hits) {
+    const __m256 qx = _mm256_set1_ps(pos.x), qy = _mm256_set1_ps(pos.y);
+    const __m256 qw = _mm256_set1_ps(size.x), qh = _mm256_set1_ps(size.y);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    size_t ii = 0, count = 0;
+    for (; ii + 8 <= b.count; ii += 8) {
+        __m256 dx = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(b.posX + ii), qx), absMask);
+        __m256 dy = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(b.posY + ii), qy), absMask);
+        __m256 inX = _mm256_cmp_ps(_mm256_add_ps(dx, dx), _mm256_add_ps(_mm256_loadu_ps(b.sizeX + ii), qw), _CMP_LE_OQ);
+        __m256 inY = _mm256_cmp_ps(_mm256_add_ps(dy, dy), _mm256_add_ps(_mm256_loadu_ps(b.sizeY + ii), qh), _CMP_LE_OQ);
+        int mask = _mm256_movemask_ps(_mm256_and_ps(inX, inY));
+        storeMask8(mask, hits + ii);
+        count += __builtin_popcount(mask);
+    }
+    return count + overlapAABBsScalar(pos, size, b, ii, hits);
+}
+
+AVX2_TARGET long firstOverlappingAABBAVX2(vec2 pos, vec2 size, const AABBArrays &b) {
+    const __m256 qx = _mm256_set1_ps(pos.x), qy = _mm256_set1_ps(pos.y);
+    const __m256 qw = _mm256_set1_ps(size.x), qh = _mm256_set1_ps(size.y);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    size_t ii = 0;
+    for (; ii + 8 <= b.count; ii += 8) {
+        __m256 dx = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(b.posX + ii), qx), absMask);
+        __m256 dy = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(b.posY + ii), qy), absMask);
+        __m256 inX = _mm256_cmp_ps(_mm256_add_ps(dx, dx), _mm256_add_ps(_mm256_loadu_ps(b.sizeX + ii), qw), _CMP_LE_OQ);
+        __m256 inY = _mm256_cmp_ps(_mm256_add_ps(dy, dy), _mm256_add_ps(_mm256_loadu_ps(b.sizeY + ii), qh), _CMP_LE_OQ);
+        int mask = _mm256_movemask_ps(_mm256_and_ps(inX, inY));
+        if (mask) { return static_cast<long>(ii + __builtin_ctz(mask)); }
+    }
+    for (; ii < b.count; ii++) {
+        if (boxOverlaps(pos, size, b, ii)) { return static_cast<long>(ii); }
+    }
+    return -1;
+}
+
+AVX2_TARGET size_t overlapCirclesAVX2(vec2 center, float radius, const CircleArrays &c, size_t, uint8_t *hits) {
+    const __m256 cx = _mm256_set1_ps(center.x), cy = _mm256_set1_ps(center.y), r = _mm256_set1_ps(radius);
+    size_t ii = 0, count = 0;
+    for (; ii + 8 <= c.count; ii += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(c.posX + ii), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(c.posY + ii), cy);
+        __m256 radiusSum = _mm256_add_ps(_mm256_loadu_ps(c.radius + ii), r);
+        __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, _mm256_mul_ps(radiusSum, radiusSum), _CMP_LT_OQ));
+        storeMask8(mask, hits + ii);
+        count += __builtin_popcount(mask);
+    }
+    return count + overlapCirclesScalar(center, radius, c, ii, hits);
+}
+#endif
+
+/// @brief The kernel set used by the public functions, picked once from the CPU's features
+struct Kernels {
+    BoxKernel boxes = overlapAABBsScalar;
+    FirstBoxKernel firstBox = firstOverlappingAABBScalar;
+    CircleKernel circles = overlapCirclesScalar;
+    const char *name = "scalar";
+
+    Kernels() {
+#ifdef COLLISION_SSE2
+        boxes = overlapAABBsSSE2;
+        firstBox = firstOverlappingAABBSSE2;
+        circles = overlapCirclesSSE2;
+        name = "sse2";
+#endif
+#ifdef COLLISION_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            boxes = overlapAABBsAVX2;
+            firstBox = firstOverlappingAABBAVX2;
+            circles = overlapCirclesAVX2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+const Kernels &kernels() {
+    static const Kernels selected;
+    return selected;
+}
+
+} // namespace
+
+size_t overlapAABBs(vec2 pos, vec2 size, const AABBArrays &boxes, uint8_t *hits) {
+    return kernels().boxes(pos, size, boxes, 0, hits);
+}
+
+long firstOverlappingAABB(vec2 pos, vec2 size, const AABBArrays &boxes) {
+    return kernels().firstBox(pos, size, boxes);
+}
+
+size_t overlapCircles(vec2 center, float radius, const CircleArrays &circles, uint8_t *hits) {
+    return kernels().circles(center, radius, circles, 0, hits);
+}
+
+void overlapAABBPairs(const AABBArrays &queries, const AABBArrays &targets, vector<CollisionPair> &pairs) {
+    vector<uint8_t> hits(targets.count);
+    for (size_t query = 0; query < queries.count; query++) {
+        vec2 pos(queries.posX[query], queries.posY[query]);
+        vec2 size(queries.sizeX[query], queries.sizeY[query]);
+        if (overlapAABBs(pos, size, targets, hits.data()) == 0) { continue; }
+        for (size_t target = 0; target < targets.count; target++) {
+            if (hits[target]) { pairs.push_back({static_cast<uint32_t>(query), static_cast<uint32_t>(target)}); }
+        }
+    }
+}
+
+void overlapCirclePairs(const CircleArrays &queries, const CircleArrays &targets, vector<CollisionPair> &pairs) {
+    vector<uint8_t> hits(targets.count);
+    for (size_t query = 0; query < queries.count; query++) {
+        vec2 center(queries.posX[query], queries.posY[query]);
+        if (overlapCircles(center, queries.radius[query], targets, hits.data()) == 0) { continue; }
+        for (size_t target = 0; target < targets.count; target++) {
+            if (hits[target]) { pairs.push_back({static_cast<uint32_t>(query), static_cast<uint32_t>(target)}); }
+        }
+    }
+}
+
+bool resolveCircleCollision(vec2 &posA, vec2 &velA, float radiusA, vec2 &posB, vec2 &velB, float radiusB) {
+    vec2 delta = posB - posA;
+    float distanceSq = glm::dot(delta, delta);
+    float radiusSum = radiusA + radiusB;
+
+    // Check if circles are overlapping (circles sitting exactly on top of each other have no normal)
+    if (distanceSq >= radiusSum * radiusSum || distanceSq == 0.0f) { return false; }
+    float distance = std::sqrt(distanceSq);
+    float overlap = 0.5f * (radiusSum - distance);
+
+    // Adjust positions based on radius (as a proxy for mass; pi cancels out of every ratio)
+    float massA = radiusA * radiusA;
+    float massB = radiusB * radiusB;
+    float totalMass = massA + massB;
+
+    posA -= overlap * (massA / totalMass) * delta / distance;
+    posB += overlap * (massB / totalMass) * delta / distance;
+
+    // Velocity calculations for elastic collision
+    vec2 velocityDifference = velA - velB;
+    float dotProduct = glm::dot(velocityDifference, delta) / distanceSq;
+    vec2 collisionNormal = dotProduct * delta;
+
+    velA -= (2 * massB / totalMass) * collisionNormal;
+    velB += (2 * massA / totalMass) * collisionNormal;
+    return true;
+}
+
+const char *collisionKernelName() {
+    return kernels().name;
+}
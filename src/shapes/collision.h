@@ -0,0 +1,65 @@
+#ifndef GRAPHICS_COLLISION_H
+#define GRAPHICS_COLLISION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+
+using std::vector, glm::vec2;
+
+/*
+ * Batched collision tests against structure-of-arrays shape data.
+ * Boxes are given by center and size (the same layout ShapeStore uses), circles by center and radius.
+ * The kernels never call virtual functions or take square roots; on x86 they pick an AVX2 or SSE2
+ * implementation at runtime and fall back to scalar code everywhere else.
+ */
+
+/// @brief Read-only view of axis-aligned boxes stored as separate arrays
+struct AABBArrays {
+    const float *posX, *posY;   // Centers
+    const float *sizeX, *sizeY; // Full widths and heights
+    size_t count;
+};
+
+/// @brief Read-only view of circles stored as separate arrays
+struct CircleArrays {
+    const float *posX, *posY; // Centers
+    const float *radius;
+    size_t count;
+};
+
+/// @brief A query index and the index of the shape it overlaps
+struct CollisionPair {
+    uint32_t query, target;
+};
+
+/// @brief Tests one box against every box in the arrays (edges touching count as overlapping)
+/// @param hits Receives 1 for every overlapping box and 0 otherwise (must hold boxes.count bytes)
+/// @return The number of overlapping boxes
+size_t overlapAABBs(vec2 pos, vec2 size, const AABBArrays &boxes, uint8_t *hits);
+
+/// @brief Returns the index of the first box that overlaps the query box, or -1 if there is none
+long firstOverlappingAABB(vec2 pos, vec2 size, const AABBArrays &boxes);
+
+/// @brief Tests one circle against every circle in the arrays (touching circles do not overlap)
+/// @param hits Receives 1 for every overlapping circle and 0 otherwise (must hold circles.count bytes)
+/// @return The number of overlapping circles
+size_t overlapCircles(vec2 center, float radius, const CircleArrays &circles, uint8_t *hits);
+
+/// @brief Tests every query box against every target box and appends the overlapping pairs
+void overlapAABBPairs(const AABBArrays &queries, const AABBArrays &targets, vector<CollisionPair> &pairs);
+
+/// @brief Tests every query circle against every target circle and appends the overlapping pairs
+void overlapCirclePairs(const CircleArrays &queries, const CircleArrays &targets, vector<CollisionPair> &pairs);
+
+/// @brief Pushes two overlapping circles apart and exchanges momentum (elastic collision)
+/// @details Mass is proportional to the area of each circle. This is the response used by
+/// Circle::bounce and by the particle system's narrow phase. Does nothing if the circles don't overlap.
+/// @return true if the circles were overlapping
+bool resolveCircleCollision(vec2 &posA, vec2 &velA, float radiusA, vec2 &posB, vec2 &velB, float radiusB);
+
+/// @brief Name of the kernel set picked for this CPU ("avx2", "sse2" or "scalar")
+const char *collisionKernelName();
+
+#endif //GRAPHICS_COLLISION_H
@@ -1,5 +1,6 @@
 #include "rect.h"
 #include "circle.h"
+#include <cmath>
 
 Rect::Rect(Shader & shader, vec2 pos, vec2 size, struct color color) : Shape(shader, pos, size, color) {
     initVectors();
@@ -14,15 +15,9 @@ Rect::Rect(Shader &shader, vec2 pos, float width, struct color color)
 Rect::Rect(Shader &shader, vec2 pos, float width, vec4 color)
     : Rect(shader, pos, vec2(width, width), color) {}
 
-Rect::~Rect() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-}
-
 void Rect::draw() const {
-    glBindVertexArray(VAO);
+    GLState::get().bindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
 }
 
 void Rect::initVectors() {
@@ -40,13 +35,12 @@ void Rect::initVectors() {
 }
 
 bool Rect::isOverlapping(const Rect &r1, const Rect &r2) {
-    if (r1.getLeft() > r2.getRight() || r2.getLeft() > r1.getRight()) {
-        return false;
-    } else if (r1.getBottom() > r2.getTop() || r2.getBottom() > r1.getTop()) {
-        return false;
-    } else {
-        return true;
-    }
+    // Reads the members directly instead of going through the virtual edge getters:
+    // the rectangles overlap when twice the distance between their centers is at most
+    // the sum of their sizes on both axes.
+    vec2 delta = r1.pos - r2.pos;
+    return 2 * fabsf(delta.x) <= r1.size.x + r2.size.x &&
+           2 * fabsf(delta.y) <= r1.size.y + r2.size.y;
 }
 
 bool Rect::isOverlapping(const Rect &other) const {
@@ -27,11 +27,6 @@ public:
     // Overloaded constructor with only width (assuming square) using vec4 color
     Rect(Shader &shader, vec2 pos, float width, vec4 color);
 
-    Rect(Rect const& other);
-
-    /// @brief Destroy the Square object and delete it's VAO and VBO
-    ~Rect();
-
     /// @brief Binds the VAO and calls the virtual draw function
     void draw() const override;
 
@@ -3,38 +3,37 @@
 Shape::Shape(Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color) :
     shader(shader), pos(pos), size(size), color(color) {}
 
-Shape::Shape(Shape const& other) :
-    shader(other.shader), pos(other.pos), size(other.size), color(other.color) {}
-
 Shape::Shape(Shader &shader, glm::vec2 pos, vec2 size, vec4 color) :
     shader(shader), pos(pos), size(size), color(color) {}
 
 
 // Initialize VAO
 unsigned int Shape::initVAO() {
-    glGenVertexArrays(1, &VAO); // Generate VAO
-    glBindVertexArray(VAO); // Bind VAO
-    return VAO;
+    VAO.create("Shape"); // Generate VAO
+    GLState::get().bindVertexArray(VAO); // Bind VAO
+    return VAO.get();
 }
 
 // Initialize VBO
 void Shape::initVBO() {
     // Generate VBO, bind it to VAO, and copy vertices data into it
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    VBO.create("Shape");
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    VBO.setBytes(vertices.size() * sizeof(float));
 
     // Set the vertex attribute pointers (2 floats per vertex (x, y))
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0); // Enable the vertex attribute at location 0
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO
 }
 
 // Initialize EBO
 void Shape::initEBO() {
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(float), indices.data(), GL_STATIC_DRAW);
+    EBO.create("Shape");
+    GLState::get().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    EBO.setBytes(indices.size() * sizeof(unsigned int));
     // Don't unbind EBO because it's bound to VAO
 }
 
@@ -71,6 +70,8 @@ void Shape::setGreen(float g)    { color.green = g; }
 void Shape::setBlue(float b)     { color.blue = b; }
 void Shape::setOpacity(float a)  { color.alpha = a; }
 
+void Shape::update(float deltaTime) { pos += velocity * deltaTime; }
+
 void Shape::setSize(vec2 size) { this->size = size; }
 void Shape::setSizeX(float x)  { size.x = x; }
 void Shape::setSizeY(float y)  { size.y = y; }
@@ -5,6 +5,7 @@
 #include <vector>
 #include "../framework/shader.h"
 #include "../framework/color.h"
+#include "../framework/glResources.h"
 
 using std::vector, glm::vec2, glm::vec3, glm::vec4, glm::mat4, glm::translate, glm::scale;
 
@@ -19,10 +20,11 @@ class Shape {
 
         Shape(Shader& shader, vec2 pos, vec2 size, vec4 color);
 
-        /// @brief Copy constructor for Shape
-        Shape(Shape const& other);
+        /// @brief Shapes own their GL objects, so they can't be copied
+        Shape(Shape const& other) = delete;
+        Shape &operator=(Shape const& other) = delete;
 
-        /// @brief Destroy the Shape object
+        /// @brief Destroy the Shape object and its VAO, VBO and EBO
         virtual ~Shape() = default;
 
         // --------------------------------------------------------
@@ -95,6 +97,8 @@ class Shape {
         void setSizeY(float y);
 
         // Change Functions
+
+        /// @brief Moves the shape by its velocity over the given time step
         void update(float deltaTime);
 
         // Color
@@ -125,13 +129,16 @@ protected:
 
         vec2 size;
 
-        vec2 velocity;
+        /// @brief The x and y velocities of the shape (units per second)
+        vec2 velocity{0, 0};
 
         /// @brief The VAO of the shape
         color color;
 
         /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the shape.
-        unsigned int VAO, VBO, EBO;
+        /// @details Deleted along with the shape; a shape without indices has no EBO.
+        GLVertexArray VAO;
+        GLBuffer VBO, EBO;
 
         /// @brief The vertices of the shape
         vector<float> vertices;
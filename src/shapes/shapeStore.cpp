@@ -0,0 +1,90 @@
+#include "shapeStore.h"
+#include "collision.h"
+
+void ShapeStore::reserve(size_t count) {
+    posX.reserve(count);
+    posY.reserve(count);
+    sizeX.reserve(count);
+    sizeY.reserve(count);
+    colors.reserve(count);
+    flags.reserve(count);
+}
+
+ShapeHandle ShapeStore::create(vec2 pos, vec2 size, struct color color, bool visible) {
+    uint8_t flag = SHAPE_ALIVE | (visible ? SHAPE_VISIBLE : 0);
+
+    // Reuse a pooled slot before growing the arrays
+    if (!freeSlots.empty()) {
+        ShapeHandle handle = freeSlots.back();
+        freeSlots.pop_back();
+        posX[handle] = pos.x;
+        posY[handle] = pos.y;
+        sizeX[handle] = size.x;
+        sizeY[handle] = size.y;
+        colors[handle] = packColor(color);
+        flags[handle] = flag;
+        return handle;
+    }
+
+    posX.push_back(pos.x);
+    posY.push_back(pos.y);
+    sizeX.push_back(size.x);
+    sizeY.push_back(size.y);
+    colors.push_back(packColor(color));
+    flags.push_back(flag);
+    return static_cast<ShapeHandle>(flags.size() - 1);
+}
+
+void ShapeStore::destroy(ShapeHandle handle) {
+    if (!isAlive(handle)) { return; }
+    flags[handle] = 0;
+    freeSlots.push_back(handle);
+}
+
+void ShapeStore::clear() {
+    posX.clear();
+    posY.clear();
+    sizeX.clear();
+    sizeY.clear();
+    colors.clear();
+    flags.clear();
+    freeSlots.clear();
+}
+
+int ShapeStore::findOverlapping(vec2 pos, vec2 size, ShapeHandle begin, ShapeHandle end) const {
+    // Run the batched kernel over the range; if it lands on a pooled slot, keep searching after it
+    while (begin < end) {
+        AABBArrays boxes{&posX[begin], &posY[begin], &sizeX[begin], &sizeY[begin], end - begin};
+        long hit = firstOverlappingAABB(pos, size, boxes);
+        if (hit < 0) { return -1; }
+        ShapeHandle handle = begin + static_cast<ShapeHandle>(hit);
+        if (flags[handle] & SHAPE_ALIVE) { return static_cast<int>(handle); }
+        begin = handle + 1;
+    }
+    return -1;
+}
+
+// Getters
+bool ShapeStore::isAlive(ShapeHandle h) const     { return h < flags.size() && (flags[h] & SHAPE_ALIVE); }
+bool ShapeStore::isVisible(ShapeHandle h) const   { return flags[h] & SHAPE_VISIBLE; }
+vec2 ShapeStore::getPos(ShapeHandle h) const      { return {posX[h], posY[h]}; }
+vec2 ShapeStore::getSize(ShapeHandle h) const     { return {sizeX[h], sizeY[h]}; }
+uint32_t ShapeStore::getColor(ShapeHandle h) const { return colors[h]; }
+size_t ShapeStore::size() const                   { return flags.size(); }
+
+// Setters
+void ShapeStore::setPos(ShapeHandle h, vec2 pos)            { posX[h] = pos.x; posY[h] = pos.y; }
+void ShapeStore::setSize(ShapeHandle h, vec2 size)          { sizeX[h] = size.x; sizeY[h] = size.y; }
+void ShapeStore::setColor(ShapeHandle h, struct color c)    { colors[h] = packColor(c); }
+void ShapeStore::setColor(ShapeHandle h, uint32_t packed)   { colors[h] = packed; }
+
+void ShapeStore::setVisible(ShapeHandle h, bool visible) {
+    if (visible) { flags[h] |= SHAPE_VISIBLE; }
+    else { flags[h] &= ~SHAPE_VISIBLE; }
+}
+
+void ShapeStore::setVisible(ShapeHandle begin, ShapeHandle end, bool visible) {
+    for (ShapeHandle ii = begin; ii < end; ii++) {
+        setVisible(ii, visible);
+    }
+}
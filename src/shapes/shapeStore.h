@@ -0,0 +1,101 @@
+#ifndef GRAPHICS_SHAPESTORE_H
+#define GRAPHICS_SHAPESTORE_H
+
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+#include "../framework/color.h"
+
+using std::vector, glm::vec2;
+
+/// @brief Index of a shape inside a ShapeStore.
+typedef uint32_t ShapeHandle;
+
+/// @brief A run of consecutive handles [begin, end)
+struct ShapeRange {
+    ShapeHandle begin, end;
+};
+
+/// @brief Per-shape flag bits stored in ShapeStore::flags.
+enum ShapeFlags : uint8_t {
+    SHAPE_ALIVE   = 1 << 0, // Slot is in use (cleared when the slot goes back to the pool)
+    SHAPE_VISIBLE = 1 << 1, // Shape is drawn by the renderer
+};
+
+/**
+ * @brief Structure-of-arrays storage for axis-aligned rectangles.
+ * @details Every attribute lives in its own contiguous array, so hit testing, updating and uploading
+ * walk memory linearly instead of chasing one heap allocation (and vtable) per shape.
+ * A shape costs 21 bytes: center (8), size (8), packed RGBA8 color (4) and flags (1).
+ * Destroyed slots are kept in a free list and reused by the next create() call.
+ */
+class ShapeStore {
+public:
+    ShapeStore() = default;
+
+    /// @brief Reserves room for the given number of shapes
+    void reserve(size_t count);
+
+    /// @brief Adds a shape, reusing a pooled slot if one is free
+    /// @param pos The center of the shape
+    /// @param size The width and height of the shape
+    /// @param color The color of the shape
+    /// @param visible Whether the shape should be drawn
+    /// @return The handle of the new shape
+    ShapeHandle create(vec2 pos, vec2 size, color color, bool visible = true);
+
+    /// @brief Returns the shape's slot to the pool
+    void destroy(ShapeHandle handle);
+
+    /// @brief Removes every shape and empties the pool
+    void clear();
+
+    /// @brief Returns the first live shape in [begin, end) that overlaps the given rectangle
+    /// @param pos The center of the rectangle to test
+    /// @param size The width and height of the rectangle to test
+    /// @return The handle of the overlapping shape, or -1 if there is none
+    int findOverlapping(vec2 pos, vec2 size, ShapeHandle begin, ShapeHandle end) const;
+
+    // --------------------------------------------------------
+    // Getters
+    // --------------------------------------------------------
+    bool isAlive(ShapeHandle handle) const;
+    bool isVisible(ShapeHandle handle) const;
+    vec2 getPos(ShapeHandle handle) const;
+    vec2 getSize(ShapeHandle handle) const;
+    uint32_t getColor(ShapeHandle handle) const;
+
+    /// @brief Number of slots (live and pooled); handles are always below this value
+    size_t size() const;
+
+    // Raw arrays, indexed by handle
+    const float* getPosX() const       { return posX.data(); }
+    const float* getPosY() const       { return posY.data(); }
+    const float* getSizeX() const      { return sizeX.data(); }
+    const float* getSizeY() const      { return sizeY.data(); }
+    const uint32_t* getColors() const  { return colors.data(); }
+    const uint8_t* getFlags() const    { return flags.data(); }
+
+    // --------------------------------------------------------
+    // Setters
+    // --------------------------------------------------------
+    void setPos(ShapeHandle handle, vec2 pos);
+    void setSize(ShapeHandle handle, vec2 size);
+    void setColor(ShapeHandle handle, color color);
+    void setColor(ShapeHandle handle, uint32_t packed);
+    void setVisible(ShapeHandle handle, bool visible);
+
+    /// @brief Sets the visibility of every shape in [begin, end)
+    void setVisible(ShapeHandle begin, ShapeHandle end, bool visible);
+
+private:
+    vector<float> posX, posY;
+    vector<float> sizeX, sizeY;
+    vector<uint32_t> colors;
+    vector<uint8_t> flags;
+
+    /// @brief Slots released by destroy(), reused before the arrays grow
+    vector<ShapeHandle> freeSlots;
+};
+
+#endif //GRAPHICS_SHAPESTORE_H
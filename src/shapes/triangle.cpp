@@ -9,16 +9,9 @@ Triangle::Triangle(Shader & shader, vec2 pos, vec2 size, struct color color)
     initEBO();
 }
 
-Triangle::~Triangle() {
-    glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-}
-
 void Triangle::draw() const {
-    glBindVertexArray(this->VAO);
+    GLState::get().bindVertexArray(this->VAO);
     glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
 }
 
 void Triangle::initVectors() {
@@ -16,9 +16,6 @@ public:
     /// @param color The color of the triangle
     Triangle(Shader & shader, vec2 pos, vec2 size, struct color fill);
 
-    /// @brief Destroy the Triangle object and delete its VAO and VBO
-    ~Triangle();
-
     /// @brief Binds the VAO and calls the virtual draw function
     void draw() const override;
 
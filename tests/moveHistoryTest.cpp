@@ -0,0 +1,179 @@
+// Tests for MoveHistory's branches: going back to a move that another branch already plays, including the
+// branch the current one left, follows that branch instead of storing the moves again, and every position
+// reached through undo, redo, jumps and branch switches matches the moves replayed on a fresh board. Long
+// histories keep within 4 bytes a move, snapshots included. A saved history only loads onto the start board
+// it was played from.
+//
+//   move_history_test
+
+#include "../src/game/moveHistory.h"
+
+#include <cstdio>
+#include <string>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+void play(MoveHistory<Board> &history, Board &board, std::initializer_list<uint32_t> cells) {
+    for (uint32_t cell : cells) {
+        board.press(cell % board.getWidth(), cell / board.getWidth());
+        history.record(board, cell);
+    }
+}
+
+void undo(MoveHistory<Board> &history, Board &board, int count) {
+    for (int ii = 0; ii < count; ii++) { history.undo(board); }
+}
+
+Board replayed(const Board &start, std::initializer_list<uint32_t> cells) {
+    Board board = start;
+    for (uint32_t cell : cells) { board.press(cell % board.getWidth(), cell / board.getWidth()); }
+    return board;
+}
+}
+
+int main() {
+    Board start(5, 5);
+    start.fill(false);
+    Board board = start;
+    MoveHistory<Board> history(start);
+
+    // Branch 1 leaves branch 0 after its first move
+    play(history, board, {1, 2, 3});
+    undo(history, board, 2);
+    play(history, board, {7, 8});
+    check(history.getBranch() == 1 && history.getBranchCount() == 2, "a different move after an undo starts a branch");
+
+    // Back to the fork and branch 0's next move: that is branch 0 again, not a copy of it
+    undo(history, board, 2);
+    play(history, board, {2});
+    check(history.getBranch() == 0, "replaying the parent's move returns to the parent");
+    check(history.getBranchCount() == 2, "replaying the parent's move stores no branch");
+    check(history.redo(board) && history.getDepth() == 3 && board == replayed(start, {1, 2, 3}),
+          "redo follows the parent's moves");
+
+    // Same from branch 2, which leaves branch 1 after its third move: its parent and its parent's parent are found
+    undo(history, board, 2);
+    play(history, board, {7, 8, 9});
+    undo(history, board, 1);
+    play(history, board, {4});
+    check(history.getBranch() == 2 && history.getBranchCount() == 3, "a move after branch 1's last starts branch 2");
+    undo(history, board, 1);
+    play(history, board, {9});
+    check(history.getBranch() == 1 && history.getBranchCount() == 3, "replaying the parent's move from branch 2");
+    history.selectBranch(2, board);
+    undo(history, board, 3);
+    play(history, board, {2, 3});
+    check(history.getBranch() == 0 && history.getBranchCount() == 3, "replaying the first branch's moves from branch 2");
+
+    // Going back and forth between branches doesn't grow the history
+    const size_t stored = history.getStoredMoves();
+    for (int round = 0; round < 100; round++) {
+        undo(history, board, 2);
+        play(history, board, round % 2 ? std::initializer_list<uint32_t>{2, 3} : std::initializer_list<uint32_t>{7, 8});
+    }
+    check(history.getBranchCount() == 3 && history.getStoredMoves() == stored, "switching back and forth stores nothing");
+    check(board == replayed(start, {1, 2, 3}), "the board matches the moves played");
+
+    // Switching branches directly lands on each one's last move
+    history.selectBranch(2, board);
+    check(history.getDepth() == 4 && board == replayed(start, {1, 7, 8, 4}), "selectBranch goes to the branch's end");
+    history.selectBranch(0, board);
+    check(history.getDepth() == 3 && board == replayed(start, {1, 2, 3}), "selectBranch goes back to the first branch");
+
+    // A branch at the very start (no moves in common) is found too
+    undo(history, board, 3);
+    play(history, board, {5});
+    undo(history, board, 1);
+    play(history, board, {1});
+    check(history.getBranch() == 0 && history.getBranchCount() == 4, "replaying the first move from the start");
+    undo(history, board, 1);
+    play(history, board, {5});
+    check(history.getBranch() == 3 && history.getBranchCount() == 4, "a branch from the start is found from the start");
+
+    // Saving and loading keeps the branches and the position, but only for the same start board
+    const std::string path = "move_history_test.hist";
+    check(history.save(path), "save");
+    Board loaded = start;
+    MoveHistory<Board> resumed(start);
+    check(resumed.load(path, loaded) && loaded == board && resumed.getBranchCount() == history.getBranchCount()
+          && resumed.getBranch() == history.getBranch() && resumed.getDepth() == history.getDepth(),
+          "load restores the branches and the position");
+    Board other = replayed(start, {12});
+    Board unchanged = other;
+    MoveHistory<Board> elsewhere(other);
+    check(!elsewhere.load(path, unchanged) && unchanged == other && elsewhere.getBranchCount() == 1,
+          "a history of another puzzle is rejected");
+
+    // Same with more states, whose lights take several bits of the saved start board
+    ModBoard cells(7, 3, 5);
+    cells.scramble(1);
+    MoveHistory<ModBoard> cellHistory(cells);
+    ModBoard played = cells;
+    played.press(3, 1);
+    cellHistory.record(played, 10);
+    check(cellHistory.save(path), "save with more states");
+    ModBoard loadedCells = cells;
+    MoveHistory<ModBoard> resumedCells(cells);
+    check(resumedCells.load(path, loadedCells) && loadedCells == played, "load with more states");
+    ModBoard otherCells(7, 3, 5);
+    otherCells.scramble(2);
+    MoveHistory<ModBoard> elsewhereCells(otherCells);
+    check(!elsewhereCells.load(path, loadedCells), "a history of another puzzle with more states is rejected");
+
+    // A long game on a 100x100 board: moves take 14 bits, and the other 18 of each 4 bytes pay for snapshots
+    Board big(100, 100);
+    big.fill(false);
+    Board bigBoard = big;
+    MoveHistory<Board> longGame(big);
+    std::mt19937 random(7);
+    std::vector<uint32_t> moves;
+    for (int move = 0; move < 20000; move++) {
+        moves.push_back(random() % 10000);
+        bigBoard.press(moves.back() % 100, moves.back() / 100);
+        longGame.record(bigBoard, moves.back());
+    }
+    const size_t boardBits = 8 * sizeof(uint64_t) * big.getStride() * big.getHeight();
+    check(longGame.getMoveBits() == 14, "moves are packed at the bits of a light index");
+    check(longGame.getSnapshotCount() == moves.size() / longGame.getSnapshotInterval()
+          && longGame.getSnapshotInterval() * (32 - 14) >= boardBits, "snapshots fit in the bits moves leave");
+
+    // Jumps land on the board the moves up to the target make, from snapshots on either side or from here
+    auto boardAt = [&](size_t depth) {
+        Board expected = big;
+        for (size_t move = 0; move < depth; move++) { expected.press(moves[move] % 100, moves[move] / 100); }
+        return expected;
+    };
+    bool jumpsMatch = true;
+    for (size_t target : {size_t(0), size_t(1), longGame.getSnapshotInterval(), longGame.getSnapshotInterval() + 1,
+                          size_t(12345), size_t(19999), size_t(20000), size_t(777), size_t(20000)}) {
+        longGame.jumpTo(target, bigBoard);
+        jumpsMatch = jumpsMatch && longGame.getDepth() == target && bigBoard == boardAt(target);
+    }
+    check(jumpsMatch, "jumpTo reaches the board of every target");
+
+    // Packed moves cross word boundaries; they come back from a file exactly
+    longGame.jumpTo(15000, bigBoard);
+    check(longGame.save(path), "save a long game");
+    Board loadedBig = big;
+    MoveHistory<Board> resumedLong(big);
+    check(resumedLong.load(path, loadedBig) && resumedLong.getDepth() == 15000 && loadedBig == boardAt(15000)
+          && resumedLong.getLength() == 20000 && resumedLong.getSnapshotCount() == longGame.getSnapshotCount(),
+          "load a long game");
+    resumedLong.jumpTo(20000, loadedBig);
+    check(loadedBig == boardAt(20000), "a loaded game redoes its undone moves");
+    remove(path.c_str());
+
+    printf("%s\n", failures == 0 ? "All move history tests passed" : "Some move history tests FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// Stress test for TripleBuffer: a producer keeps publishing snapshots in which every field holds the same
+// counter, while a consumer picks them up until it has received the requested number. A snapshot with two
+// different values in it would be one the consumer saw half-written (torn); a counter going backwards would
+// be a stale buffer handed over again. Build with -fsanitize=thread (cmake -DTSAN_TESTS=ON) to also have
+// every access checked for races.
+//
+//   triple_buffer_test [--handoffs 2000000]
+
+#include "../src/framework/tripleBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+/// @brief Stands in for GameSnapshot: plain fields plus a container whose capacity is reused
+struct Snapshot {
+    uint64_t counter = 0;
+    uint64_t fields[13] = {};
+    std::vector<uint64_t> cells;
+};
+
+const size_t CELLS = 64;
+
+/// @brief Returns true if every field of the snapshot holds its counter
+bool isConsistent(const Snapshot &snapshot) {
+    for (uint64_t field : snapshot.fields) {
+        if (field != snapshot.counter) { return false; }
+    }
+    if (snapshot.cells.size() != CELLS) { return snapshot.counter == 0 && snapshot.cells.empty(); }
+    for (uint64_t cell : snapshot.cells) {
+        if (cell != snapshot.counter) { return false; }
+    }
+    return true;
+}
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t handoffs = 2000000;
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--handoffs") && ii + 1 < argc) { handoffs = strtoull(argv[++ii], nullptr, 10); }
+    }
+
+    TripleBuffer<Snapshot> buffer;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> seen{0};
+    uint64_t published = 0;
+    std::thread producer([&]() {
+        for (uint64_t counter = 1; !done.load(std::memory_order_relaxed); counter++) {
+            // Staying at most a few snapshots ahead keeps the consumer busy (an unthrottled producer, as under
+            // TSan, can starve it), while still overwriting snapshots the consumer never picks up
+            while (counter > seen.load(std::memory_order_relaxed) + 3 && !done.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+            Snapshot &snapshot = buffer.writeBuffer();
+            snapshot.counter = counter;
+            for (uint64_t &field : snapshot.fields) { field = counter; }
+            snapshot.cells.assign(CELLS, counter);
+            buffer.publish();
+            published = counter;
+        }
+    });
+
+    // update() never blocks, so the consumer polls (yielding the core in between) until enough snapshots came through
+    uint64_t last = 0, received = 0, torn = 0, stale = 0;
+    while (received < handoffs) {
+        if (!buffer.update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const Snapshot &snapshot = buffer.readBuffer();
+        received++;
+        if (!isConsistent(snapshot)) { torn++; }
+        if (snapshot.counter <= last) { stale++; }
+        last = snapshot.counter;
+        seen.store(last, std::memory_order_relaxed);
+    }
+    done = true;
+    producer.join();
+
+    printf("%llu snapshots published, %llu received, %llu torn, %llu stale\n",
+           static_cast<unsigned long long>(published), static_cast<unsigned long long>(received),
+           static_cast<unsigned long long>(torn), static_cast<unsigned long long>(stale));
+    return torn == 0 && stale == 0 ? 0 : 1;
+}
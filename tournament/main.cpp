@@ -0,0 +1,163 @@
+// Plays agents against many generated boards, spread across every core, without any rendering.
+//
+//   tournament [--size 5x5] [--boards 10000] [--agents random,greedy,optimal] [--threads 0] [--seed 1] [--max-moves n]
+//
+// Every agent plays the same boards (random presses from all off, so each one can be won). Games end
+// when the board is off, the agent gives up, or after --max-moves presses (default 4 per light).
+
+#include "../src/framework/threadPool.h"
+#include "../src/game/agent.h"
+#include "../src/game/board.h"
+#include "../src/game/solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+/// @brief Games played in one task (each task creates its own agent)
+const size_t GAMES_PER_TASK = 64;
+
+/// @brief Totals of one agent over some games; decision times are kept as a power-of-two histogram
+struct Results {
+    uint64_t games = 0, solved = 0, moves = 0, solvedMoves = 0;
+    uint64_t decisionNanos = 0, maxDecisionNanos = 0;
+    uint64_t histogram[64] = {};
+
+    void add(const Results &other) {
+        games += other.games;
+        solved += other.solved;
+        moves += other.moves;
+        solvedMoves += other.solvedMoves;
+        decisionNanos += other.decisionNanos;
+        maxDecisionNanos = max(maxDecisionNanos, other.maxDecisionNanos);
+        for (int ii = 0; ii < 64; ii++) { histogram[ii] += other.histogram[ii]; }
+    }
+
+    /// @brief Upper bound of the bucket holding the given fraction of the decisions
+    uint64_t decisionPercentile(double fraction) const {
+        uint64_t target = static_cast<uint64_t>(fraction * moves), seen = 0;
+        for (int ii = 0; ii < 64; ii++) {
+            seen += histogram[ii];
+            if (seen > target) { return uint64_t(1) << ii; }
+        }
+        return maxDecisionNanos;
+    }
+};
+
+int bucket(uint64_t nanos) {
+    int index = 0;
+    while (index < 63 && (uint64_t(1) << index) < nanos) { index++; }
+    return index;
+}
+
+/// @brief Plays one game and adds it to the results
+void play(Agent &agent, Board board, int maxMoves, Results &results) {
+    using Clock = chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+    };
+
+    // Whatever the agent works out up front counts towards its first decision
+    auto start = Clock::now();
+    agent.reset(board);
+    uint64_t setup = elapsed(start);
+
+    int moves = 0;
+    Move move;
+    while (!board.allOff() && moves < maxMoves) {
+        start = Clock::now();
+        bool playing = agent.choose(board, move);
+        uint64_t nanos = elapsed(start) + setup;
+        setup = 0;
+        if (!playing) { break; }
+
+        board.press(move.x, move.y);
+        moves++;
+        results.decisionNanos += nanos;
+        results.maxDecisionNanos = max(results.maxDecisionNanos, nanos);
+        results.histogram[bucket(nanos)]++;
+    }
+    results.games++;
+    results.moves += moves;
+    if (board.allOff()) {
+        results.solved++;
+        results.solvedMoves += moves;
+    }
+}
+}
+
+int main(int argc, char *argv[]) {
+    int width = 5, height = 5, maxMoves = -1;
+    unsigned int threads = 0;
+    size_t boards = 10000;
+    uint32_t seed = 1;
+    string agentList = "random,greedy,optimal";
+    for (int ii = 1; ii < argc; ii++) {
+        if (!strcmp(argv[ii], "--boards") && ii + 1 < argc)         { boards = strtoul(argv[++ii], nullptr, 10); }
+        else if (!strcmp(argv[ii], "--agents") && ii + 1 < argc)    { agentList = argv[++ii]; }
+        else if (!strcmp(argv[ii], "--threads") && ii + 1 < argc)   { threads = static_cast<unsigned int>(atoi(argv[++ii])); }
+        else if (!strcmp(argv[ii], "--seed") && ii + 1 < argc)      { seed = static_cast<uint32_t>(strtoul(argv[++ii], nullptr, 10)); }
+        else if (!strcmp(argv[ii], "--max-moves") && ii + 1 < argc) { maxMoves = atoi(argv[++ii]); }
+        else if (!strcmp(argv[ii], "--size") && ii + 1 < argc)      {
+            if (sscanf(argv[++ii], "%dx%d", &width, &height) != 2 || width < 1 || height < 1) {
+                cout << "Expected --size WxH, e.g. --size 5x5" << endl;
+                return 1;
+            }
+        }
+    }
+    if (maxMoves < 0) { maxMoves = 4 * width * height; }
+
+    Solver solver(width, height);
+    vector<string> agents;
+    stringstream names(agentList);
+    for (string name; getline(names, name, ',');) {
+        if (!makeAgent(name, 0, solver)) {
+            cout << "Unknown agent: " << name << " (expected random, greedy or optimal)" << endl;
+            return 1;
+        }
+        agents.push_back(name);
+    }
+
+    ThreadPool pool(threads);
+    const size_t tasks = (boards + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+    printf("%zu boards of %dx%d on %u threads, at most %d moves per game\n\n", boards, width, height, pool.size() + 1, maxMoves);
+    printf("%-8s %8s %8s %12s %12s %12s %12s %12s %10s\n", "agent", "games", "solved", "moves/game", "moves/solve",
+           "decide (avg)", "decide (p50)", "decide (p99)", "wall (s)");
+
+    for (const string &name : agents) {
+        // Each task gets its own agent and results; they are only merged once everything is done
+        vector<Results> partial(tasks);
+        auto start = chrono::steady_clock::now();
+        pool.parallelFor(tasks, [&](size_t task) {
+            unique_ptr<Agent> agent = makeAgent(name, seed + static_cast<uint32_t>(task), solver);
+            size_t end = min(boards, (task + 1) * GAMES_PER_TASK);
+            for (size_t game = task * GAMES_PER_TASK; game < end; game++) {
+                Board board(width, height);
+                board.fill(false);
+                board.scramble(seed * 2654435761u + static_cast<uint32_t>(game));
+                play(*agent, board, maxMoves, partial[task]);
+            }
+        });
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        Results total;
+        for (const Results &results : partial) { total.add(results); }
+        double games = max<double>(1, total.games);
+        printf("%-8s %8llu %7.1f%% %12.1f %12.1f %10.0fns %10lluns %10lluns %10.2f\n", name.c_str(),
+               static_cast<unsigned long long>(total.games), 100.0 * total.solved / games, total.moves / games,
+               total.solved ? double(total.solvedMoves) / total.solved : 0.0,
+               total.moves ? double(total.decisionNanos) / total.moves : 0.0,
+               static_cast<unsigned long long>(total.decisionPercentile(0.5)),
+               static_cast<unsigned long long>(total.decisionPercentile(0.99)), wall);
+    }
+    return 0;
+}